@@ -1647,6 +1647,28 @@ class Codec extends NativeFieldWrapperClass2 {
   void dispose() native 'Codec_dispose';
 }
 
+/// A [Codec] for a still image whose encoded bytes are still arriving, e.g.
+/// over a slow network connection.
+///
+/// Pass the bytes to [addData] as they arrive, and call [close] after the last
+/// of them. Each call to [getNextFrame] completes with the image decoded from
+/// all the bytes received so far, once there is something new to show. Parts
+/// of the image that have not arrived yet are transparent. Once the image is
+/// complete, [getNextFrame] keeps returning the final frame.
+@pragma('vm:entry-point')
+class ProgressiveCodec extends Codec {
+  /// Creates a codec that has not received any data yet.
+  @pragma('vm:entry-point')
+  ProgressiveCodec() : super._() { _constructor(); }
+  void _constructor() native 'ProgressiveCodec_constructor';
+
+  /// Appends the next chunk of the encoded image.
+  void addData(Uint8List data) native 'ProgressiveCodec_addData';
+
+  /// Signals that all of the encoded image has been added.
+  void close() native 'ProgressiveCodec_close';
+}
+
 /// Instantiates an image codec [Codec] object.
 ///
 /// [list] is the binary image data (e.g a PNG or GIF binary data).
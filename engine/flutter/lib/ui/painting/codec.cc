@@ -12,6 +12,7 @@
 #include "flutter/fml/trace_event.h"
 #include "flutter/lib/ui/painting/frame_info.h"
 #include "flutter/lib/ui/painting/multi_frame_codec.h"
+#include "flutter/lib/ui/painting/progressive_codec.h"
 #include "flutter/lib/ui/painting/single_frame_codec.h"
 #include "third_party/skia/include/codec/SkCodec.h"
 #include "third_party/skia/include/core/SkPixelRef.h"
@@ -247,6 +248,7 @@ void Codec::RegisterNatives(tonic::DartLibraryNatives* natives) {
       {"instantiateImageCodec", InstantiateImageCodec, 5, true},
   });
   natives->Register({FOR_EACH_BINDING(DART_REGISTER_NATIVE)});
+  ProgressiveCodec::RegisterNatives(natives);
 }
 
 }  // namespace flutter
@@ -6,6 +6,7 @@
 
 #include "flutter/fml/make_copyable.h"
 #include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/codec/SkAndroidCodec.h"
 #include "third_party/skia/include/codec/SkCodec.h"
 
 namespace flutter {
@@ -125,6 +126,110 @@ static sk_sp<SkImage> ImageFromDecompressedData(
   return ResizeRasterImage(std::move(image), target_width, target_height, flow);
 }
 
+// JPEG and WebP images can be decoded straight to a smaller size, which is far
+// cheaper than decoding the full image and then resizing it. libjpeg-turbo
+// scales by 1/2, 1/4 or 1/8 in its IDCT, so the YCbCr planes are never
+// reconstructed and converted to RGBA at full size. libwebp rescales the YUV
+// planes as it decodes and converts only the rescaled rows.
+//
+// Returns null if the image should be decoded at full size instead.
+static sk_sp<SkImage> ImageFromCompressedDataAtReducedSize(
+    sk_sp<SkData> data,
+    std::optional<uint32_t> target_width,
+    std::optional<uint32_t> target_height,
+    const fml::tracing::TraceFlow& flow) {
+  if (!target_width && !target_height) {
+    return nullptr;
+  }
+
+  auto codec = SkCodec::MakeFromData(std::move(data));
+  if (!codec) {
+    return nullptr;
+  }
+
+  const auto format = codec->getEncodedFormat();
+  if (format != SkEncodedImageFormat::kJPEG &&
+      format != SkEncodedImageFormat::kWEBP) {
+    return nullptr;
+  }
+
+  auto android_codec = SkAndroidCodec::MakeFromCodec(
+      std::move(codec), SkAndroidCodec::ExifOrientationBehavior::kRespect);
+  if (!android_codec) {
+    return nullptr;
+  }
+
+  const auto full_size = android_codec->getInfo().dimensions();
+  const auto target_size =
+      GetResizedDimensions(full_size, target_width, target_height);
+  if (target_size.isEmpty() || target_size.width() >= full_size.width() ||
+      target_size.height() >= full_size.height()) {
+    return nullptr;
+  }
+
+  int sample_size = 1;
+  SkISize decode_size = target_size;
+  if (format == SkEncodedImageFormat::kJPEG) {
+    // Only sample by the factors libjpeg-turbo scales by itself. Any other
+    // factor would drop rows and columns after decoding, which aliases.
+    // What is left is resized below, as with any other image.
+    for (int candidate : {8, 4, 2}) {
+      const auto sampled_size = android_codec->getSampledDimensions(candidate);
+      if (sampled_size.width() >= target_size.width() &&
+          sampled_size.height() >= target_size.height()) {
+        sample_size = candidate;
+        decode_size = sampled_size;
+        break;
+      }
+    }
+    if (sample_size == 1) {
+      return nullptr;
+    }
+  }
+
+  TRACE_EVENT0("flutter", __FUNCTION__);
+  flow.Step(__FUNCTION__);
+
+  auto info = android_codec->getInfo()
+                  .makeWH(decode_size.width(), decode_size.height())
+                  .makeColorType(kN32_SkColorType);
+  if (info.alphaType() == kUnpremul_SkAlphaType) {
+    info = info.makeAlphaType(kPremul_SkAlphaType);
+  }
+
+  SkBitmap bitmap;
+  if (!bitmap.tryAllocPixels(info)) {
+    FML_LOG(ERROR) << "Could not allocate bitmap for a scaled decode.";
+    return nullptr;
+  }
+
+  SkAndroidCodec::AndroidOptions options;
+  options.fSampleSize = sample_size;
+  switch (android_codec->getAndroidPixels(bitmap.info(), bitmap.getPixels(),
+                                          bitmap.rowBytes(), &options)) {
+    case SkCodec::kSuccess:
+    case SkCodec::kIncompleteInput:
+    case SkCodec::kErrorInInput:
+      // The latter two leave the undecoded rows filled, and are shown by the
+      // full size path as well.
+      break;
+    default:
+      return nullptr;
+  }
+
+  // Marking this as immutable makes the MakeFromBitmap call share the pixels
+  // instead of copying.
+  bitmap.setImmutable();
+
+  auto decoded_image = SkImage::MakeFromBitmap(bitmap);
+  if (!decoded_image) {
+    return nullptr;
+  }
+
+  return ResizeRasterImage(std::move(decoded_image), target_size.width(),
+                           target_size.height(), flow);
+}
+
 static sk_sp<SkImage> ImageFromCompressedData(
     sk_sp<SkData> data,
     std::optional<uint32_t> target_width,
@@ -133,6 +238,11 @@ static sk_sp<SkImage> ImageFromCompressedData(
   TRACE_EVENT0("flutter", __FUNCTION__);
   flow.Step(__FUNCTION__);
 
+  if (auto scaled_image = ImageFromCompressedDataAtReducedSize(
+          data, target_width, target_height, flow)) {
+    return scaled_image;
+  }
+
   auto decoded_image = SkImage::MakeFromEncoded(data);
 
   if (!decoded_image) {
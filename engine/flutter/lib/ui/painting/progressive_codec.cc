@@ -0,0 +1,368 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/progressive_codec.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+#include "flutter/fml/make_copyable.h"
+#include "flutter/fml/trace_event.h"
+#include "flutter/lib/ui/ui_dart_state.h"
+#include "third_party/skia/include/core/SkStream.h"
+
+namespace flutter {
+
+// The encoded bytes received so far.
+class ProgressiveCodec::Source {
+ public:
+  void Append(const uint8_t* data, size_t length) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bytes_.insert(bytes_.end(), data, data + length);
+  }
+
+  void Close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+  }
+
+  bool IsClosed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return closed_;
+  }
+
+  size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytes_.size();
+  }
+
+  // Drops the bytes once they are no longer needed.
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bytes_.clear();
+    bytes_.shrink_to_fit();
+  }
+
+  // A stream over the bytes received so far. Reads past them come up short,
+  // which SkCodec treats as incomplete input, and can be retried once more
+  // bytes have arrived.
+  static std::unique_ptr<SkStream> MakeStream(std::shared_ptr<Source> source) {
+    return std::make_unique<Stream>(std::move(source));
+  }
+
+ private:
+  class Stream : public SkStream {
+   public:
+    explicit Stream(std::shared_ptr<Source> source)
+        : source_(std::move(source)) {}
+
+    size_t read(void* buffer, size_t size) override {
+      const size_t bytes_read = source_->Read(position_, buffer, size);
+      position_ += bytes_read;
+      return bytes_read;
+    }
+
+    bool isAtEnd() const override {
+      std::lock_guard<std::mutex> lock(source_->mutex_);
+      return source_->closed_ && position_ == source_->bytes_.size();
+    }
+
+    bool rewind() override {
+      position_ = 0;
+      return true;
+    }
+
+    bool hasPosition() const override { return true; }
+
+    size_t getPosition() const override { return position_; }
+
+   private:
+    const std::shared_ptr<Source> source_;
+    size_t position_ = 0;
+  };
+
+  // Copies up to |length| bytes from |offset| to |buffer|, which may be null
+  // to skip them. Returns the number of bytes available.
+  size_t Read(size_t offset, void* buffer, size_t length) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (offset >= bytes_.size()) {
+      return 0;
+    }
+    length = std::min(length, bytes_.size() - offset);
+    if (buffer) {
+      memcpy(buffer, bytes_.data() + offset, length);
+    }
+    return length;
+  }
+
+  mutable std::mutex mutex_;
+  std::vector<uint8_t> bytes_;
+  bool closed_ = false;
+};
+
+struct ProgressiveCodec::DecodeState {
+  std::unique_ptr<SkCodec> codec;
+  SkBitmap bitmap;
+  bool started = false;
+  // False if |codec| cannot decode incrementally. Refinements then decode all
+  // of the bytes received so far again.
+  bool incremental = false;
+  // The number of bytes received when |codec| last decoded all of them.
+  size_t decoded_size = 0;
+};
+
+IMPLEMENT_WRAPPERTYPEINFO(ui, ProgressiveCodec);
+
+#define FOR_EACH_BINDING(V)     \
+  V(ProgressiveCodec, addData) \
+  V(ProgressiveCodec, close)
+
+FOR_EACH_BINDING(DART_NATIVE_CALLBACK)
+
+static void ProgressiveCodec_constructor(Dart_NativeArguments args) {
+  DartCallConstructor(&ProgressiveCodec::Create, args);
+}
+
+void ProgressiveCodec::RegisterNatives(tonic::DartLibraryNatives* natives) {
+  natives->Register(
+      {{"ProgressiveCodec_constructor", ProgressiveCodec_constructor, 1, true},
+       FOR_EACH_BINDING(DART_REGISTER_NATIVE)});
+}
+
+fml::RefPtr<ProgressiveCodec> ProgressiveCodec::Create() {
+  return fml::MakeRefCounted<ProgressiveCodec>();
+}
+
+ProgressiveCodec::ProgressiveCodec()
+    : source_(std::make_shared<Source>()),
+      decode_state_(std::make_unique<DecodeState>()) {}
+
+ProgressiveCodec::~ProgressiveCodec() = default;
+
+int ProgressiveCodec::frameCount() const {
+  return 1;
+}
+
+int ProgressiveCodec::repetitionCount() const {
+  return 0;
+}
+
+void ProgressiveCodec::addData(const tonic::Uint8List& data) {
+  AppendData(data.data(), data.num_elements());
+}
+
+void ProgressiveCodec::AppendData(const uint8_t* data, size_t length) {
+  if (source_->IsClosed()) {
+    FML_DLOG(ERROR) << "Data added to a ProgressiveCodec after close().";
+    return;
+  }
+  source_->Append(data, length);
+  has_new_data_ = true;
+  MaybeDecode();
+}
+
+void ProgressiveCodec::close() {
+  source_->Close();
+  has_new_data_ = true;
+  MaybeDecode();
+}
+
+Dart_Handle ProgressiveCodec::getNextFrame(Dart_Handle callback_handle) {
+  if (!Dart_IsClosure(callback_handle)) {
+    return tonic::ToDart("Callback must be a function");
+  }
+
+  if (complete_) {
+    tonic::DartInvoke(callback_handle, {tonic::ToDart(cached_frame_)});
+    return Dart_Null();
+  }
+
+  pending_callbacks_.emplace_back(UIDartState::Current(), callback_handle);
+  MaybeDecode();
+  return Dart_Null();
+}
+
+void ProgressiveCodec::MaybeDecode() {
+  if (pending_callbacks_.empty() || decode_in_progress_ || !has_new_data_) {
+    return;
+  }
+  decode_in_progress_ = true;
+  has_new_data_ = false;
+
+  auto dart_state = UIDartState::Current();
+  const auto& task_runners = dart_state->GetTaskRunners();
+
+  // The codec goes back to the UI thread with the result, so that it is
+  // collected there.
+  task_runners.GetIOTaskRunner()->PostTask(fml::MakeCopyable(
+      [codec = fml::Ref(this), io_manager = dart_state->GetIOManager(),
+       ui_task_runner = task_runners.GetUITaskRunner(),
+       queue = dart_state->GetSkiaUnrefQueue()]() mutable {
+        auto resource_context = io_manager
+                                    ? io_manager->GetResourceContext()
+                                    : fml::WeakPtr<GrContext>();
+        auto refinement =
+            codec->DecodeAvailableData(std::move(resource_context));
+        ui_task_runner->PostTask(fml::MakeCopyable(
+            [codec = std::move(codec), refinement = std::move(refinement),
+             queue = std::move(queue)]() mutable {
+              codec->OnRefinement(std::move(refinement), std::move(queue));
+            }));
+      }));
+}
+
+ProgressiveCodec::Refinement ProgressiveCodec::DecodeAvailableData(
+    fml::WeakPtr<GrContext> resource_context) {
+  TRACE_EVENT0("flutter", __FUNCTION__);
+  Refinement refinement;
+  DecodeState& state = *decode_state_;
+
+  // If the source was closed before we started, everything we read below is
+  // all there is going to be.
+  const bool all_data_received = source_->IsClosed();
+
+  if (!state.codec) {
+    SkCodec::Result result;
+    state.codec =
+        SkCodec::MakeFromStream(Source::MakeStream(source_), &result);
+    if (!state.codec) {
+      refinement.failed =
+          all_data_received || result != SkCodec::kIncompleteInput;
+      return refinement;
+    }
+
+    SkImageInfo info = state.codec->getInfo().makeColorType(kN32_SkColorType);
+    if (info.alphaType() == kUnpremul_SkAlphaType) {
+      info = info.makeAlphaType(kPremul_SkAlphaType);
+    }
+    if (!state.bitmap.tryAllocPixels(info)) {
+      FML_LOG(ERROR) << "Could not allocate a bitmap for progressive decoding.";
+      refinement.failed = true;
+      return refinement;
+    }
+    state.bitmap.eraseColor(SK_ColorTRANSPARENT);
+  }
+
+  if (!state.started) {
+    switch (state.codec->startIncrementalDecode(state.bitmap.info(),
+                                                state.bitmap.getPixels(),
+                                                state.bitmap.rowBytes())) {
+      case SkCodec::kSuccess:
+        state.incremental = true;
+        break;
+      case SkCodec::kUnimplemented:
+        state.incremental = false;
+        break;
+      case SkCodec::kIncompleteInput:
+        refinement.failed = all_data_received;
+        return refinement;
+      default:
+        refinement.failed = true;
+        return refinement;
+    }
+    state.started = true;
+  }
+
+  SkCodec::Result result;
+  if (state.incremental) {
+    int rows_decoded = 0;
+    result = state.codec->incrementalDecode(&rows_decoded);
+    if (result == SkCodec::kIncompleteInput && rows_decoded == 0 &&
+        !all_data_received) {
+      // Nothing new to show.
+      return refinement;
+    }
+  } else {
+    // Decoding again only once the bytes received have doubled keeps the total
+    // work linear in the size of the image.
+    const size_t size = source_->size();
+    if (!all_data_received && size < 2 * state.decoded_size) {
+      return refinement;
+    }
+    state.decoded_size = size;
+    // |codec| rewinds its stream, picking up the bytes received since.
+    result = state.codec->getPixels(state.bitmap.pixmap());
+  }
+
+  switch (result) {
+    case SkCodec::kSuccess:
+      refinement.complete = true;
+      break;
+    case SkCodec::kIncompleteInput:
+      refinement.complete = all_data_received;
+      break;
+    default:
+      FML_LOG(ERROR) << "Could not decode progressive image: " << result;
+      refinement.failed = true;
+      return refinement;
+  }
+
+  if (resource_context) {
+    refinement.image = SkImage::MakeCrossContextFromPixmap(
+        resource_context.get(), state.bitmap.pixmap(), true);
+  } else if (refinement.complete) {
+    // Nothing is going to write to the pixels any more, so share them.
+    state.bitmap.setImmutable();
+    refinement.image = SkImage::MakeFromBitmap(state.bitmap);
+  } else {
+    refinement.image = SkImage::MakeRasterCopy(state.bitmap.pixmap());
+  }
+
+  if (refinement.complete) {
+    decode_state_ = std::make_unique<DecodeState>();
+  }
+  return refinement;
+}
+
+void ProgressiveCodec::OnRefinement(
+    Refinement refinement,
+    fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue) {
+  decode_in_progress_ = false;
+
+  if (!refinement.image && !refinement.failed) {
+    // Nothing could be decoded from the bytes received so far. Wait for more.
+    MaybeDecode();
+    return;
+  }
+
+  if (refinement.image) {
+    auto canvas_image = CanvasImage::Create();
+    canvas_image->set_image(
+        {std::move(refinement.image), std::move(unref_queue)});
+    cached_frame_ = fml::MakeRefCounted<FrameInfo>(std::move(canvas_image),
+                                                   0 /* duration */);
+  }
+
+  // After a failure, the last good refinement (if any) is the final frame.
+  complete_ = refinement.complete || refinement.failed;
+  if (complete_) {
+    source_->Clear();
+  }
+
+  std::vector<DartPersistentValue> callbacks;
+  callbacks.swap(pending_callbacks_);
+
+  auto state = callbacks.front().dart_state().lock();
+  if (!state) {
+    // This is probably because the isolate has been terminated before the
+    // image could be decoded.
+    return;
+  }
+  tonic::DartState::Scope scope(state.get());
+
+  Dart_Handle frame = tonic::ToDart(cached_frame_);
+  for (const DartPersistentValue& callback : callbacks) {
+    tonic::DartInvoke(callback.value(), {frame});
+  }
+}
+
+size_t ProgressiveCodec::GetAllocationSize() {
+  const auto frame_byte_size = (cached_frame_ && cached_frame_->image())
+                                   ? cached_frame_->image()->GetAllocationSize()
+                                   : 0;
+  return source_->size() + frame_byte_size + sizeof(this);
+}
+
+}  // namespace flutter
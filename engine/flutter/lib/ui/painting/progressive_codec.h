@@ -0,0 +1,105 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_PROGRESSIVE_CODEC_H_
+#define FLUTTER_LIB_UI_PAINTING_PROGRESSIVE_CODEC_H_
+
+#include <memory>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/lib/ui/painting/codec.h"
+#include "flutter/lib/ui/painting/frame_info.h"
+
+namespace flutter {
+namespace testing {
+class ProgressiveCodecTest;
+}  // namespace testing
+
+// A codec for a still image whose encoded bytes are still arriving, e.g. over
+// a slow network connection.
+//
+// Bytes are handed over with addData() as they arrive, and close() marks the
+// end of them. getNextFrame() completes with the image decoded from all the
+// bytes received so far, waiting for more bytes if nothing new can be shown
+// yet. Rows that have not arrived are transparent. Once the image is complete,
+// getNextFrame() keeps returning the final frame.
+//
+// Formats SkCodec can decode incrementally (PNG, GIF, WebP, JPEG) pick up where
+// the previous refinement left off; a progressive JPEG shows each scan as it
+// arrives. The others are decoded again from the bytes received so far, but
+// only once those have doubled since the last decode, which keeps the total
+// work linear in the size of the image.
+class ProgressiveCodec : public Codec {
+  DEFINE_WRAPPERTYPEINFO();
+
+ public:
+  static fml::RefPtr<ProgressiveCodec> Create();
+
+  ~ProgressiveCodec() override;
+
+  // |Codec|
+  int frameCount() const override;
+
+  // |Codec|
+  int repetitionCount() const override;
+
+  // |Codec|
+  Dart_Handle getNextFrame(Dart_Handle args) override;
+
+  void addData(const tonic::Uint8List& data);
+
+  void close();
+
+  // |DartWrappable|
+  size_t GetAllocationSize() override;
+
+  static void RegisterNatives(tonic::DartLibraryNatives* natives);
+
+ private:
+  class Source;
+  struct DecodeState;
+
+  // The result of decoding the bytes received so far.
+  struct Refinement {
+    sk_sp<SkImage> image;
+    bool complete = false;
+    bool failed = false;
+  };
+
+  // The encoded bytes. Appended to on the UI thread, read on the IO thread.
+  const std::shared_ptr<Source> source_;
+
+  // Only accessed on the IO thread.
+  std::unique_ptr<DecodeState> decode_state_;
+
+  // The rest is only accessed on the UI thread.
+  std::vector<DartPersistentValue> pending_callbacks_;
+  fml::RefPtr<FrameInfo> cached_frame_;
+  bool decode_in_progress_ = false;
+  bool has_new_data_ = false;
+  bool complete_ = false;
+
+  ProgressiveCodec();
+
+  void AppendData(const uint8_t* data, size_t length);
+
+  // Starts decoding on the IO thread if a callback is waiting and there is
+  // something new to decode.
+  void MaybeDecode();
+
+  Refinement DecodeAvailableData(fml::WeakPtr<GrContext> resource_context);
+
+  void OnRefinement(Refinement refinement,
+                    fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue);
+
+  friend class testing::ProgressiveCodecTest;
+  FML_FRIEND_MAKE_REF_COUNTED(ProgressiveCodec);
+  FML_FRIEND_REF_COUNTED_THREAD_SAFE(ProgressiveCodec);
+  FML_DISALLOW_COPY_AND_ASSIGN(ProgressiveCodec);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_PROGRESSIVE_CODEC_H_
@@ -0,0 +1,183 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/progressive_codec.h"
+
+#include <cstring>
+#include <vector>
+
+#include "flutter/testing/testing.h"
+#include "third_party/skia/include/codec/SkCodec.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkStream.h"
+#include "third_party/skia/include/encode/SkJpegEncoder.h"
+#include "third_party/skia/include/encode/SkPngEncoder.h"
+
+namespace flutter {
+namespace testing {
+
+// Drives the codec directly: without a pending getNextFrame() callback, adding
+// data and closing do not post any decodes.
+class ProgressiveCodecTest : public ::testing::Test {
+ protected:
+  static void AddData(ProgressiveCodec* codec,
+                      const sk_sp<SkData>& data,
+                      size_t offset,
+                      size_t length) {
+    codec->AppendData(data->bytes() + offset, length);
+  }
+
+  static sk_sp<SkImage> Decode(ProgressiveCodec* codec, bool* complete) {
+    auto refinement = codec->DecodeAvailableData({});
+    EXPECT_FALSE(refinement.failed);
+    *complete = refinement.complete;
+    return refinement.image;
+  }
+};
+
+// Noise, so that most of the encoded bytes are the image data rather than the
+// header.
+static SkBitmap MakeNoise(int width, int height) {
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(width, height, true);
+  uint32_t seed = 1;
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      seed = seed * 1103515245 + 12345;
+      *bitmap.getAddr32(x, y) = seed | 0xFF000000;
+    }
+  }
+  return bitmap;
+}
+
+static sk_sp<SkData> EncodeNoiseAsJpeg(int width, int height) {
+  SkDynamicMemoryWStream stream;
+  SkJpegEncoder::Options options;
+  options.fQuality = 90;
+  if (!SkJpegEncoder::Encode(&stream, MakeNoise(width, height).pixmap(),
+                             options)) {
+    return nullptr;
+  }
+  return stream.detachAsData();
+}
+
+static sk_sp<SkData> EncodeNoiseAsPng(int width, int height) {
+  SkDynamicMemoryWStream stream;
+  if (!SkPngEncoder::Encode(&stream, MakeNoise(width, height).pixmap(), {})) {
+    return nullptr;
+  }
+  return stream.detachAsData();
+}
+
+// The offsets of the chunks of a PNG, which follow its 8 byte signature. Each
+// starts with a 4 byte length and a 4 byte type, and ends with a 4 byte CRC.
+static std::vector<size_t> GetPngChunkOffsets(const sk_sp<SkData>& data) {
+  std::vector<size_t> offsets;
+  const uint8_t* bytes = data->bytes();
+  size_t offset = 8;
+  while (offset + 8 <= data->size()) {
+    offsets.push_back(offset);
+    const size_t length = (bytes[offset] << 24) | (bytes[offset + 1] << 16) |
+                          (bytes[offset + 2] << 8) | bytes[offset + 3];
+    offset += length + 12;
+  }
+  return offsets;
+}
+
+static bool DecodeReference(const sk_sp<SkData>& data, SkBitmap* bitmap) {
+  auto codec = SkCodec::MakeFromData(data);
+  return codec &&
+         bitmap->tryAllocPixels(
+             codec->getInfo().makeColorType(kN32_SkColorType)) &&
+         codec->getPixels(bitmap->pixmap()) == SkCodec::kSuccess;
+}
+
+static bool RowsMatch(const SkPixmap& a, const SkPixmap& b, int y) {
+  return memcmp(a.addr(0, y), b.addr(0, y), a.info().minRowBytes()) == 0;
+}
+
+TEST_F(ProgressiveCodecTest, DecodesPartialThenCompleteJpeg) {
+  auto data = EncodeNoiseAsJpeg(128, 128);
+  ASSERT_TRUE(data);
+
+  SkBitmap expected;
+  ASSERT_TRUE(DecodeReference(data, &expected));
+
+  auto codec = ProgressiveCodec::Create();
+  const size_t half = data->size() / 2;
+  AddData(codec.get(), data, 0, half);
+
+  bool complete = true;
+  auto partial = Decode(codec.get(), &complete);
+  ASSERT_TRUE(partial);
+  ASSERT_FALSE(complete);
+  SkPixmap partial_pixels;
+  ASSERT_TRUE(partial->peekPixels(&partial_pixels));
+  ASSERT_EQ(partial_pixels.info(), expected.info());
+  // The rows received so far are final, the rest are still transparent.
+  ASSERT_TRUE(RowsMatch(partial_pixels, expected.pixmap(), 0));
+  const int last_row = partial_pixels.height() - 1;
+  for (int x = 0; x < partial_pixels.width(); x++) {
+    ASSERT_EQ(partial_pixels.getColor(x, last_row), SK_ColorTRANSPARENT);
+  }
+
+  AddData(codec.get(), data, half, data->size() - half);
+  codec->close();
+
+  auto final_image = Decode(codec.get(), &complete);
+  ASSERT_TRUE(final_image);
+  ASSERT_TRUE(complete);
+  SkPixmap final_pixels;
+  ASSERT_TRUE(final_image->peekPixels(&final_pixels));
+  ASSERT_EQ(final_pixels.info(), expected.info());
+  for (int y = 0; y < final_pixels.height(); y++) {
+    ASSERT_TRUE(RowsMatch(final_pixels, expected.pixmap(), y)) << "Row " << y;
+  }
+}
+
+// A short read in the middle of a chunk header must not lose the part of it
+// that was read, or the following refinements would decode garbage.
+TEST_F(ProgressiveCodecTest, DecodesPngWhoseChunkHeadersArriveInPieces) {
+  auto data = EncodeNoiseAsPng(128, 128);
+  ASSERT_TRUE(data);
+
+  SkBitmap expected;
+  ASSERT_TRUE(DecodeReference(data, &expected));
+
+  // The image data is split into several IDAT chunks.
+  const auto chunk_offsets = GetPngChunkOffsets(data);
+  ASSERT_GT(chunk_offsets.size(), 4u);
+
+  auto codec = ProgressiveCodec::Create();
+  size_t received = 0;
+  size_t refinements = 0;
+  bool complete = true;
+  for (size_t chunk_offset : chunk_offsets) {
+    // Stop halfway through the length of each chunk.
+    const size_t split = chunk_offset + 2;
+    AddData(codec.get(), data, received, split - received);
+    received = split;
+    if (Decode(codec.get(), &complete)) {
+      refinements++;
+    }
+    ASSERT_FALSE(complete);
+  }
+  ASSERT_GT(refinements, 1u);
+
+  AddData(codec.get(), data, received, data->size() - received);
+  codec->close();
+
+  auto final_image = Decode(codec.get(), &complete);
+  ASSERT_TRUE(final_image);
+  ASSERT_TRUE(complete);
+  SkPixmap final_pixels;
+  ASSERT_TRUE(final_image->peekPixels(&final_pixels));
+  ASSERT_EQ(final_pixels.info(), expected.info());
+  for (int y = 0; y < final_pixels.height(); y++) {
+    ASSERT_TRUE(RowsMatch(final_pixels, expected.pixmap(), y)) << "Row " << y;
+  }
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -15,13 +15,22 @@
 #include "third_party/skia/include/core/SkStream.h"
 #include "third_party/skia/include/core/SkTypeface.h"
 #include "txt/asset_font_manager.h"
+#include "txt/platform.h"
 #include "txt/test_font_manager.h"
 
 namespace flutter {
 
 FontCollection::FontCollection()
     : collection_(std::make_shared<txt::FontCollection>()) {
-  collection_->SetupDefaultFontManager();
+  // The collection holds on to the shared system font manager for as long as
+  // it uses it, including when it reloads the system fonts.
+  auto system_font_manager = GetSharedSystemFontManager();
+  collection_->SetDefaultFontManager(sk_ref_sp(system_font_manager.get()));
+  collection_->SetDefaultFontManagerProvider(
+      [system_font_manager]() mutable {
+        system_font_manager = GetSharedSystemFontManager(system_font_manager);
+        return sk_ref_sp(system_font_manager.get());
+      });
 
   dynamic_font_manager_ = sk_make_sp<txt::DynamicFontManager>();
   collection_->SetDynamicFontManager(dynamic_font_manager_);
@@ -32,6 +41,24 @@ FontCollection::~FontCollection() {
   SkGraphics::PurgeFontCache();
 }
 
+std::shared_ptr<SkFontMgr> FontCollection::GetSharedSystemFontManager(
+    const std::shared_ptr<SkFontMgr>& replaced) {
+  static std::mutex mutex;
+  static std::weak_ptr<SkFontMgr> shared_font_manager;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto font_manager = shared_font_manager.lock();
+  if (!font_manager || font_manager == replaced) {
+    // Font managers are reference counted by Skia. The shared_ptr only tracks
+    // whether some collection still uses this one and drops its reference
+    // with the last of them.
+    font_manager = std::shared_ptr<SkFontMgr>(
+        txt::GetDefaultFontManager().release(),
+        [](SkFontMgr* manager) { SkSafeUnref(manager); });
+    shared_font_manager = font_manager;
+  }
+  return font_manager;
+}
+
 void FontCollection::RegisterNatives(tonic::DartLibraryNatives* natives) {
 }
 
@@ -11,6 +11,7 @@
 #include "flutter/assets/asset_manager.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/ref_ptr.h"
+#include "third_party/skia/include/core/SkFontMgr.h"
 #include "txt/font_collection.h"
 
 namespace tonic {
@@ -27,6 +28,18 @@ class FontCollection {
 
   static void RegisterNatives(tonic::DartLibraryNatives* natives);
 
+  // Returns the system font manager shared by the collections of all engines
+  // in the process. It only reads the platform fonts and is never mutated, so
+  // later windows do not enumerate them again. It is released once no
+  // collection holds it anymore.
+  //
+  // If |replaced| is the shared manager, a new one takes its place, e.g. after
+  // the system fonts have been reconfigured. Collections that reload their
+  // system fonts pass the manager they had, so that the first of them creates
+  // the new manager and the others pick it up.
+  static std::shared_ptr<SkFontMgr> GetSharedSystemFontManager(
+      const std::shared_ptr<SkFontMgr>& replaced = nullptr);
+
   std::shared_ptr<txt::FontCollection> GetFontCollection() const;
 
   void RegisterFonts(std::shared_ptr<AssetManager> asset_manager);
@@ -0,0 +1,73 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/text/font_collection.h"
+#include "flutter/runtime/test_font_data.h"
+#include "flutter/testing/testing.h"
+#include "third_party/skia/include/core/SkData.h"
+
+namespace flutter {
+namespace testing {
+
+TEST(FontCollectionTest, EnginesShareOnlyTheSystemFontManager) {
+  FontCollection first;
+  FontCollection second;
+  ASSERT_NE(first.GetFontCollection(), second.GetFontCollection());
+  auto font_manager = FontCollection::GetSharedSystemFontManager();
+  ASSERT_EQ(font_manager, FontCollection::GetSharedSystemFontManager());
+}
+
+TEST(FontCollectionTest, SharedSystemFontManagerIsReleasedWithLastHolder) {
+  std::weak_ptr<SkFontMgr> released;
+  {
+    FontCollection collection;
+    released = FontCollection::GetSharedSystemFontManager();
+    ASSERT_FALSE(released.expired());
+  }
+  ASSERT_TRUE(released.expired());
+}
+
+TEST(FontCollectionTest, ReloadingSystemFontsReplacesTheSharedManager) {
+  FontCollection first;
+  FontCollection second;
+  std::weak_ptr<SkFontMgr> replaced =
+      FontCollection::GetSharedSystemFontManager();
+
+  first.GetFontCollection()->SetupDefaultFontManager();
+  auto reloaded = FontCollection::GetSharedSystemFontManager();
+  ASSERT_NE(reloaded, replaced.lock());
+  // The second collection has not reloaded its system fonts yet.
+  ASSERT_FALSE(replaced.expired());
+
+  second.GetFontCollection()->SetupDefaultFontManager();
+  ASSERT_TRUE(replaced.expired());
+  ASSERT_EQ(reloaded, FontCollection::GetSharedSystemFontManager());
+}
+
+TEST(FontCollectionTest, FontsLoadedAtRuntimeStayInTheirCollection) {
+  FontCollection loading;
+  FontCollection other;
+  // Without the system fonts, a family is only found where it was loaded.
+  loading.GetFontCollection()->SetDefaultFontManager(nullptr);
+  other.GetFontCollection()->SetDefaultFontManager(nullptr);
+
+  auto font_stream = GetTestFontData();
+  ASSERT_TRUE(font_stream);
+  sk_sp<SkData> font_data =
+      SkData::MakeFromStream(font_stream.get(), font_stream->getLength());
+  ASSERT_TRUE(font_data);
+  loading.LoadFontFromList(font_data->bytes(), font_data->size(),
+                           "RuntimeFont");
+
+  std::string locale;
+  ASSERT_NE(loading.GetFontCollection()->GetMinikinFontCollectionForFamilies(
+                {"RuntimeFont"}, locale),
+            nullptr);
+  ASSERT_EQ(other.GetFontCollection()->GetMinikinFontCollectionForFamilies(
+                {"RuntimeFont"}, locale),
+            nullptr);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -44,6 +44,7 @@ Engine::Engine(Delegate& delegate,
       animator_(std::move(animator)),
       activity_running_(true),
       have_surface_(false),
+      idle_task_queue_(std::make_shared<IdleTaskQueue>()),
       weak_factory_(this) {
   // Runtime controller is initialized here because it takes a reference to this
   // object as its delegate. The delegate may be called in the constructor and
@@ -126,10 +127,28 @@ void Engine::ReportTimings(std::vector<int64_t> timings) {
   runtime_controller_->ReportTimings(std::move(timings));
 }
 
-void Engine::NotifyIdle(int64_t deadline) {
+void Engine::NotifyIdle(fml::TimePoint deadline) {
+  // The embedder's idle callback takes the time left until the deadline.
+  const int64_t deadline_now_delta =
+      (deadline - fml::TimePoint::Now()).ToMicroseconds();
   TRACE_EVENT1("flutter", "Engine::NotifyIdle", "deadline_now_delta",
-               std::to_string(deadline).c_str());
-  runtime_controller_->NotifyIdle(deadline);
+               std::to_string(deadline_now_delta).c_str());
+  runtime_controller_->NotifyIdle(deadline_now_delta);
+  // Whatever is left of the period once the embedder is done goes to the
+  // engine's own deferrable work.
+  idle_task_queue_->RunUntil(deadline);
+}
+
+std::shared_ptr<IdleTaskQueue> Engine::GetIdleTaskQueue() const {
+  return idle_task_queue_;
+}
+
+void Engine::OnFrameRasterized(const FrameTiming& timing) {
+  animator_->OnFrameRasterized(timing);
+}
+
+Animator::FramePacingStats Engine::GetFramePacingStats() const {
+  return animator_->GetFramePacingStats();
 }
 
 void Engine::OnOutputSurfaceCreated() {
@@ -222,10 +241,11 @@ void Engine::HandleSettingsPlatformMessage(PlatformMessage* message) {
 }
 
 void Engine::DispatchPointerDataPacket(const PointerDataPacket& packet,
-                                       uint64_t trace_flow_id) {
+                                       uint64_t trace_flow_id,
+                                       fml::TimePoint input_time) {
   TRACE_EVENT0("flutter", "Engine::DispatchPointerDataPacket");
   TRACE_FLOW_STEP("flutter", "PointerEvent", trace_flow_id);
-  animator_->EnqueueTraceFlowId(trace_flow_id);
+  animator_->EnqueueTraceFlowId(trace_flow_id, input_time);
   runtime_controller_->DispatchPointerDataPacket(packet);
 }
 
@@ -276,6 +296,11 @@ void Engine::SetNeedsReportTimings(bool needs_reporting) {
 
 FontCollection& Engine::GetFontCollection() {
   std::call_once(font_flag_, [this]() {
+    // Every engine gets its own collection, as fonts loaded at runtime and the
+    // font weight scale belong to one window. Only the system font manager is
+    // shared by the engines of a process, which saves enumerating the platform
+    // fonts again. Fallback caches are per collection, so every engine warms
+    // its own below.
     font_collection_ = std::make_unique<FontCollection>();
     if (font_collection_->GetFontCollection()) {
       std::string emptyLocale;
@@ -391,6 +391,7 @@ bool Shell::Setup(std::unique_ptr<PlatformView> platform_view,
   weak_engine_ = engine_->GetWeakPtr();
   weak_rasterizer_ = rasterizer_->GetWeakPtr();
   weak_platform_view_ = platform_view_->GetWeakPtr();
+  idle_task_queue_ = engine_->GetIdleTaskQueue();
 
   is_setup_ = true;
 
@@ -640,9 +641,9 @@ void Shell::OnPlatformViewDispatchPointerDataPacket(
   FML_DCHECK(task_runners_.GetPlatformTaskRunner()->RunsTasksOnCurrentThread());
   task_runners_.GetUITaskRunner()->PostTask(fml::MakeCopyable(
       [engine = engine_->GetWeakPtr(), packet = std::move(packet),
-       flow_id = next_pointer_flow_id_] {
+       flow_id = next_pointer_flow_id_, input_time = fml::TimePoint::Now()] {
         if (engine) {
-          engine->DispatchPointerDataPacket(*packet, flow_id);
+          engine->DispatchPointerDataPacket(*packet, flow_id, input_time);
         }
       }));
   next_pointer_flow_id_++;
@@ -734,7 +735,7 @@ void Shell::OnAnimatorBeginFrame(fml::TimePoint frame_time) {
 }
 
 // |Animator::Delegate|
-void Shell::OnAnimatorNotifyIdle(int64_t deadline) {
+void Shell::OnAnimatorNotifyIdle(fml::TimePoint deadline) {
   FML_DCHECK(is_setup_);
   FML_DCHECK(task_runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
 
@@ -844,6 +845,13 @@ void Shell::OnFrameRasterized(const FrameTiming& timing) {
   FML_DCHECK(is_setup_);
   FML_DCHECK(task_runners_.GetGPUTaskRunner()->RunsTasksOnCurrentThread());
 
+  task_runners_.GetUITaskRunner()->PostTask(
+      [engine = weak_engine_, timing]() {
+        if (engine) {
+          engine->OnFrameRasterized(timing);
+        }
+      });
+
   // The C++ callback defined in settings.h and set by Flutter runner. This is
   // independent of the timings report to the Dart side.
   if (settings_.frame_rasterized_callback) {
@@ -899,6 +907,11 @@ void Shell::OnFrameRasterized(const FrameTiming& timing) {
   }
 }
 
+// |Rasterizer::Delegate|
+std::shared_ptr<IdleTaskQueue> Shell::GetIdleTaskQueue() {
+  return idle_task_queue_;
+}
+
 Rasterizer::Screenshot Shell::Screenshot(
     Rasterizer::ScreenshotType screenshot_type,
     bool base64_encode) {
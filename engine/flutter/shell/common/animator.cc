@@ -4,6 +4,8 @@
 
 #include "flutter/shell/common/animator.h"
 
+#include <algorithm>
+
 #include "flutter/fml/trace_event.h"
 
 namespace flutter {
@@ -16,6 +18,47 @@ namespace {
 constexpr fml::TimeDelta kNotifyIdleTaskWaitTime =
     fml::TimeDelta::FromMilliseconds(51);
 
+// The length of the idle period reported once no more frames are scheduled.
+constexpr fml::TimeDelta kLongIdlePeriod =
+    fml::TimeDelta::FromMilliseconds(100);
+
+// The frame interval assumed until the first vsync says otherwise.
+constexpr fml::TimeDelta kDefaultFrameInterval =
+    fml::TimeDelta::FromMicroseconds(16667);
+
+// The next frame is expected to take as long to build and to rasterize as the
+// slowest of this many recent frames.
+constexpr size_t kFrameTimingWindow = 10;
+
+// The range of the layer tree pipeline depth when the platform and GPU task
+// runners are distinct.
+constexpr uint32_t kMinPipelineDepth = 1;
+constexpr uint32_t kDefaultPipelineDepth = 2;
+constexpr uint32_t kMaxPipelineDepth = 3;
+
+// The share of the frame interval a frame phase may take before it is
+// considered to be the bottleneck.
+constexpr int64_t kBusyFramePercent = 80;
+
+// How many frames in a row must call for a shallower pipeline before its
+// depth is lowered. Depth is raised as soon as a frame calls for it.
+constexpr uint32_t kLowerPipelineDepthFrames = 30;
+
+void PushFrameTime(std::deque<fml::TimeDelta>* times, fml::TimeDelta time) {
+  times->push_back(time);
+  if (times->size() > kFrameTimingWindow) {
+    times->pop_front();
+  }
+}
+
+fml::TimeDelta PredictFrameTime(const std::deque<fml::TimeDelta>& times) {
+  fml::TimeDelta prediction;
+  for (auto time : times) {
+    prediction = std::max(prediction, time);
+  }
+  return prediction;
+}
+
 }  // namespace
 
 Animator::Animator(Delegate& delegate,
@@ -25,7 +68,7 @@ Animator::Animator(Delegate& delegate,
       task_runners_(std::move(task_runners)),
       waiter_(std::move(waiter)),
       last_begin_frame_time_(),
-      dart_frame_deadline_(0),
+      frame_deadline_(),
       // TODO(dnfield): We should remove this logic and set the pipeline depth
       // back to 2 in this case. See https://github.com/flutter/engine/pull/9132
       // for discussion.
@@ -33,7 +76,7 @@ Animator::Animator(Delegate& delegate,
           task_runners.GetPlatformTaskRunner() ==
                   task_runners.GetGPUTaskRunner()
               ? 1
-              : 2)),
+              : kDefaultPipelineDepth)),
       pending_frame_semaphore_(1),
       frame_number_(1),
       paused_(false),
@@ -41,6 +84,12 @@ Animator::Animator(Delegate& delegate,
       frame_scheduled_(false),
       notify_idle_task_id_(0),
       dimension_change_pending_(false),
+      adaptive_pipeline_depth_(task_runners.GetPlatformTaskRunner() !=
+                                   task_runners.GetGPUTaskRunner() &&
+                               task_runners.GetUITaskRunner() !=
+                                   task_runners.GetGPUTaskRunner()),
+      frame_interval_(kDefaultFrameInterval),
+      lower_depth_streak_(0),
       weak_factory_(this) {}
 
 Animator::~Animator() = default;
@@ -68,29 +117,132 @@ void Animator::SetDimensionChangePending() {
   dimension_change_pending_ = true;
 }
 
-void Animator::EnqueueTraceFlowId(uint64_t trace_flow_id) {
+void Animator::EnqueueTraceFlowId(uint64_t trace_flow_id,
+                                  fml::TimePoint input_time) {
   fml::TaskRunner::RunNowOrPostTask(
       task_runners_.GetUITaskRunner(),
-      [self = weak_factory_.GetWeakPtr(), trace_flow_id] {
+      [self = weak_factory_.GetWeakPtr(), trace_flow_id, input_time] {
         if (!self) {
           return;
         }
         self->trace_flow_ids_.push_back(trace_flow_id);
+        if (self->pending_input_time_ == fml::TimePoint()) {
+          self->pending_input_time_ = input_time;
+        }
       });
 }
 
+void Animator::OnFrameRasterized(const FrameTiming& timing) {
+  // Layer trees record the start of the frame they were built in as their
+  // build start, which identifies the frame. Frames older than this one never
+  // made it to the rasterizer.
+  const fml::TimePoint frame_start_time = timing.Get(FrameTiming::kBuildStart);
+  while (!pending_frames_.empty() &&
+         pending_frames_.front().frame_start_time < frame_start_time) {
+    pending_frames_.pop_front();
+  }
+  if (pending_frames_.empty() ||
+      pending_frames_.front().frame_start_time != frame_start_time) {
+    return;
+  }
+  const PendingFrame frame = pending_frames_.front();
+  pending_frames_.pop_front();
+
+  const fml::TimePoint raster_finish_time =
+      timing.Get(FrameTiming::kRasterFinish);
+  PushFrameTime(&recent_build_times_,
+                timing.Get(FrameTiming::kBuildFinish) - frame.build_begin_time);
+  PushFrameTime(&recent_raster_times_,
+                raster_finish_time - timing.Get(FrameTiming::kRasterStart));
+
+  pacing_stats_.frames_rasterized++;
+  if (raster_finish_time > frame.frame_target_time) {
+    pacing_stats_.frames_late++;
+  }
+  if (frame.input_time != fml::TimePoint()) {
+    pacing_stats_.last_input_latency = raster_finish_time - frame.input_time;
+    pacing_stats_.max_input_latency = std::max(
+        pacing_stats_.max_input_latency, pacing_stats_.last_input_latency);
+  }
+  pacing_stats_.predicted_build_time = PredictFrameTime(recent_build_times_);
+  pacing_stats_.predicted_raster_time = PredictFrameTime(recent_raster_times_);
+
+  UpdatePipelineDepth(false);
+}
+
+Animator::FramePacingStats Animator::GetFramePacingStats() const {
+  FramePacingStats stats = pacing_stats_;
+  stats.pipeline_depth = layer_tree_pipeline_->GetDepth();
+  return stats;
+}
+
+void Animator::UpdatePipelineDepth(bool frame_skipped) {
+  if (!adaptive_pipeline_depth_) {
+    return;
+  }
+
+  const uint32_t depth = layer_tree_pipeline_->GetDepth();
+  uint32_t wanted_depth = depth;
+  if (frame_skipped) {
+    // The rasterizer fell behind the pipeline as it is.
+    wanted_depth = depth + 1;
+  } else if (recent_raster_times_.size() >= kFrameTimingWindow) {
+    const fml::TimeDelta busy = frame_interval_ * kBusyFramePercent / 100;
+    const fml::TimeDelta build = pacing_stats_.predicted_build_time;
+    const fml::TimeDelta raster = pacing_stats_.predicted_raster_time;
+    if (build + raster <= busy) {
+      // Building and rasterizing fit in one frame one after the other, so
+      // there is no need to add a frame of latency by overlapping them.
+      wanted_depth = kMinPipelineDepth;
+    } else if (std::max(build, raster) <= busy) {
+      wanted_depth = kDefaultPipelineDepth;
+    } else {
+      wanted_depth = kMaxPipelineDepth;
+    }
+  }
+  wanted_depth =
+      std::clamp(wanted_depth, kMinPipelineDepth, kMaxPipelineDepth);
+
+  if (wanted_depth < depth) {
+    if (++lower_depth_streak_ < kLowerPipelineDepthFrames) {
+      return;
+    }
+    wanted_depth = depth - 1;
+  }
+  lower_depth_streak_ = 0;
+
+  if (wanted_depth != depth) {
+    TRACE_EVENT1("flutter", "Animator::UpdatePipelineDepth", "depth",
+                 std::to_string(wanted_depth).c_str());
+    layer_tree_pipeline_->SetDepth(wanted_depth);
+  }
+}
+
+fml::TimeDelta Animator::GetBuildDelay(fml::TimePoint frame_start_time,
+                                       fml::TimePoint frame_target_time) const {
+  // Only a frame that is built and rasterized before the next one starts can
+  // be held back. Deeper pipelines are raster bound and build right away.
+  if (!adaptive_pipeline_depth_ || layer_tree_pipeline_->GetDepth() != 1 ||
+      recent_build_times_.size() < kFrameTimingWindow) {
+    return fml::TimeDelta::Zero();
+  }
+
+  // Leave a quarter of the frame interval as a margin for a frame that is
+  // slower than predicted.
+  const fml::TimeDelta frame_time = pacing_stats_.predicted_build_time +
+                                    pacing_stats_.predicted_raster_time +
+                                    frame_interval_ / 4;
+  const fml::TimeDelta delay =
+      frame_target_time - fml::TimePoint::Now() - frame_time;
+  return std::max(delay, fml::TimeDelta::Zero());
+}
+
 // This Parity is used by the timeline component to correctly align
 // GPU Workloads events with their respective Framework Workload.
 const char* Animator::FrameParity() {
   return (frame_number_ % 2) ? "even" : "odd";
 }
 
-static int64_t FxlToDartOrEarlier(fml::TimePoint time) {
-  int64_t dart_now = 0;
-  fml::TimePoint fxl_now = fml::TimePoint::Now();
-  return (time - fxl_now).ToMicroseconds() + dart_now;
-}
-
 void Animator::BeginFrame(fml::TimePoint frame_start_time,
                           fml::TimePoint frame_target_time) {
   TRACE_EVENT_ASYNC_END0("flutter", "Frame Request Pending", frame_number_++);
@@ -107,6 +259,10 @@ void Animator::BeginFrame(fml::TimePoint frame_start_time,
   regenerate_layer_tree_ = false;
   pending_frame_semaphore_.Signal();
 
+  if (frame_target_time > frame_start_time) {
+    frame_interval_ = frame_target_time - frame_start_time;
+  }
+
   if (!producer_continuation_) {
     // We may already have a valid pipeline continuation in case a previous
     // begin frame did not result in an Animation::Render. Simply reuse that
@@ -117,17 +273,27 @@ void Animator::BeginFrame(fml::TimePoint frame_start_time,
       // If we still don't have valid continuation, the pipeline is currently
       // full because the consumer is being too slow. Try again at the next
       // frame interval.
+      pacing_stats_.frames_skipped++;
+      UpdatePipelineDepth(true);
       RequestFrame();
       return;
     }
   }
 
+  pending_frames_.push_back({frame_start_time, frame_target_time,
+                             fml::TimePoint::Now(), pending_input_time_});
+  pending_input_time_ = fml::TimePoint();
+  // Frames that never get rendered are not reported back.
+  if (pending_frames_.size() > kFrameTimingWindow) {
+    pending_frames_.pop_front();
+  }
+
   // We have acquired a valid continuation from the pipeline and are ready
   // to service potential frame.
   FML_DCHECK(producer_continuation_);
 
   last_begin_frame_time_ = frame_start_time;
-  dart_frame_deadline_ = FxlToDartOrEarlier(frame_target_time);
+  frame_deadline_ = frame_target_time;
   {
     TRACE_EVENT2("flutter", "Framework Workload", "mode", "basic", "frame",
                  FrameParity());
@@ -155,7 +321,8 @@ void Animator::BeginFrame(fml::TimePoint frame_start_time,
           if (notify_idle_task_id == self->notify_idle_task_id_ &&
               !self->frame_scheduled_) {
             TRACE_EVENT0("flutter", "BeginFrame idle callback");
-            self->delegate_.OnAnimatorNotifyIdle(100000);
+            self->delegate_.OnAnimatorNotifyIdle(
+                fml::TimePoint::Now() + kLongIdlePeriod);
           }
         },
         kNotifyIdleTaskWaitTime);
@@ -228,13 +395,26 @@ void Animator::AwaitVSync() {
         if (self) {
           if (self->CanReuseLastLayerTree()) {
             self->DrawLastLayerTree();
-          } else {
+            return;
+          }
+          const fml::TimeDelta delay =
+              self->GetBuildDelay(frame_start_time, frame_target_time);
+          if (delay <= fml::TimeDelta::Zero()) {
             self->BeginFrame(frame_start_time, frame_target_time);
+            return;
           }
+          TRACE_EVENT0("flutter", "Animator::PaceFrame");
+          self->task_runners_.GetUITaskRunner()->PostDelayedTask(
+              [self, frame_start_time, frame_target_time]() {
+                if (self) {
+                  self->BeginFrame(frame_start_time, frame_target_time);
+                }
+              },
+              delay);
         }
       });
 
-  delegate_.OnAnimatorNotifyIdle(dart_frame_deadline_);
+  delegate_.OnAnimatorNotifyIdle(frame_deadline_);
 }
 
 }  // namespace flutter
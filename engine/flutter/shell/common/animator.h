@@ -19,6 +19,7 @@
 namespace flutter {
 
 namespace testing {
+class AnimatorTest;
 class ShellTest;
 }
 
@@ -32,7 +33,7 @@ class Animator final {
    public:
     virtual void OnAnimatorBeginFrame(fml::TimePoint frame_time) = 0;
 
-    virtual void OnAnimatorNotifyIdle(int64_t deadline) = 0;
+    virtual void OnAnimatorNotifyIdle(fml::TimePoint deadline) = 0;
 
     virtual void OnAnimatorDraw(
         fml::RefPtr<Pipeline<flutter::LayerTree>> pipeline) = 0;
@@ -59,8 +60,35 @@ class Animator final {
   void SetDimensionChangePending();
 
   // Enqueue |trace_flow_id| into |trace_flow_ids_|.  The corresponding flow
-  // will be ended during the next |BeginFrame|.
-  void EnqueueTraceFlowId(uint64_t trace_flow_id);
+  // will be ended during the next |BeginFrame|. |input_time| is when the input
+  // reached the platform thread, which input latency is measured from.
+  void EnqueueTraceFlowId(uint64_t trace_flow_id, fml::TimePoint input_time);
+
+  // Feeds the timings of a rasterized frame back into frame pacing. Must be
+  // called on the UI task runner.
+  void OnFrameRasterized(const FrameTiming& timing);
+
+  struct FramePacingStats {
+    // The number of frames whose timings were reported back.
+    size_t frames_rasterized = 0;
+    // The number of vsyncs on which no frame was built because the pipeline
+    // was full.
+    size_t frames_skipped = 0;
+    // The number of frames that finished rasterizing after their vsync target
+    // time.
+    size_t frames_late = 0;
+    // The current depth of the layer tree pipeline.
+    uint32_t pipeline_depth = 0;
+    // The build and raster times expected of the next frame.
+    fml::TimeDelta predicted_build_time;
+    fml::TimeDelta predicted_raster_time;
+    // The time from the first input event of a frame until that frame finished
+    // rasterizing, for the most recent and the worst such frame.
+    fml::TimeDelta last_input_latency;
+    fml::TimeDelta max_input_latency;
+  };
+
+  FramePacingStats GetFramePacingStats() const;
 
  private:
   using LayerTreePipeline = Pipeline<flutter::LayerTree>;
@@ -68,9 +96,30 @@ class Animator final {
   void BeginFrame(fml::TimePoint frame_start_time,
                   fml::TimePoint frame_target_time);
 
+  // A frame built by the animator whose timings have not been reported back
+  // yet.
+  struct PendingFrame {
+    fml::TimePoint frame_start_time;
+    fml::TimePoint frame_target_time;
+    // When the build actually began, which is later than the frame start time
+    // if the build was paced.
+    fml::TimePoint build_begin_time;
+    // The arrival of the first input event handled by this frame, if any.
+    fml::TimePoint input_time;
+  };
+
   bool CanReuseLastLayerTree();
   void DrawLastLayerTree();
 
+  // How long to hold off building a frame so that it is built from input as
+  // fresh as possible while still meeting its target time.
+  fml::TimeDelta GetBuildDelay(fml::TimePoint frame_start_time,
+                               fml::TimePoint frame_target_time) const;
+
+  // Adapts the depth of the layer tree pipeline to the predicted frame times,
+  // or deepens it right away if a frame was just skipped because it was full.
+  void UpdatePipelineDepth(bool frame_skipped);
+
   void AwaitVSync();
 
   const char* FrameParity();
@@ -80,7 +129,7 @@ class Animator final {
   std::shared_ptr<VsyncWaiter> waiter_;
 
   fml::TimePoint last_begin_frame_time_;
-  int64_t dart_frame_deadline_;
+  fml::TimePoint frame_deadline_;
   fml::RefPtr<LayerTreePipeline> layer_tree_pipeline_;
   fml::Semaphore pending_frame_semaphore_;
   LayerTreePipeline::ProducerContinuation producer_continuation_;
@@ -92,9 +141,18 @@ class Animator final {
   bool dimension_change_pending_;
   SkISize last_layer_tree_size_;
   std::deque<uint64_t> trace_flow_ids_;
+  fml::TimePoint pending_input_time_;
+  const bool adaptive_pipeline_depth_;
+  fml::TimeDelta frame_interval_;
+  std::deque<PendingFrame> pending_frames_;
+  std::deque<fml::TimeDelta> recent_build_times_;
+  std::deque<fml::TimeDelta> recent_raster_times_;
+  uint32_t lower_depth_streak_;
+  FramePacingStats pacing_stats_;
 
   fml::WeakPtrFactory<Animator> weak_factory_;
 
+  friend class testing::AnimatorTest;
   friend class testing::ShellTest;
 
   FML_DISALLOW_COPY_AND_ASSIGN(Animator);
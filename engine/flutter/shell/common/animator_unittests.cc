@@ -0,0 +1,278 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#define FML_USED_ON_EMBEDDER
+
+#include <functional>
+#include <memory>
+
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/thread.h"
+#include "flutter/shell/common/animator.h"
+#include "flutter/shell/common/vsync_waiter_fallback.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+static void RunOnTaskRunner(fml::RefPtr<fml::TaskRunner> task_runner,
+                            const std::function<void()>& task) {
+  fml::AutoResetWaitableEvent latch;
+  fml::TaskRunner::RunNowOrPostTask(task_runner, [&]() {
+    task();
+    latch.Signal();
+  });
+  latch.Wait();
+}
+
+// The animator is never asked for a frame, so none of these are called.
+class FakeAnimatorDelegate final : public Animator::Delegate {
+ public:
+  void OnAnimatorBeginFrame(fml::TimePoint frame_time) override {}
+
+  void OnAnimatorNotifyIdle(fml::TimePoint deadline) override {}
+
+  void OnAnimatorDraw(
+      fml::RefPtr<Pipeline<flutter::LayerTree>> pipeline) override {}
+
+  void OnAnimatorDrawLastLayerTree() override {}
+};
+
+// Feeds the animator synthetic frame timings instead of running frames, so
+// that its pacing decisions do not depend on how fast the test machine is.
+class AnimatorTest : public ::testing::Test {
+ protected:
+  AnimatorTest()
+      : platform_thread_("platform"),
+        ui_thread_("ui"),
+        gpu_thread_("gpu"),
+        io_thread_("io"),
+        task_runners_("animator_test",
+                      platform_thread_.GetTaskRunner(),
+                      gpu_thread_.GetTaskRunner(),
+                      ui_thread_.GetTaskRunner(),
+                      io_thread_.GetTaskRunner()),
+        next_frame_start_time_(fml::TimePoint::Now()) {}
+
+  // Runs |test| on the UI task runner with an animator for |task_runners|.
+  void WithAnimator(const TaskRunners& task_runners,
+                    const std::function<void(Animator*)>& test) {
+    FakeAnimatorDelegate delegate;
+    RunOnTaskRunner(task_runners.GetUITaskRunner(), [&]() {
+      Animator animator(delegate, task_runners,
+                        std::make_unique<VsyncWaiterFallback>(task_runners));
+      test(&animator);
+    });
+  }
+
+  void WithAnimator(const std::function<void(Animator*)>& test) {
+    WithAnimator(task_runners_, test);
+  }
+
+  const TaskRunners& GetTaskRunners() const { return task_runners_; }
+
+  // Reports a frame as if the animator had built it at |frame_start_time| and
+  // the rasterizer had picked it up as soon as it was built.
+  static void RasterizeFrame(Animator* animator,
+                             fml::TimePoint frame_start_time,
+                             fml::TimeDelta build_time,
+                             fml::TimeDelta raster_time,
+                             fml::TimePoint input_time = fml::TimePoint()) {
+    animator->pending_frames_.push_back(
+        {frame_start_time, frame_start_time + animator->frame_interval_,
+         frame_start_time, input_time});
+    FrameTiming timing;
+    timing.Set(FrameTiming::kBuildStart, frame_start_time);
+    timing.Set(FrameTiming::kBuildFinish, frame_start_time + build_time);
+    timing.Set(FrameTiming::kRasterStart, frame_start_time + build_time);
+    timing.Set(FrameTiming::kRasterFinish,
+               frame_start_time + build_time + raster_time);
+    animator->OnFrameRasterized(timing);
+  }
+
+  // Reports |count| frames, one per frame interval.
+  void RasterizeFrames(Animator* animator,
+                       size_t count,
+                       fml::TimeDelta build_time,
+                       fml::TimeDelta raster_time) {
+    for (size_t i = 0; i < count; i++) {
+      RasterizeFrame(animator, NextFrameStartTime(animator), build_time,
+                     raster_time);
+    }
+  }
+
+  // Tells the animator that a vsync found the pipeline full.
+  static void SkipFrame(Animator* animator) {
+    animator->UpdatePipelineDepth(true);
+  }
+
+  fml::TimePoint NextFrameStartTime(Animator* animator) {
+    next_frame_start_time_ = next_frame_start_time_ + animator->frame_interval_;
+    return next_frame_start_time_;
+  }
+
+  static fml::TimePoint GetPendingInputTime(Animator* animator) {
+    return animator->pending_input_time_;
+  }
+
+  static uint32_t GetDepth(Animator* animator) {
+    return animator->GetFramePacingStats().pipeline_depth;
+  }
+
+ private:
+  fml::Thread platform_thread_;
+  fml::Thread ui_thread_;
+  fml::Thread gpu_thread_;
+  fml::Thread io_thread_;
+  TaskRunners task_runners_;
+  fml::TimePoint next_frame_start_time_;
+};
+
+// Frame timings are only acted on once there are this many of them.
+constexpr size_t kTimingWindow = 10;
+// How many frames in a row must call for a lower depth.
+constexpr size_t kLowerDepthStreak = 30;
+// The first frame with a full window already counts towards the streak.
+constexpr size_t kFramesToLowerDepth = kTimingWindow + kLowerDepthStreak - 1;
+
+TEST_F(AnimatorTest, DeepensPipelineWhenRasterBound) {
+  WithAnimator([this](Animator* animator) {
+    ASSERT_EQ(GetDepth(animator), 2u);
+
+    RasterizeFrames(animator, kTimingWindow - 1,
+                    fml::TimeDelta::FromMilliseconds(2),
+                    fml::TimeDelta::FromMilliseconds(20));
+    ASSERT_EQ(GetDepth(animator), 2u);
+
+    RasterizeFrames(animator, 1, fml::TimeDelta::FromMilliseconds(2),
+                    fml::TimeDelta::FromMilliseconds(20));
+    ASSERT_EQ(GetDepth(animator), 3u);
+    ASSERT_EQ(animator->GetFramePacingStats().predicted_raster_time,
+              fml::TimeDelta::FromMilliseconds(20));
+  });
+}
+
+TEST_F(AnimatorTest, ShortensPipelineWhenFramesAreCheap) {
+  WithAnimator([this](Animator* animator) {
+    RasterizeFrames(animator, kFramesToLowerDepth - 1,
+                    fml::TimeDelta::FromMilliseconds(2),
+                    fml::TimeDelta::FromMilliseconds(2));
+    ASSERT_EQ(GetDepth(animator), 2u);
+
+    RasterizeFrames(animator, 1, fml::TimeDelta::FromMilliseconds(2),
+                    fml::TimeDelta::FromMilliseconds(2));
+    ASSERT_EQ(GetDepth(animator), 1u);
+  });
+}
+
+TEST_F(AnimatorTest, KeepsPipelineWhenEachPhaseFitsOnItsOwn) {
+  WithAnimator([this](Animator* animator) {
+    RasterizeFrames(animator, 2 * kFramesToLowerDepth,
+                    fml::TimeDelta::FromMilliseconds(10),
+                    fml::TimeDelta::FromMilliseconds(10));
+    ASSERT_EQ(GetDepth(animator), 2u);
+  });
+}
+
+TEST_F(AnimatorTest, DeepensPipelineAtOnceWhenAFrameIsSkipped) {
+  WithAnimator([](Animator* animator) {
+    SkipFrame(animator);
+    ASSERT_EQ(GetDepth(animator), 3u);
+    SkipFrame(animator);
+    ASSERT_EQ(GetDepth(animator), 3u);
+  });
+}
+
+TEST_F(AnimatorTest, LowersPipelineDepthOneStepAtATime) {
+  WithAnimator([this](Animator* animator) {
+    SkipFrame(animator);
+    ASSERT_EQ(GetDepth(animator), 3u);
+
+    RasterizeFrames(animator, kFramesToLowerDepth,
+                    fml::TimeDelta::FromMilliseconds(2),
+                    fml::TimeDelta::FromMilliseconds(2));
+    ASSERT_EQ(GetDepth(animator), 2u);
+
+    RasterizeFrames(animator, kLowerDepthStreak - 1,
+                    fml::TimeDelta::FromMilliseconds(2),
+                    fml::TimeDelta::FromMilliseconds(2));
+    ASSERT_EQ(GetDepth(animator), 2u);
+
+    RasterizeFrames(animator, 1, fml::TimeDelta::FromMilliseconds(2),
+                    fml::TimeDelta::FromMilliseconds(2));
+    ASSERT_EQ(GetDepth(animator), 1u);
+  });
+}
+
+TEST_F(AnimatorTest, SlowFrameInterruptsLoweringTheDepth) {
+  WithAnimator([this](Animator* animator) {
+    RasterizeFrames(animator, kFramesToLowerDepth - 1,
+                    fml::TimeDelta::FromMilliseconds(2),
+                    fml::TimeDelta::FromMilliseconds(2));
+    // Each phase of this frame still fits on its own, so it calls for the
+    // current depth and the streak starts over once it has left the window.
+    RasterizeFrames(animator, 1, fml::TimeDelta::FromMilliseconds(10),
+                    fml::TimeDelta::FromMilliseconds(10));
+    RasterizeFrames(animator, kFramesToLowerDepth - 1,
+                    fml::TimeDelta::FromMilliseconds(2),
+                    fml::TimeDelta::FromMilliseconds(2));
+    ASSERT_EQ(GetDepth(animator), 2u);
+
+    RasterizeFrames(animator, 1, fml::TimeDelta::FromMilliseconds(2),
+                    fml::TimeDelta::FromMilliseconds(2));
+    ASSERT_EQ(GetDepth(animator), 1u);
+  });
+}
+
+TEST_F(AnimatorTest, KeepsFixedDepthWhenGPUSharesThePlatformThread) {
+  const TaskRunners& task_runners = GetTaskRunners();
+  TaskRunners shared_gpu_task_runners(
+      "animator_test", task_runners.GetPlatformTaskRunner(),
+      task_runners.GetPlatformTaskRunner(), task_runners.GetUITaskRunner(),
+      task_runners.GetIOTaskRunner());
+  WithAnimator(shared_gpu_task_runners, [this](Animator* animator) {
+    ASSERT_EQ(GetDepth(animator), 1u);
+    SkipFrame(animator);
+    RasterizeFrames(animator, kTimingWindow,
+                    fml::TimeDelta::FromMilliseconds(2),
+                    fml::TimeDelta::FromMilliseconds(20));
+    ASSERT_EQ(GetDepth(animator), 1u);
+  });
+}
+
+TEST_F(AnimatorTest, ReportsInputLatencyAndLateFrames) {
+  WithAnimator([this](Animator* animator) {
+    const fml::TimePoint frame_start_time = NextFrameStartTime(animator);
+    RasterizeFrame(animator, frame_start_time,
+                   fml::TimeDelta::FromMilliseconds(4),
+                   fml::TimeDelta::FromMilliseconds(4),
+                   frame_start_time - fml::TimeDelta::FromMilliseconds(3));
+    auto stats = animator->GetFramePacingStats();
+    ASSERT_EQ(stats.frames_rasterized, 1u);
+    ASSERT_EQ(stats.frames_late, 0u);
+    ASSERT_EQ(stats.last_input_latency, fml::TimeDelta::FromMilliseconds(11));
+
+    RasterizeFrame(animator, NextFrameStartTime(animator),
+                   fml::TimeDelta::FromMilliseconds(10),
+                   fml::TimeDelta::FromMilliseconds(10));
+    stats = animator->GetFramePacingStats();
+    ASSERT_EQ(stats.frames_rasterized, 2u);
+    ASSERT_EQ(stats.frames_late, 1u);
+    ASSERT_EQ(stats.last_input_latency, fml::TimeDelta::FromMilliseconds(11));
+    ASSERT_EQ(stats.max_input_latency, fml::TimeDelta::FromMilliseconds(11));
+  });
+}
+
+TEST_F(AnimatorTest, MeasuresInputLatencyFromTheFirstInputOfAFrame) {
+  WithAnimator([](Animator* animator) {
+    const fml::TimePoint first_input_time = fml::TimePoint::Now();
+    animator->EnqueueTraceFlowId(0, first_input_time);
+    animator->EnqueueTraceFlowId(
+        1, first_input_time + fml::TimeDelta::FromMilliseconds(5));
+    ASSERT_EQ(GetPendingInputTime(animator), first_input_time);
+  });
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -50,6 +50,7 @@ Engine::Engine(Delegate& delegate,
       image_decoder_(task_runners,
                      vm.GetConcurrentWorkerTaskRunner(),
                      io_manager),
+      idle_task_queue_(std::make_shared<IdleTaskQueue>()),
       weak_factory_(this) {
   // Runtime controller is initialized here because it takes a reference to this
   // object as its delegate. The delegate may be called in the constructor and
@@ -216,10 +217,27 @@ void Engine::ReportTimings(std::vector<int64_t> timings) {
   runtime_controller_->ReportTimings(std::move(timings));
 }
 
-void Engine::NotifyIdle(int64_t deadline) {
+void Engine::NotifyIdle(fml::TimePoint deadline) {
+  const int64_t deadline_now_delta =
+      (deadline - fml::TimePoint::Now()).ToMicroseconds();
   TRACE_EVENT1("flutter", "Engine::NotifyIdle", "deadline_now_delta",
-               std::to_string(deadline).c_str());
-  runtime_controller_->NotifyIdle(deadline);
+               std::to_string(deadline_now_delta).c_str());
+  runtime_controller_->NotifyIdle(deadline_now_delta);
+  // Whatever is left of the period once the embedder is done goes to the
+  // engine's own deferrable work.
+  idle_task_queue_->RunUntil(deadline);
+}
+
+std::shared_ptr<IdleTaskQueue> Engine::GetIdleTaskQueue() const {
+  return idle_task_queue_;
+}
+
+void Engine::OnFrameRasterized(const FrameTiming& timing) {
+  animator_->OnFrameRasterized(timing);
+}
+
+Animator::FramePacingStats Engine::GetFramePacingStats() const {
+  return animator_->GetFramePacingStats();
 }
 
 std::pair<bool, uint32_t> Engine::GetUIIsolateReturnCode() {
@@ -375,10 +393,11 @@ void Engine::HandleSettingsPlatformMessage(PlatformMessage* message) {
 }
 
 void Engine::DispatchPointerDataPacket(const PointerDataPacket& packet,
-                                       uint64_t trace_flow_id) {
+                                       uint64_t trace_flow_id,
+                                       fml::TimePoint input_time) {
   TRACE_EVENT0("flutter", "Engine::DispatchPointerDataPacket");
   TRACE_FLOW_STEP("flutter", "PointerEvent", trace_flow_id);
-  animator_->EnqueueTraceFlowId(trace_flow_id);
+  animator_->EnqueueTraceFlowId(trace_flow_id, input_time);
   runtime_controller_->DispatchPointerDataPacket(packet);
 }
 
@@ -19,6 +19,7 @@
 #include "flutter/runtime/runtime_controller.h"
 #include "flutter/runtime/runtime_delegate.h"
 #include "flutter/shell/common/animator.h"
+#include "flutter/shell/common/idle_task_queue.h"
 #include "flutter/shell/common/rasterizer.h"
 #include "flutter/shell/common/run_configuration.h"
 #include "flutter/shell/common/shell_io_manager.h"
@@ -406,15 +407,38 @@ class Engine final : public RuntimeDelegate {
   ///             collection, just gives the Dart VM more hints about opportune
   ///             moments to perform collections.
   ///
-  //  TODO(chinmaygarde): This should just use fml::TimePoint instead of having
-  //  to remember that the unit is microseconds (which is no used anywhere else
-  //  in the engine).
+  /// @param[in]  deadline  The end of the idle period. For the "small" idle
+  ///                       notification, this is the target time of the frame
+  ///                       that was just built.
   ///
-  /// @param[in]  deadline  The deadline as a timepoint in microseconds measured
-  ///                       against the system monotonic clock. Use
-  ///                       `Dart_TimelineGetMicros()`, for consistency.
+  void NotifyIdle(fml::TimePoint deadline);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Gets the queue of deferrable engine work that runs in the idle
+  ///             periods reported via `NotifyIdle`, after the embedder's idle
+  ///             notification callback has had its turn. Subsystems on any
+  ///             thread may hold on to the queue and post to it.
+  ///
+  /// @return     The idle task queue of this engine.
+  ///
+  std::shared_ptr<IdleTaskQueue> GetIdleTaskQueue() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Notifies the engine that a frame it produced has been
+  ///             rasterized. The animator uses the timings of recent frames to
+  ///             pace the frames that follow.
+  ///
+  /// @param[in]  timing  The build and raster timestamps of the frame.
+  ///
+  void OnFrameRasterized(const FrameTiming& timing);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Gets the frame pacing statistics of the animator, such as the
+  ///             number of dropped frames and the input to photon latency.
+  ///
+  /// @return     The frame pacing statistics.
   ///
-  void NotifyIdle(int64_t deadline);
+  Animator::FramePacingStats GetFramePacingStats() const;
 
   //----------------------------------------------------------------------------
   /// @brief      Indicates to the Flutter application that it has obtained a
@@ -490,9 +514,13 @@ class Engine final : public RuntimeDelegate {
   ///                            These flows are tagged as "PointerEvent" in the
   ///                            timeline and allow grouping frames and input
   ///                            events into logical chunks.
+  /// @param[in]  input_time     When the packet reached the platform thread.
+  ///                            Frame pacing measures input latency from
+  ///                            here.
   ///
   void DispatchPointerDataPacket(const PointerDataPacket& packet,
-                                 uint64_t trace_flow_id);
+                                 uint64_t trace_flow_id,
+                                 fml::TimePoint input_time);
   // |RuntimeDelegate|
   void ScheduleFrame(bool regenerate_layer_tree = true) override;
 
@@ -511,6 +539,7 @@ class Engine final : public RuntimeDelegate {
   bool have_surface_;
   std::once_flag font_flag_;
   std::unique_ptr<FontCollection> font_collection_;
+  std::shared_ptr<IdleTaskQueue> idle_task_queue_;
   fml::WeakPtrFactory<Engine> weak_factory_;
 
   // |RuntimeDelegate|
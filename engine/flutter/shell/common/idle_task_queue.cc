@@ -0,0 +1,87 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/idle_task_queue.h"
+
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+IdleTaskQueue::IdleTaskQueue() = default;
+
+IdleTaskQueue::~IdleTaskQueue() = default;
+
+void IdleTaskQueue::PostTask(fml::RefPtr<fml::TaskRunner> task_runner,
+                             fml::closure task,
+                             fml::TimeDelta estimated_cost) {
+  if (!task_runner || !task) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  tasks_.push_back({std::move(task_runner), std::move(task), estimated_cost});
+}
+
+void IdleTaskQueue::RunUntil(fml::TimePoint deadline) {
+  const fml::TimePoint start = fml::TimePoint::Now();
+  if (deadline <= start) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.idle_periods++;
+    stats_.budget = stats_.budget + (deadline - start);
+  }
+
+  TRACE_EVENT0("flutter", "IdleTaskQueue::RunUntil");
+  // Time charged for tasks dispatched to other threads, which does not show up
+  // on the clock of this one.
+  fml::TimeDelta dispatched_cost;
+  size_t index = 0;
+  while (true) {
+    IdleTask idle_task;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      const fml::TimeDelta remaining =
+          deadline - fml::TimePoint::Now() - dispatched_cost;
+      // Tasks that do not fit are left in place, so they keep their turn for
+      // the next idle period.
+      while (index < tasks_.size() &&
+             tasks_[index].estimated_cost > remaining) {
+        stats_.tasks_deferred++;
+        index++;
+      }
+      if (index >= tasks_.size()) {
+        break;
+      }
+      idle_task = std::move(tasks_[index]);
+      tasks_.erase(tasks_.begin() + index);
+      stats_.tasks_run++;
+    }
+
+    if (idle_task.task_runner->RunsTasksOnCurrentThread()) {
+      const fml::TimePoint task_start = fml::TimePoint::Now();
+      idle_task.task();
+      std::lock_guard<std::mutex> lock(mutex_);
+      stats_.used = stats_.used + (fml::TimePoint::Now() - task_start);
+    } else {
+      idle_task.task_runner->PostTask(std::move(idle_task.task));
+      dispatched_cost = dispatched_cost + idle_task.estimated_cost;
+      std::lock_guard<std::mutex> lock(mutex_);
+      stats_.used = stats_.used + idle_task.estimated_cost;
+    }
+  }
+}
+
+size_t IdleTaskQueue::GetPendingTaskCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return tasks_.size();
+}
+
+IdleTaskQueue::Stats IdleTaskQueue::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+}  // namespace flutter
@@ -0,0 +1,93 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_IDLE_TASK_QUEUE_H_
+#define FLUTTER_SHELL_COMMON_IDLE_TASK_QUEUE_H_
+
+#include <deque>
+#include <mutex>
+
+#include "flutter/fml/closure.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/task_runner.h"
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace flutter {
+
+/// A queue of deferrable engine work, such as cache warming or trimming, that
+/// only runs while the UI thread is idle between frames.
+///
+/// Tasks may be posted from any thread along with the task runner they must
+/// run on and an estimate of how long they take. Each time the animator
+/// reports an idle period, the engine drains the queue on the UI thread,
+/// picking tasks in posting order whose estimates fit in what is left of the
+/// period. Tasks for the UI task runner run right away. Tasks for other task
+/// runners are posted to them, and their estimates are charged against the
+/// period so that a single idle period does not flood the other threads.
+class IdleTaskQueue {
+ public:
+  struct Stats {
+    // The number of idle periods the queue was given.
+    size_t idle_periods = 0;
+    // The sum of the lengths of those periods.
+    fml::TimeDelta budget;
+    // The part of the budget spent running tasks. This is the measured time of
+    // tasks run on the UI thread and the estimated time of the others.
+    fml::TimeDelta used;
+    // The number of tasks run or dispatched to their task runners.
+    size_t tasks_run = 0;
+    // The number of times a task was passed over because it did not fit in
+    // the rest of an idle period.
+    size_t tasks_deferred = 0;
+  };
+
+  IdleTaskQueue();
+
+  ~IdleTaskQueue();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Queues a task to run during a future idle period. May be
+  ///             called on any thread.
+  ///
+  /// @param[in]  task_runner     The task runner the task must run on.
+  /// @param[in]  task            The task.
+  /// @param[in]  estimated_cost  How long the task is expected to run. Tasks
+  ///                             that take longer than the long idle period
+  ///                             reported when no frames are scheduled
+  ///                             (100ms) will never run.
+  ///
+  void PostTask(fml::RefPtr<fml::TaskRunner> task_runner,
+                fml::closure task,
+                fml::TimeDelta estimated_cost);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Runs or dispatches queued tasks until the deadline. Must be
+  ///             called on the UI task runner.
+  ///
+  /// @param[in]  deadline  The end of the idle period.
+  ///
+  void RunUntil(fml::TimePoint deadline);
+
+  size_t GetPendingTaskCount() const;
+
+  Stats GetStats() const;
+
+ private:
+  struct IdleTask {
+    fml::RefPtr<fml::TaskRunner> task_runner;
+    fml::closure task;
+    fml::TimeDelta estimated_cost;
+  };
+
+  mutable std::mutex mutex_;
+  std::deque<IdleTask> tasks_;
+  Stats stats_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(IdleTaskQueue);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_IDLE_TASK_QUEUE_H_
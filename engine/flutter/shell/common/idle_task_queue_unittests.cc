@@ -0,0 +1,95 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#define FML_USED_ON_EMBEDDER
+
+#include <vector>
+
+#include "flutter/fml/message_loop.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/thread.h"
+#include "flutter/shell/common/idle_task_queue.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+static fml::RefPtr<fml::TaskRunner> CurrentTaskRunner() {
+  fml::MessageLoop::EnsureInitializedForCurrentThread();
+  return fml::MessageLoop::GetCurrent().GetTaskRunner();
+}
+
+static fml::TimePoint DeadlineIn(int64_t millis) {
+  return fml::TimePoint::Now() + fml::TimeDelta::FromMilliseconds(millis);
+}
+
+TEST(IdleTaskQueueTest, RunsTasksInPostingOrder) {
+  auto runner = CurrentTaskRunner();
+  IdleTaskQueue queue;
+  std::vector<int> order;
+  for (int i = 0; i < 3; i++) {
+    queue.PostTask(runner, [&order, i]() { order.push_back(i); },
+                   fml::TimeDelta::FromMicroseconds(1));
+  }
+
+  queue.RunUntil(DeadlineIn(1000));
+
+  ASSERT_EQ(order, std::vector<int>({0, 1, 2}));
+  ASSERT_EQ(queue.GetPendingTaskCount(), 0u);
+  ASSERT_EQ(queue.GetStats().tasks_run, 3u);
+  ASSERT_EQ(queue.GetStats().idle_periods, 1u);
+}
+
+TEST(IdleTaskQueueTest, DefersTasksThatDoNotFit) {
+  auto runner = CurrentTaskRunner();
+  IdleTaskQueue queue;
+  std::vector<int> order;
+  queue.PostTask(runner, [&order]() { order.push_back(0); },
+                 fml::TimeDelta::FromSeconds(60));
+  queue.PostTask(runner, [&order]() { order.push_back(1); },
+                 fml::TimeDelta::FromMicroseconds(1));
+
+  queue.RunUntil(DeadlineIn(1000));
+
+  ASSERT_EQ(order, std::vector<int>({1}));
+  ASSERT_EQ(queue.GetPendingTaskCount(), 1u);
+  ASSERT_EQ(queue.GetStats().tasks_deferred, 1u);
+}
+
+TEST(IdleTaskQueueTest, DoesNothingPastTheDeadline) {
+  auto runner = CurrentTaskRunner();
+  IdleTaskQueue queue;
+  bool ran = false;
+  queue.PostTask(runner, [&ran]() { ran = true; }, fml::TimeDelta::Zero());
+
+  queue.RunUntil(fml::TimePoint::Now() - fml::TimeDelta::FromMilliseconds(1));
+
+  ASSERT_FALSE(ran);
+  ASSERT_EQ(queue.GetPendingTaskCount(), 1u);
+  ASSERT_EQ(queue.GetStats().idle_periods, 0u);
+}
+
+TEST(IdleTaskQueueTest, DispatchesTasksForOtherTaskRunners) {
+  CurrentTaskRunner();
+  fml::Thread thread("idle_task_queue_test");
+  IdleTaskQueue queue;
+  fml::AutoResetWaitableEvent latch;
+  bool ran_on_thread = false;
+  auto runner = thread.GetTaskRunner();
+  queue.PostTask(runner,
+                 [&]() {
+                   ran_on_thread = runner->RunsTasksOnCurrentThread();
+                   latch.Signal();
+                 },
+                 fml::TimeDelta::FromMilliseconds(2));
+
+  queue.RunUntil(DeadlineIn(1000));
+  latch.Wait();
+
+  ASSERT_TRUE(ran_on_thread);
+  ASSERT_EQ(queue.GetStats().used, fml::TimeDelta::FromMilliseconds(2));
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -10,6 +10,7 @@
 #include "flutter/fml/synchronization/semaphore.h"
 #include "flutter/fml/trace_event.h"
 
+#include <atomic>
 #include <deque>
 #include <memory>
 #include <mutex>
@@ -95,6 +96,34 @@ class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
 
   bool IsValid() const { return empty_.IsValid() && available_.IsValid(); }
 
+  uint32_t GetDepth() const { return depth_; }
+
+  // Changes the number of resources that may be in flight at once. May be
+  // called on any thread.
+  //
+  // Raising the depth takes effect immediately. Lowering it below the number
+  // of resources in flight takes effect as they are consumed.
+  void SetDepth(uint32_t depth) {
+    if (depth == 0) {
+      return;
+    }
+    std::scoped_lock lock(depth_mutex_);
+    while (depth_ < depth) {
+      if (slots_to_retire_ > 0) {
+        slots_to_retire_--;
+      } else {
+        empty_.Signal();
+      }
+      depth_++;
+    }
+    while (depth_ > depth) {
+      if (!empty_.TryWait()) {
+        slots_to_retire_++;
+      }
+      depth_--;
+    }
+  }
+
   ProducerContinuation Produce() {
     if (!empty_.TryWait()) {
       return {};
@@ -148,7 +177,7 @@ class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
       consumer(std::move(resource));
     }
 
-    empty_.Signal();
+    ReleaseSlot();
 
     TRACE_FLOW_END("flutter", "PipelineItem", trace_id);
     TRACE_EVENT_ASYNC_END0("flutter", "PipelineItem", trace_id);
@@ -158,12 +187,27 @@ class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
   }
 
  private:
-  uint32_t depth_;
+  std::atomic<uint32_t> depth_;
+  std::mutex depth_mutex_;
+  // Slots of resources in flight when the depth was lowered, which are not
+  // handed back to the producer once the resources are consumed.
+  uint32_t slots_to_retire_ = 0;
   fml::Semaphore empty_;
   fml::Semaphore available_;
   std::mutex queue_mutex_;
   std::deque<std::pair<ResourcePtr, size_t>> queue_;
 
+  void ReleaseSlot() {
+    {
+      std::scoped_lock lock(depth_mutex_);
+      if (slots_to_retire_ > 0) {
+        slots_to_retire_--;
+        return;
+      }
+    }
+    empty_.Signal();
+  }
+
   void ProducerCommit(ResourcePtr resource, size_t trace_id) {
     {
       std::scoped_lock lock(queue_mutex_);
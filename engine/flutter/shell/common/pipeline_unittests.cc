@@ -131,5 +131,45 @@ TEST(PipelineTest, PushingToFrontDropsLastResource) {
   ASSERT_EQ(consume_result_2, PipelineConsumeResult::Done);
 }
 
+TEST(PipelineTest, RaisingDepthAllowsMoreInFlight) {
+  fml::RefPtr<IntPipeline> pipeline = fml::MakeRefCounted<IntPipeline>(1);
+
+  Continuation continuation_1 = pipeline->Produce();
+  ASSERT_TRUE(continuation_1);
+  ASSERT_FALSE(pipeline->Produce());
+
+  pipeline->SetDepth(2);
+  ASSERT_EQ(pipeline->GetDepth(), 2u);
+  Continuation continuation_2 = pipeline->Produce();
+  ASSERT_TRUE(continuation_2);
+  ASSERT_FALSE(pipeline->Produce());
+}
+
+TEST(PipelineTest, LoweringDepthRetiresSlotsAsTheyAreConsumed) {
+  fml::RefPtr<IntPipeline> pipeline = fml::MakeRefCounted<IntPipeline>(2);
+
+  Continuation continuation_1 = pipeline->Produce();
+  Continuation continuation_2 = pipeline->Produce();
+  continuation_1.Complete(std::make_unique<int>(1));
+  continuation_2.Complete(std::make_unique<int>(2));
+
+  pipeline->SetDepth(1);
+  ASSERT_EQ(pipeline->GetDepth(), 1u);
+
+  // Both resources are still in flight, so the first one consumed does not
+  // free up a slot.
+  PipelineConsumeResult consume_result_1 =
+      pipeline->Consume([](std::unique_ptr<int> v) { ASSERT_EQ(*v, 1); });
+  ASSERT_EQ(consume_result_1, PipelineConsumeResult::MoreAvailable);
+  ASSERT_FALSE(pipeline->Produce());
+
+  PipelineConsumeResult consume_result_2 =
+      pipeline->Consume([](std::unique_ptr<int> v) { ASSERT_EQ(*v, 2); });
+  ASSERT_EQ(consume_result_2, PipelineConsumeResult::Done);
+  Continuation continuation_3 = pipeline->Produce();
+  ASSERT_TRUE(continuation_3);
+  ASSERT_FALSE(pipeline->Produce());
+}
+
 }  // namespace testing
 }  // namespace flutter
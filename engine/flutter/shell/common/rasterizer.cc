@@ -22,6 +22,11 @@ namespace flutter {
 // The rasterizer will tell Skia to purge cached resources that have not been
 // used within this interval.
 static constexpr std::chrono::milliseconds kSkiaCleanupExpiration(15000);
+
+// How long the rasterizer expects such a cleanup to block the GPU thread when
+// it has many textures to free.
+static constexpr fml::TimeDelta kSkiaCleanupEstimatedCost =
+    fml::TimeDelta::FromMilliseconds(2);
 #endif
 
 // TODO(dnfield): Remove this once internal embedders have caught up.
@@ -46,6 +51,7 @@ Rasterizer::Rasterizer(
       task_runners_(std::move(task_runners)),
       compositor_context_(std::move(compositor_context)),
       user_override_resource_cache_bytes_(false),
+      deferred_cleanup_pending_(false),
       weak_factory_(this) {
   FML_DCHECK(compositor_context_);
 }
@@ -267,7 +273,7 @@ RasterStatus Rasterizer::DrawToSurface(flutter::LayerTree& layer_tree) {
     FireNextFrameCallbackIfPresent();
 #ifndef GPU_DISABLED
     if (surface_->GetContext()) {
-      surface_->GetContext()->performDeferredCleanup(kSkiaCleanupExpiration);
+      ScheduleDeferredCleanup();
     }
 #endif
     return raster_status;
@@ -438,6 +444,35 @@ void Rasterizer::FireNextFrameCallbackIfPresent() {
   callback();
 }
 
+#ifndef GPU_DISABLED
+void Rasterizer::ScheduleDeferredCleanup() {
+  // One pending cleanup covers all the frames drawn until it runs.
+  if (deferred_cleanup_pending_) {
+    return;
+  }
+  auto idle_task_queue = delegate_.GetIdleTaskQueue();
+  if (!idle_task_queue) {
+    surface_->GetContext()->performDeferredCleanup(kSkiaCleanupExpiration);
+    return;
+  }
+  deferred_cleanup_pending_ = true;
+  idle_task_queue->PostTask(
+      task_runners_.GetGPUTaskRunner(),
+      [rasterizer = GetWeakPtr()]() {
+        if (!rasterizer) {
+          return;
+        }
+        rasterizer->deferred_cleanup_pending_ = false;
+        if (rasterizer->surface_ && rasterizer->surface_->GetContext()) {
+          TRACE_EVENT0("flutter", "Rasterizer::DeferredCleanup");
+          rasterizer->surface_->GetContext()->performDeferredCleanup(
+              kSkiaCleanupExpiration);
+        }
+      },
+      kSkiaCleanupEstimatedCost);
+}
+#endif
+
 void Rasterizer::SetResourceCacheMaxBytes(size_t max_bytes, bool from_user) {
   user_override_resource_cache_bytes_ |= from_user;
 
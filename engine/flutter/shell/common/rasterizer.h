@@ -16,6 +16,7 @@
 #include "flutter/fml/gpu_thread_merger.h"
 #include "flutter/fml/memory/weak_ptr.h"
 #include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/shell/common/idle_task_queue.h"
 #include "flutter/shell/common/pipeline.h"
 #include "flutter/shell/common/surface.h"
 
@@ -63,11 +64,25 @@ class Rasterizer final {
     ///                           the frame workload.
     ///
     virtual void OnFrameRasterized(const FrameTiming& frame_timing) = 0;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Gets the queue of deferrable work that runs while the UI
+    ///             thread is idle between frames. The rasterizer trims the
+    ///             Skia resource cache from there instead of after every
+    ///             frame.
+    ///
+    /// @return     The idle task queue, or null if the rasterizer should do
+    ///             such work right away.
+    ///
+    virtual std::shared_ptr<IdleTaskQueue> GetIdleTaskQueue() = 0;
   };
 
   // TODO(dnfield): remove once embedders have caught up.
   class DummyDelegate : public Delegate {
     void OnFrameRasterized(const FrameTiming&) override {}
+    std::shared_ptr<IdleTaskQueue> GetIdleTaskQueue() override {
+      return nullptr;
+    }
   };
 
   //----------------------------------------------------------------------------
@@ -410,6 +425,7 @@ class Rasterizer final {
   fml::closure next_frame_callback_;
   bool user_override_resource_cache_bytes_;
   std::optional<size_t> max_cache_bytes_;
+  bool deferred_cleanup_pending_;
   fml::WeakPtrFactory<Rasterizer> weak_factory_;
   fml::RefPtr<fml::GpuThreadMerger> gpu_thread_merger_;
 
@@ -419,6 +435,8 @@ class Rasterizer final {
 
   void FireNextFrameCallbackIfPresent();
 
+  void ScheduleDeferredCleanup();
+
   FML_DISALLOW_COPY_AND_ASSIGN(Rasterizer);
 };
 
@@ -173,6 +173,8 @@ class Shell final : public PlatformView::Delegate,
   fml::WeakPtr<Rasterizer> weak_rasterizer_;  // to be shared across threads
   fml::WeakPtr<PlatformView>
       weak_platform_view_;  // to be shared across threads
+  std::shared_ptr<IdleTaskQueue>
+      idle_task_queue_;  // the engine's, to be shared across threads
 
   bool is_setup_ = false;
   uint64_t next_pointer_flow_id_ = 0;
@@ -252,7 +254,7 @@ class Shell final : public PlatformView::Delegate,
   void OnAnimatorBeginFrame(fml::TimePoint frame_time) override;
 
   // |Animator::Delegate|
-  void OnAnimatorNotifyIdle(int64_t deadline) override;
+  void OnAnimatorNotifyIdle(fml::TimePoint deadline) override;
 
   // |Animator::Delegate|
   void OnAnimatorDraw(
@@ -276,6 +278,9 @@ class Shell final : public PlatformView::Delegate,
   // |Rasterizer::Delegate|
   void OnFrameRasterized(const FrameTiming&) override;
 
+  // |Rasterizer::Delegate|
+  std::shared_ptr<IdleTaskQueue> GetIdleTaskQueue() override;
+
   fml::WeakPtrFactory<Shell> weak_factory_;
 
   friend class testing::ShellTest;
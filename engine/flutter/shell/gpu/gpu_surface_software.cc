@@ -4,8 +4,10 @@
 
 #include "flutter/shell/gpu/gpu_surface_software.h"
 
+#include <cstring>
 #include <memory>
 #include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
 
 namespace flutter {
 
@@ -14,6 +16,56 @@ GPUSurfaceSoftware::GPUSurfaceSoftware(GPUSurfaceSoftwareDelegate* delegate)
 
 GPUSurfaceSoftware::~GPUSurfaceSoftware() = default;
 
+// A 64-bit multiplicative hash of the pixels of row |y|. Rows that hash alike
+// are taken to be unchanged, so 32 bits would not be enough.
+static uint64_t HashRow(const SkPixmap& pixmap, int y) {
+  const auto* bytes = static_cast<const uint8_t*>(pixmap.addr(0, y));
+  const size_t size = pixmap.info().minRowBytes();
+  uint64_t hash = 0xcbf29ce484222325u;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, bytes + i, sizeof(word));
+    hash = (hash ^ word) * 0x9e3779b97f4a7c15u;
+    hash ^= hash >> 29;
+  }
+  for (; i < size; i++) {
+    hash = (hash ^ bytes[i]) * 0x100000001b3u;
+  }
+  return hash;
+}
+
+SkIRect GPUSurfaceSoftware::ComputeFrameDamage(
+    const SkPixmap& frame,
+    const std::vector<uint64_t>& previous_row_hashes,
+    std::vector<uint64_t>* row_hashes) {
+  TRACE_EVENT0("flutter", "GPUSurfaceSoftware::ComputeFrameDamage");
+  row_hashes->clear();
+  if (frame.addr() == nullptr) {
+    return frame.bounds();
+  }
+
+  row_hashes->resize(frame.height());
+  for (int y = 0; y < frame.height(); y++) {
+    (*row_hashes)[y] = HashRow(frame, y);
+  }
+  if (previous_row_hashes.size() != row_hashes->size()) {
+    return frame.bounds();
+  }
+
+  int top = 0;
+  while (top < frame.height() &&
+         (*row_hashes)[top] == previous_row_hashes[top]) {
+    top++;
+  }
+  int bottom = frame.height();
+  while (bottom > top &&
+         (*row_hashes)[bottom - 1] == previous_row_hashes[bottom - 1]) {
+    bottom--;
+  }
+  return SkIRect::MakeLTRB(0, top, frame.width(), bottom);
+}
+
 // |Surface|
 bool GPUSurfaceSoftware::IsValid() {
   return delegate_ != nullptr;
@@ -35,6 +87,7 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
   }
 
   if (size != SkISize::Make(backing_store->width(), backing_store->height())) {
+    delegate_->DiscardBackingStore(std::move(backing_store));
     return nullptr;
   }
 
@@ -48,7 +101,13 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
       [self = weak_factory_.GetWeakPtr()](const SurfaceFrame& surface_frame,
                                           SkCanvas* canvas) -> bool {
     // If the surface itself went away, there is nothing more to do.
-    if (!self || !self->IsValid() || canvas == nullptr) {
+    if (!self || !self->IsValid()) {
+      return false;
+    }
+
+    // The frame is dropped without being submitted.
+    if (canvas == nullptr) {
+      self->delegate_->DiscardBackingStore(surface_frame.SkiaSurface());
       return false;
     }
 
@@ -5,6 +5,9 @@
 #ifndef FLUTTER_SHELL_GPU_GPU_SURFACE_SOFTWARE_H_
 #define FLUTTER_SHELL_GPU_GPU_SURFACE_SOFTWARE_H_
 
+#include <cstdint>
+#include <vector>
+
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/weak_ptr.h"
 #include "flutter/shell/common/surface.h"
@@ -16,6 +19,28 @@ class GPUSurfaceSoftware : public Surface {
  public:
   GPUSurfaceSoftware(GPUSurfaceSoftwareDelegate* delegate);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Finds where a software frame differs from the frame presented
+  ///             before it, for platforms that can pass damage on to their
+  ///             compositor. Frames are compared by 64-bit row hashes, so the
+  ///             previous frame need not be read again, and its memory may
+  ///             have been reused by the time the next frame is presented.
+  ///
+  /// @param[in]  frame                The frame about to be presented.
+  /// @param[in]  previous_row_hashes  The row hashes of the frame presented
+  ///                                  before it, or empty if there is none.
+  /// @param[out] row_hashes           The row hashes of |frame|, to compare
+  ///                                  the next frame against.
+  ///
+  /// @return     The band of rows in which the frames differ, across the full
+  ///             width of the frame. Empty if the frames are identical, and all
+  ///             of |frame| if they cannot be compared.
+  ///
+  static SkIRect ComputeFrameDamage(
+      const SkPixmap& frame,
+      const std::vector<uint64_t>& previous_row_hashes,
+      std::vector<uint64_t>* row_hashes);
+
   ~GPUSurfaceSoftware() override;
 
   // |Surface|
@@ -6,6 +6,9 @@
 
 namespace flutter {
 
+void GPUSurfaceSoftwareDelegate::DiscardBackingStore(
+    sk_sp<SkSurface> backing_store) {}
+
 ExternalViewEmbedder* GPUSurfaceSoftwareDelegate::GetExternalViewEmbedder() {
   return nullptr;
 }
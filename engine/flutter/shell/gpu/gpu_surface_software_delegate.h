@@ -47,6 +47,15 @@ class GPUSurfaceSoftwareDelegate {
   ///
   virtual bool PresentBackingStore(sk_sp<SkSurface> backing_store) = 0;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Called when a backing store returned by `AcquireBackingStore`
+  ///             will not be presented after all, e.g. because the frame was
+  ///             dropped. The platform may hand out the backing store again.
+  ///
+  /// @param[in]  backing_store  The software backing store that is discarded.
+  ///
+  virtual void DiscardBackingStore(sk_sp<SkSurface> backing_store);
+
   //----------------------------------------------------------------------------
   /// @brief      Gets the view embedder that controls how the Flutter layer
   ///             hierarchy split into multiple chunks should be composited back
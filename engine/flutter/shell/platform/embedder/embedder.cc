@@ -83,8 +83,19 @@ static bool IsSoftwareRendererConfigValid(const FlutterRendererConfig* config) {
 
   const FlutterSoftwareRendererConfig* software_config = &config->software;
 
-  if (SAFE_ACCESS(software_config, surface_present_callback, nullptr) ==
+  if (SAFE_ACCESS(software_config, surface_present_callback, nullptr) !=
       nullptr) {
+    return true;
+  }
+
+  // Without a present callback, Flutter must render into targets supplied by
+  // the embedder.
+  if (SAFE_ACCESS(software_config, render_target_acquire_callback, nullptr) ==
+          nullptr ||
+      SAFE_ACCESS(software_config, render_target_present_callback, nullptr) ==
+          nullptr ||
+      SAFE_ACCESS(software_config, render_target_release_callback, nullptr) ==
+          nullptr) {
     return false;
   }
 
@@ -213,6 +224,26 @@ InferOpenGLPlatformViewCreationCallback(
       });
 }
 
+static bool SkColorTypeFromSoftwarePixelFormat(
+    FlutterSoftwarePixelFormat pixel_format,
+    SkColorType* color_type) {
+  switch (pixel_format) {
+    case kFlutterSoftwarePixelFormatNative32:
+      *color_type = kN32_SkColorType;
+      return true;
+    case kFlutterSoftwarePixelFormatRGBA8888:
+      *color_type = kRGBA_8888_SkColorType;
+      return true;
+    case kFlutterSoftwarePixelFormatBGRA8888:
+      *color_type = kBGRA_8888_SkColorType;
+      return true;
+    case kFlutterSoftwarePixelFormatRGB565:
+      *color_type = kRGB_565_SkColorType;
+      return true;
+  }
+  return false;
+}
+
 static flutter::Shell::CreateCallback<flutter::PlatformView>
 InferSoftwarePlatformViewCreationCallback(
     const FlutterRendererConfig* config,
@@ -225,15 +256,93 @@ InferSoftwarePlatformViewCreationCallback(
     return nullptr;
   }
 
-  auto software_present_backing_store =
-      [ptr = config->software.surface_present_callback, user_data](
-          const void* allocation, size_t row_bytes, size_t height) -> bool {
-    return ptr(user_data, allocation, row_bytes, height);
-  };
+  const FlutterSoftwareRendererConfig* software_config = &config->software;
+
+  std::function<bool(const void*, size_t, size_t)>
+      software_present_backing_store = nullptr;
+  if (SAFE_ACCESS(software_config, surface_present_callback, nullptr) !=
+      nullptr) {
+    software_present_backing_store =
+        [ptr = software_config->surface_present_callback, user_data](
+            const void* allocation, size_t row_bytes, size_t height) -> bool {
+      return ptr(user_data, allocation, row_bytes, height);
+    };
+  }
+
+  using RenderTarget = flutter::EmbedderSurfaceSoftware::RenderTarget;
+  std::function<bool(const SkISize&, RenderTarget*)> acquire_render_target =
+      nullptr;
+  std::function<bool(const RenderTarget&, const SkIRect&)>
+      present_render_target = nullptr;
+  std::function<void(const RenderTarget&)> release_render_target = nullptr;
+  if (SAFE_ACCESS(software_config, render_target_acquire_callback, nullptr) !=
+          nullptr &&
+      SAFE_ACCESS(software_config, render_target_present_callback, nullptr) !=
+          nullptr &&
+      SAFE_ACCESS(software_config, render_target_release_callback, nullptr) !=
+          nullptr) {
+    acquire_render_target =
+        [ptr = software_config->render_target_acquire_callback,
+         release = software_config->render_target_release_callback,
+         user_data](const SkISize& size, RenderTarget* target) -> bool {
+      FlutterSoftwareRenderTarget embedder_target = {};
+      embedder_target.struct_size = sizeof(FlutterSoftwareRenderTarget);
+      if (!ptr(user_data, size.width(), size.height(), &embedder_target)) {
+        return false;
+      }
+      if (!SkColorTypeFromSoftwarePixelFormat(embedder_target.pixel_format,
+                                              &target->color_type)) {
+        FML_LOG(ERROR) << "Unknown software render target pixel format.";
+        release(user_data, &embedder_target);
+        return false;
+      }
+      target->pixel_format = embedder_target.pixel_format;
+      target->allocation = embedder_target.allocation;
+      target->row_bytes = embedder_target.row_bytes;
+      target->height = embedder_target.height;
+      target->user_data = embedder_target.user_data;
+      return true;
+    };
+    present_render_target =
+        [ptr = software_config->render_target_present_callback, user_data](
+            const RenderTarget& target, const SkIRect& damage) -> bool {
+      FlutterSoftwareRenderTarget embedder_target = {};
+      embedder_target.struct_size = sizeof(FlutterSoftwareRenderTarget);
+      embedder_target.allocation = target.allocation;
+      embedder_target.row_bytes = target.row_bytes;
+      embedder_target.height = target.height;
+      embedder_target.pixel_format = target.pixel_format;
+      embedder_target.user_data = target.user_data;
+
+      FlutterRect damage_rect = {};
+      damage_rect.left = damage.left();
+      damage_rect.top = damage.top();
+      damage_rect.right = damage.right();
+      damage_rect.bottom = damage.bottom();
+      return ptr(user_data, &embedder_target, &damage_rect,
+                 damage.isEmpty() ? 0 : 1);
+    };
+    release_render_target =
+        [ptr = software_config->render_target_release_callback,
+         user_data](const RenderTarget& target) {
+          FlutterSoftwareRenderTarget embedder_target = {};
+          embedder_target.struct_size = sizeof(FlutterSoftwareRenderTarget);
+          embedder_target.allocation = target.allocation;
+          embedder_target.row_bytes = target.row_bytes;
+          embedder_target.height = target.height;
+          embedder_target.pixel_format = target.pixel_format;
+          embedder_target.user_data = target.user_data;
+          ptr(user_data, &embedder_target);
+        };
+  }
 
   flutter::EmbedderSurfaceSoftware::SoftwareDispatchTable
       software_dispatch_table = {
-          software_present_backing_store,  // required
+          software_present_backing_store,  // required unless rendering into
+                                           // embedder supplied targets
+          acquire_render_target,           // optional
+          present_render_target,           // optional
+          release_render_target,           // optional
       };
 
   return fml::MakeCopyable(
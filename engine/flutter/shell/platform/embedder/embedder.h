@@ -74,6 +74,13 @@ typedef struct {
   double pers2;
 } FlutterTransformation;
 
+typedef struct {
+  double left;
+  double top;
+  double right;
+  double bottom;
+} FlutterRect;
+
 typedef void (*VoidCallback)(void* /* user data */);
 
 typedef enum {
@@ -174,6 +181,50 @@ typedef struct {
   TextureFrameCallback gl_external_texture_frame_callback;
 } FlutterOpenGLRendererConfig;
 
+typedef enum {
+  // The native 32-bit format, the same as that of the buffers given to
+  // |surface_present_callback|.
+  kFlutterSoftwarePixelFormatNative32,
+  // 32-bit premultiplied RGBA, with R in the lowest addressed byte.
+  kFlutterSoftwarePixelFormatRGBA8888,
+  // 32-bit premultiplied BGRA, with B in the lowest addressed byte.
+  kFlutterSoftwarePixelFormatBGRA8888,
+  // 16-bit opaque RGB 5:6:5, native endian.
+  kFlutterSoftwarePixelFormatRGB565,
+} FlutterSoftwarePixelFormat;
+
+typedef struct {
+  // The size of this struct. Must be sizeof(FlutterSoftwareRenderTarget).
+  size_t struct_size;
+  // The memory for Flutter to render the frame into, starting at its top left
+  // pixel.
+  void* allocation;
+  // The number of bytes in a single row of the allocation.
+  size_t row_bytes;
+  // The number of rows in the allocation. Must be at least the height of the
+  // frame.
+  size_t height;
+  // The format of the pixels in the allocation.
+  FlutterSoftwarePixelFormat pixel_format;
+  // A baton that is not interpreted by the engine in any way. The embedder may
+  // use this to identify the target within its pool of buffers.
+  void* user_data;
+} FlutterSoftwareRenderTarget;
+
+typedef bool (*SoftwareRenderTargetAcquireCallback)(
+    void* /* user data */,
+    size_t /* frame width */,
+    size_t /* frame height */,
+    FlutterSoftwareRenderTarget* /* render target out */);
+typedef bool (*SoftwareRenderTargetPresentCallback)(
+    void* /* user data */,
+    const FlutterSoftwareRenderTarget* /* render target */,
+    const FlutterRect* /* damage rects */,
+    size_t /* damage rects count */);
+typedef void (*SoftwareRenderTargetReleaseCallback)(
+    void* /* user data */,
+    const FlutterSoftwareRenderTarget* /* render target */);
+
 typedef struct {
   // The size of this struct. Must be sizeof(FlutterSoftwareRendererConfig).
   size_t struct_size;
@@ -181,7 +232,34 @@ typedef struct {
   // to the user. The pixel format of the buffer is the native 32-bit RGBA
   // format. The buffer is owned by the Flutter engine and must be copied in
   // this callback if needed.
+  //
+  // Not needed if the render target callbacks below are specified.
   SoftwareSurfacePresentCallback surface_present_callback;
+  // Optional. Specified together with |render_target_present_callback| and
+  // |render_target_release_callback|, this lets Flutter render straight into
+  // memory supplied by the embedder, such as the buffers of its own swapchain,
+  // so that frames need not be copied out of an engine owned buffer.
+  //
+  // Called on the raster thread before every frame. The embedder fills in a
+  // target of at least the given size, typically the next free buffer of its
+  // pool.
+  SoftwareRenderTargetAcquireCallback render_target_acquire_callback;
+  // Called on the raster thread once the frame has been rendered into the
+  // target acquired for it, which the embedder may then display. The damage
+  // rects give the parts of the frame that differ from the frame presented
+  // before it, in pixels. There are none if the frames are identical. The
+  // damage is not relative to what the target held before, so an embedder that
+  // cycles through several targets must account for their age itself.
+  //
+  // Flutter does not access the target once this returns, even if it returns
+  // false, so the embedder may hand it out again right away.
+  SoftwareRenderTargetPresentCallback render_target_present_callback;
+  // Called on the raster thread with a target that was acquired for a frame
+  // but will not be presented after all, e.g. because the frame was dropped,
+  // the target was too small, or the engine is shutting down. Flutter does not
+  // access the target once this returns, so the embedder may hand it out
+  // again.
+  SoftwareRenderTargetReleaseCallback render_target_release_callback;
 } FlutterSoftwareRendererConfig;
 
 typedef struct {
@@ -313,13 +391,6 @@ typedef void (*FlutterDataCallback)(const uint8_t* /* data */,
                                     size_t /* size */,
                                     void* /* user data */);
 
-typedef struct {
-  double left;
-  double top;
-  double right;
-  double bottom;
-} FlutterRect;
-
 typedef struct _FlutterTaskRunner* FlutterTaskRunner;
 
 typedef struct {
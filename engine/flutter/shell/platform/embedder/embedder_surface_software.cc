@@ -14,13 +14,19 @@ EmbedderSurfaceSoftware::EmbedderSurfaceSoftware(
     std::unique_ptr<EmbedderExternalViewEmbedder> external_view_embedder)
     : software_dispatch_table_(software_dispatch_table),
       external_view_embedder_(std::move(external_view_embedder)) {
-  if (!software_dispatch_table_.software_present_backing_store) {
+  if (!software_dispatch_table_.software_present_backing_store &&
+      !RendersIntoTargets()) {
     return;
   }
   valid_ = true;
 }
 
-EmbedderSurfaceSoftware::~EmbedderSurfaceSoftware() = default;
+EmbedderSurfaceSoftware::~EmbedderSurfaceSoftware() {
+  // A frame that was still being rendered at teardown is never presented.
+  if (RendersIntoTargets()) {
+    ReleaseRenderTarget();
+  }
+}
 
 // |EmbedderSurface|
 bool EmbedderSurfaceSoftware::IsValid() const {
@@ -57,6 +63,10 @@ sk_sp<SkSurface> EmbedderSurfaceSoftware::AcquireBackingStore(
     return nullptr;
   }
 
+  if (RendersIntoTargets()) {
+    return AcquireRenderTarget(size);
+  }
+
   if (sk_surface_ != nullptr &&
       SkISize::Make(sk_surface_->width(), sk_surface_->height()) == size) {
     // The old and new surface sizes are the same. Nothing to do here.
@@ -86,9 +96,16 @@ bool EmbedderSurfaceSoftware::PresentBackingStore(
   SkPixmap pixmap;
   if (!backing_store->peekPixels(&pixmap)) {
     FML_LOG(ERROR) << "Could not peek the pixels of the backing store.";
+    if (RendersIntoTargets()) {
+      ReleaseRenderTarget();
+    }
     return false;
   }
 
+  if (RendersIntoTargets()) {
+    return PresentRenderTarget(pixmap);
+  }
+
   // Some basic sanity checking.
   uint64_t expected_pixmap_data_size = pixmap.width() * pixmap.height() * 4;
 
@@ -106,9 +123,99 @@ bool EmbedderSurfaceSoftware::PresentBackingStore(
   );
 }
 
+// |GPUSurfaceSoftwareDelegate|
+void EmbedderSurfaceSoftware::DiscardBackingStore(
+    sk_sp<SkSurface> backing_store) {
+  if (RendersIntoTargets() && backing_store == sk_surface_) {
+    ReleaseRenderTarget();
+  }
+}
+
 // |GPUSurfaceSoftwareDelegate|
 ExternalViewEmbedder* EmbedderSurfaceSoftware::GetExternalViewEmbedder() {
   return external_view_embedder_.get();
 }
 
+bool EmbedderSurfaceSoftware::RendersIntoTargets() const {
+  return software_dispatch_table_.acquire_render_target &&
+         software_dispatch_table_.present_render_target &&
+         software_dispatch_table_.release_render_target;
+}
+
+sk_sp<SkSurface> EmbedderSurfaceSoftware::AcquireRenderTarget(
+    const SkISize& size) {
+  // The previous frame was dropped before it could be presented.
+  ReleaseRenderTarget();
+
+  if (!software_dispatch_table_.acquire_render_target(size,
+                                                      &acquired_target_)) {
+    FML_LOG(ERROR) << "The embedder could not supply a render target.";
+    acquired_target_ = {};
+    return nullptr;
+  }
+  has_acquired_target_ = true;
+
+  SkImageInfo info = SkImageInfo::Make(size.fWidth, size.fHeight,
+                                       acquired_target_.color_type,
+                                       kPremul_SkAlphaType,
+                                       SkColorSpace::MakeSRGB());
+  if (acquired_target_.allocation == nullptr ||
+      acquired_target_.row_bytes < info.minRowBytes() ||
+      acquired_target_.height < static_cast<size_t>(size.fHeight)) {
+    FML_LOG(ERROR) << "The embedder supplied render target is too small.";
+    ReleaseRenderTarget();
+    return nullptr;
+  }
+
+  // The surface only wraps the target, so this is cheap even though the
+  // embedder may hand out a different buffer every frame.
+  sk_surface_ = SkSurface::MakeRasterDirect(info, acquired_target_.allocation,
+                                            acquired_target_.row_bytes);
+  if (sk_surface_ == nullptr) {
+    FML_LOG(ERROR) << "Could not wrap the embedder supplied render target.";
+    ReleaseRenderTarget();
+    return nullptr;
+  }
+
+  return sk_surface_;
+}
+
+bool EmbedderSurfaceSoftware::PresentRenderTarget(const SkPixmap& frame) {
+  if (!has_acquired_target_) {
+    FML_LOG(ERROR) << "Presenting a frame without a render target.";
+    return false;
+  }
+
+  // Only the frame being presented is read: the embedder may reuse the
+  // targets of earlier frames as soon as it has displayed them.
+  const SkIRect damage = GPUSurfaceSoftware::ComputeFrameDamage(
+      frame, presented_row_hashes_, &row_hashes_);
+
+  // The surface must not outlive the embedder's hold on the target.
+  sk_surface_ = nullptr;
+
+  // Presenting hands the target back to the embedder, even if it fails.
+  const RenderTarget target = acquired_target_;
+  has_acquired_target_ = false;
+  acquired_target_ = {};
+  if (!software_dispatch_table_.present_render_target(target, damage)) {
+    presented_row_hashes_.clear();
+    return false;
+  }
+
+  presented_row_hashes_.swap(row_hashes_);
+  return true;
+}
+
+void EmbedderSurfaceSoftware::ReleaseRenderTarget() {
+  sk_surface_ = nullptr;
+  if (!has_acquired_target_) {
+    return;
+  }
+  const RenderTarget target = acquired_target_;
+  has_acquired_target_ = false;
+  acquired_target_ = {};
+  software_dispatch_table_.release_render_target(target);
+}
+
 }  // namespace flutter
@@ -5,8 +5,12 @@
 #ifndef FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SURFACE_SOFTWARE_H_
 #define FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SURFACE_SOFTWARE_H_
 
+#include <cstdint>
+#include <vector>
+
 #include "flutter/fml/macros.h"
 #include "flutter/shell/gpu/gpu_surface_software.h"
+#include "flutter/shell/platform/embedder/embedder.h"
 #include "flutter/shell/platform/embedder/embedder_external_view_embedder.h"
 #include "flutter/shell/platform/embedder/embedder_surface.h"
 
@@ -15,9 +19,30 @@ namespace flutter {
 class EmbedderSurfaceSoftware final : public EmbedderSurface,
                                       public GPUSurfaceSoftwareDelegate {
  public:
+  struct RenderTarget {
+    void* allocation = nullptr;
+    size_t row_bytes = 0;
+    size_t height = 0;
+    // The format as the embedder specified it, which is handed back to it on
+    // present. |color_type| cannot tell native 32-bit from the explicit
+    // format it maps to.
+    FlutterSoftwarePixelFormat pixel_format =
+        kFlutterSoftwarePixelFormatNative32;
+    SkColorType color_type = kUnknown_SkColorType;
+    void* user_data = nullptr;
+  };
+
   struct SoftwareDispatchTable {
     std::function<bool(const void* allocation, size_t row_bytes, size_t height)>
-        software_present_backing_store;  // required
+        software_present_backing_store;  // required unless the render target
+                                         // callbacks are specified
+    std::function<bool(const SkISize& size, RenderTarget* target)>
+        acquire_render_target;  // optional
+    std::function<bool(const RenderTarget& target, const SkIRect& damage)>
+        present_render_target;  // optional
+    std::function<void(const RenderTarget& target)>
+        release_render_target;  // required with the other render target
+                                // callbacks
   };
 
   EmbedderSurfaceSoftware(
@@ -30,6 +55,14 @@ class EmbedderSurfaceSoftware final : public EmbedderSurface,
   bool valid_ = false;
   SoftwareDispatchTable software_dispatch_table_;
   sk_sp<SkSurface> sk_surface_;
+  // The target the frame being rendered renders into, if any, until it is
+  // presented or released.
+  bool has_acquired_target_ = false;
+  RenderTarget acquired_target_;
+  // The row hashes of the frame presented last, and scratch space for those of
+  // the frame being presented.
+  std::vector<uint64_t> presented_row_hashes_;
+  std::vector<uint64_t> row_hashes_;
   std::unique_ptr<EmbedderExternalViewEmbedder> external_view_embedder_;
 
   // |EmbedderSurface|
@@ -47,9 +80,20 @@ class EmbedderSurfaceSoftware final : public EmbedderSurface,
   // |GPUSurfaceSoftwareDelegate|
   bool PresentBackingStore(sk_sp<SkSurface> backing_store) override;
 
+  // |GPUSurfaceSoftwareDelegate|
+  void DiscardBackingStore(sk_sp<SkSurface> backing_store) override;
+
   // |GPUSurfaceSoftwareDelegate|
   ExternalViewEmbedder* GetExternalViewEmbedder() override;
 
+  bool RendersIntoTargets() const;
+
+  sk_sp<SkSurface> AcquireRenderTarget(const SkISize& size);
+
+  bool PresentRenderTarget(const SkPixmap& frame);
+
+  void ReleaseRenderTarget();
+
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderSurfaceSoftware);
 };
 
@@ -70,6 +70,28 @@ void EmbedderConfigBuilder::SetSoftwareRendererConfig() {
   renderer_config_.software = software_renderer_config_;
 }
 
+void EmbedderConfigBuilder::SetSoftwareRenderTargetConfig() {
+  software_renderer_config_.surface_present_callback = nullptr;
+  software_renderer_config_.render_target_acquire_callback =
+      [](void* context, size_t width, size_t height,
+         FlutterSoftwareRenderTarget* target) -> bool {
+    return reinterpret_cast<EmbedderTestContext*>(context)
+        ->SoftwareRenderTargetAcquire(width, height, target);
+  };
+  software_renderer_config_.render_target_present_callback =
+      [](void* context, const FlutterSoftwareRenderTarget* target,
+         const FlutterRect* damage, size_t damage_count) -> bool {
+    return reinterpret_cast<EmbedderTestContext*>(context)
+        ->SoftwareRenderTargetPresent(target, damage, damage_count);
+  };
+  software_renderer_config_.render_target_release_callback =
+      [](void* context, const FlutterSoftwareRenderTarget* target) {
+        reinterpret_cast<EmbedderTestContext*>(context)
+            ->SoftwareRenderTargetRelease(target);
+      };
+  SetSoftwareRendererConfig();
+}
+
 void EmbedderConfigBuilder::SetOpenGLRendererConfig() {
   renderer_config_.type = FlutterRendererType::kOpenGL;
   renderer_config_.open_gl = opengl_renderer_config_;
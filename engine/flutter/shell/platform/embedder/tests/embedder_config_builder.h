@@ -45,6 +45,11 @@ class EmbedderConfigBuilder {
 
   void SetSoftwareRendererConfig();
 
+  // Renders into the targets supplied by the callbacks set with
+  // EmbedderTestContext::SetSoftwareRenderTargetCallbacks, instead of
+  // presenting an engine owned buffer.
+  void SetSoftwareRenderTargetConfig();
+
   void SetOpenGLRendererConfig();
 
   void SetAssetsPath();
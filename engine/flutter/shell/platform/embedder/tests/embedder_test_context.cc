@@ -106,6 +106,41 @@ void EmbedderTestContext::PlatformMessageCallback(
   }
 }
 
+void EmbedderTestContext::SetSoftwareRenderTargetCallbacks(
+    SoftwareRenderTargetAcquireCallback acquire,
+    SoftwareRenderTargetPresentCallback present,
+    SoftwareRenderTargetReleaseCallback release) {
+  software_render_target_acquire_callback_ = acquire;
+  software_render_target_present_callback_ = present;
+  software_render_target_release_callback_ = release;
+}
+
+bool EmbedderTestContext::SoftwareRenderTargetAcquire(
+    size_t width,
+    size_t height,
+    FlutterSoftwareRenderTarget* target) {
+  FML_CHECK(software_render_target_acquire_callback_)
+      << "Software render target callbacks must be set.";
+  return software_render_target_acquire_callback_(width, height, target);
+}
+
+bool EmbedderTestContext::SoftwareRenderTargetPresent(
+    const FlutterSoftwareRenderTarget* target,
+    const FlutterRect* damage,
+    size_t damage_count) {
+  FML_CHECK(software_render_target_present_callback_)
+      << "Software render target callbacks must be set.";
+  return software_render_target_present_callback_(target, damage,
+                                                  damage_count);
+}
+
+void EmbedderTestContext::SoftwareRenderTargetRelease(
+    const FlutterSoftwareRenderTarget* target) {
+  FML_CHECK(software_render_target_release_callback_)
+      << "Software render target callbacks must be set.";
+  software_render_target_release_callback_(target);
+}
+
 FlutterUpdateSemanticsNodeCallback
 EmbedderTestContext::GetUpdateSemanticsNodeCallbackHook() {
   return [](const FlutterSemanticsNode* semantics_node, void* user_data) {
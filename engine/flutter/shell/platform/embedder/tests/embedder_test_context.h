@@ -25,6 +25,16 @@ namespace testing {
 using SemanticsNodeCallback = std::function<void(const FlutterSemanticsNode*)>;
 using SemanticsActionCallback =
     std::function<void(const FlutterSemanticsCustomAction*)>;
+using SoftwareRenderTargetAcquireCallback =
+    std::function<bool(size_t width,
+                       size_t height,
+                       FlutterSoftwareRenderTarget* target)>;
+using SoftwareRenderTargetPresentCallback =
+    std::function<bool(const FlutterSoftwareRenderTarget* target,
+                       const FlutterRect* damage,
+                       size_t damage_count)>;
+using SoftwareRenderTargetReleaseCallback =
+    std::function<void(const FlutterSoftwareRenderTarget* target)>;
 
 class EmbedderTestContext {
  public:
@@ -54,6 +64,11 @@ class EmbedderTestContext {
   void SetPlatformMessageCallback(
       std::function<void(const FlutterPlatformMessage*)> callback);
 
+  void SetSoftwareRenderTargetCallbacks(
+      SoftwareRenderTargetAcquireCallback acquire,
+      SoftwareRenderTargetPresentCallback present,
+      SoftwareRenderTargetReleaseCallback release);
+
   void SetupCompositor();
 
   EmbedderTestCompositor& GetCompositor();
@@ -78,6 +93,9 @@ class EmbedderTestContext {
   std::unique_ptr<TestGLSurface> gl_surface_;
   std::unique_ptr<EmbedderTestCompositor> compositor_;
   NextSceneCallback next_scene_callback_;
+  SoftwareRenderTargetAcquireCallback software_render_target_acquire_callback_;
+  SoftwareRenderTargetPresentCallback software_render_target_present_callback_;
+  SoftwareRenderTargetReleaseCallback software_render_target_release_callback_;
 
   static VoidCallback GetIsolateCreateCallbackHook();
 
@@ -107,6 +125,16 @@ class EmbedderTestContext {
 
   void PlatformMessageCallback(const FlutterPlatformMessage* message);
 
+  bool SoftwareRenderTargetAcquire(size_t width,
+                                   size_t height,
+                                   FlutterSoftwareRenderTarget* target);
+
+  bool SoftwareRenderTargetPresent(const FlutterSoftwareRenderTarget* target,
+                                   const FlutterRect* damage,
+                                   size_t damage_count);
+
+  void SoftwareRenderTargetRelease(const FlutterSoftwareRenderTarget* target);
+
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderTestContext);
 };
 
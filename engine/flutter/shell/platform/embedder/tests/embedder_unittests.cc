@@ -4,7 +4,9 @@
 
 #define FML_USED_ON_EMBEDDER
 
+#include <atomic>
 #include <string>
+#include <vector>
 
 #include "embedder.h"
 #include "flutter/fml/file.h"
@@ -15,10 +17,12 @@
 #include "flutter/fml/synchronization/waitable_event.h"
 #include "flutter/fml/thread.h"
 #include "flutter/runtime/dart_vm.h"
+#include "flutter/shell/platform/embedder/embedder_surface_software.h"
 #include "flutter/shell/platform/embedder/tests/embedder_assertions.h"
 #include "flutter/shell/platform/embedder/tests/embedder_config_builder.h"
 #include "flutter/shell/platform/embedder/tests/embedder_test.h"
 #include "flutter/testing/testing.h"
+#include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkSurface.h"
 #include "third_party/tonic/converter/dart_converter.h"
 
@@ -806,6 +810,237 @@ TEST_F(EmbedderTest, CompositorMustBeAbleToRenderToSoftwareBuffer) {
   latch.Wait();
 }
 
+//------------------------------------------------------------------------------
+/// Software embedders that supply render targets must get frames rendered
+/// straight into them, handed back on present as they were supplied, along
+/// with the damage.
+///
+TEST_F(EmbedderTest, SoftwareRenderTargetsAreAcquiredAndPresentedWithDamage) {
+  auto& context = GetEmbedderContext();
+
+  const size_t kWidth = 800;
+  const size_t kHeight = 600;
+  const uint32_t kUntouched = 0xDEADBEEF;
+  std::vector<uint32_t> buffer(kWidth * kHeight, kUntouched);
+  int baton = 0;
+
+  size_t acquired_width = 0;
+  size_t acquired_height = 0;
+  FlutterSoftwareRenderTarget presented = {};
+  std::vector<FlutterRect> damage;
+  uint32_t presented_first_pixel = kUntouched;
+  std::atomic<bool> presented_once(false);
+
+  fml::AutoResetWaitableEvent latch;
+  context.SetSoftwareRenderTargetCallbacks(
+      [&](size_t width, size_t height, FlutterSoftwareRenderTarget* target) {
+        acquired_width = width;
+        acquired_height = height;
+        target->allocation = buffer.data();
+        target->row_bytes = kWidth * sizeof(uint32_t);
+        target->height = kHeight;
+        target->pixel_format = kFlutterSoftwarePixelFormatNative32;
+        target->user_data = &baton;
+        return true;
+      },
+      [&](const FlutterSoftwareRenderTarget* target,
+          const FlutterRect* damage_rects, size_t damage_count) {
+        // Only the first frame is checked.
+        if (presented_once.exchange(true)) {
+          return true;
+        }
+        presented = *target;
+        damage.assign(damage_rects, damage_rects + damage_count);
+        presented_first_pixel = buffer[0];
+        latch.Signal();
+        return true;
+      },
+      [](const FlutterSoftwareRenderTarget* target) {});
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRenderTargetConfig();
+  builder.SetDartEntrypoint("can_composite_platform_views");
+  context.AddNativeCallback(
+      "SignalNativeTest",
+      CREATE_NATIVE_ENTRY([](Dart_NativeArguments args) {}));
+
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  // Send a window metrics events so frames may be scheduled.
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = kWidth;
+  event.height = kHeight;
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+
+  latch.Wait();
+
+  ASSERT_EQ(acquired_width, kWidth);
+  ASSERT_EQ(acquired_height, kHeight);
+
+  // The target comes back as supplied. In particular, native 32-bit must not
+  // turn into the explicit format it maps to.
+  ASSERT_EQ(presented.allocation, buffer.data());
+  ASSERT_EQ(presented.row_bytes, kWidth * sizeof(uint32_t));
+  ASSERT_EQ(presented.height, kHeight);
+  ASSERT_EQ(presented.pixel_format, kFlutterSoftwarePixelFormatNative32);
+  ASSERT_EQ(presented.user_data, &baton);
+
+  // The frame was rendered into the target, and there is no earlier frame for
+  // it to be compared against.
+  ASSERT_NE(presented_first_pixel, kUntouched);
+  ASSERT_EQ(damage.size(), 1u);
+  ASSERT_EQ(damage[0].left, 0.0);
+  ASSERT_EQ(damage[0].top, 0.0);
+  ASSERT_EQ(damage[0].right, static_cast<double>(kWidth));
+  ASSERT_EQ(damage[0].bottom, static_cast<double>(kHeight));
+}
+
+//------------------------------------------------------------------------------
+/// A software surface rendering into a pool of embedder supplied targets, for
+/// tests that need control over each frame. Frames are rendered and dropped
+/// directly, without an engine.
+///
+class SoftwareRenderTargetPool {
+ public:
+  using RenderTarget = EmbedderSurfaceSoftware::RenderTarget;
+
+  static constexpr int kWidth = 100;
+  static constexpr int kHeight = 100;
+
+  explicit SoftwareRenderTargetPool(size_t target_count)
+      : buffers_(target_count,
+                 std::vector<uint32_t>(kWidth * kHeight, 0xDEADBEEF)) {
+    EmbedderSurfaceSoftware::SoftwareDispatchTable dispatch_table = {
+        nullptr,  // software_present_backing_store
+        [this](const SkISize& size, RenderTarget* target) {
+          auto& buffer = buffers_[next_buffer_++ % buffers_.size()];
+          target->allocation = buffer.data();
+          target->row_bytes = row_bytes_;
+          target->height = kHeight;
+          target->pixel_format = kFlutterSoftwarePixelFormatNative32;
+          target->color_type = kN32_SkColorType;
+          acquired_.push_back(buffer.data());
+          return true;
+        },
+        [this](const RenderTarget& target, const SkIRect& damage) {
+          presented_.push_back(target.allocation);
+          damage_.push_back(damage);
+          return true;
+        },
+        [this](const RenderTarget& target) {
+          released_.push_back(target.allocation);
+        },
+    };
+    embedder_surface_ = std::make_unique<EmbedderSurfaceSoftware>(
+        dispatch_table, nullptr);
+    surface_ = embedder_surface_->CreateGPUSurface();
+  }
+
+  Surface* GetSurface() { return surface_.get(); }
+
+  // Tears the surface down the way the rasterizer does.
+  void Teardown() {
+    surface_ = nullptr;
+    embedder_surface_ = nullptr;
+  }
+
+  // Makes the targets handed out from now on too small for a frame.
+  void SetRowBytes(size_t row_bytes) { row_bytes_ = row_bytes; }
+
+  // Renders a white frame with a black band across |band| rows, if any.
+  bool RenderFrame(const SkIRect& band) {
+    auto frame = surface_->AcquireFrame(SkISize::Make(kWidth, kHeight));
+    if (!frame) {
+      return false;
+    }
+    DrawFrame(frame.get(), band);
+    return frame->Submit();
+  }
+
+  static void DrawFrame(SurfaceFrame* frame, const SkIRect& band) {
+    SkCanvas* canvas = frame->SkiaCanvas();
+    canvas->clear(SK_ColorWHITE);
+    SkPaint paint;
+    paint.setColor(SK_ColorBLACK);
+    canvas->drawIRect(band, paint);
+  }
+
+  const std::vector<void*>& acquired() const { return acquired_; }
+  const std::vector<void*>& presented() const { return presented_; }
+  const std::vector<void*>& released() const { return released_; }
+  const std::vector<SkIRect>& damage() const { return damage_; }
+
+ private:
+  std::vector<std::vector<uint32_t>> buffers_;
+  size_t next_buffer_ = 0;
+  size_t row_bytes_ = kWidth * sizeof(uint32_t);
+  std::vector<void*> acquired_;
+  std::vector<void*> presented_;
+  std::vector<void*> released_;
+  std::vector<SkIRect> damage_;
+  std::unique_ptr<EmbedderSurface> embedder_surface_;
+  std::unique_ptr<Surface> surface_;
+};
+
+TEST(EmbedderSurfaceSoftwareTest, ReportsDamageSincePreviousFrame) {
+  SoftwareRenderTargetPool pool(2);
+  const int kWidth = SoftwareRenderTargetPool::kWidth;
+  const int kHeight = SoftwareRenderTargetPool::kHeight;
+
+  ASSERT_TRUE(pool.RenderFrame(SkIRect::MakeEmpty()));
+  const SkIRect band = SkIRect::MakeLTRB(20, 40, 30, 60);
+  ASSERT_TRUE(pool.RenderFrame(band));
+  ASSERT_TRUE(pool.RenderFrame(band));
+
+  ASSERT_EQ(pool.presented().size(), 3u);
+  ASSERT_NE(pool.presented()[0], pool.presented()[1]);
+  ASSERT_EQ(pool.presented()[0], pool.presented()[2]);
+
+  // Nothing to compare the first frame against.
+  ASSERT_EQ(pool.damage()[0], SkIRect::MakeWH(kWidth, kHeight));
+  // Only the rows of the band changed, across the full width.
+  ASSERT_EQ(pool.damage()[1], SkIRect::MakeLTRB(0, 40, kWidth, 60));
+  // The third frame is the same as the second one, even though the target it
+  // was rendered into last held the first one.
+  ASSERT_TRUE(pool.damage()[2].isEmpty());
+  ASSERT_TRUE(pool.released().empty());
+}
+
+TEST(EmbedderSurfaceSoftwareTest, ReleasesRenderTargetsThatAreNotPresented) {
+  SoftwareRenderTargetPool pool(3);
+
+  // A dropped frame hands its target back.
+  {
+    auto frame = pool.GetSurface()->AcquireFrame(SkISize::Make(
+        SoftwareRenderTargetPool::kWidth, SoftwareRenderTargetPool::kHeight));
+    ASSERT_NE(frame, nullptr);
+  }
+  ASSERT_EQ(pool.released().size(), 1u);
+  ASSERT_EQ(pool.released()[0], pool.acquired()[0]);
+
+  // So does a frame the target is too small for.
+  pool.SetRowBytes(SoftwareRenderTargetPool::kWidth);
+  ASSERT_FALSE(pool.RenderFrame(SkIRect::MakeEmpty()));
+  ASSERT_EQ(pool.released().size(), 2u);
+  ASSERT_EQ(pool.released()[1], pool.acquired()[1]);
+
+  // And a frame that is still being rendered at teardown.
+  pool.SetRowBytes(SoftwareRenderTargetPool::kWidth * sizeof(uint32_t));
+  auto frame = pool.GetSurface()->AcquireFrame(SkISize::Make(
+      SoftwareRenderTargetPool::kWidth, SoftwareRenderTargetPool::kHeight));
+  ASSERT_NE(frame, nullptr);
+  pool.Teardown();
+  frame = nullptr;
+  ASSERT_EQ(pool.released().size(), 3u);
+  ASSERT_EQ(pool.released()[2], pool.acquired()[2]);
+
+  ASSERT_EQ(pool.acquired().size(), 3u);
+  ASSERT_TRUE(pool.presented().empty());
+}
+
 static sk_sp<SkSurface> CreateRenderSurface(const FlutterLayer& layer,
                                             GrContext* context) {
   const auto image_info =
@@ -0,0 +1,139 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/ohos/ohos_software_presenter.h"
+
+#include <cstring>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+#include "flutter/shell/gpu/gpu_surface_software.h"
+#include "third_party/skia/include/core/SkColorSpace.h"
+
+namespace flutter {
+
+OhosSoftwarePresenter::OhosSoftwarePresenter(std::unique_ptr<OhosBufferProducer> producer,
+                                             SkColorType color_type,
+                                             SkAlphaType alpha_type)
+    : producer_(std::move(producer)), color_type_(color_type), alpha_type_(alpha_type)
+{
+    FML_DCHECK(producer_);
+}
+
+OhosSoftwarePresenter::~OhosSoftwarePresenter()
+{
+    if (acquired_ != nullptr) {
+        producer_->CancelBuffer(acquired_->buffer);
+    }
+}
+
+sk_sp<SkSurface> OhosSoftwarePresenter::AcquireBackingStore(const SkISize& size)
+{
+    TRACE_EVENT0("flutter", "OhosSoftwarePresenter::AcquireBackingStore");
+    if (acquired_ != nullptr) {
+        // The previous frame was never presented.
+        producer_->CancelBuffer(acquired_->buffer);
+        acquired_ = nullptr;
+    }
+
+    frame_++;
+    if (size != size_) {
+        surfaces_.clear();
+        size_ = size;
+        flushed_row_hashes_.clear();
+    } else {
+        PruneBuffers();
+    }
+
+    OhosBufferProducer::Buffer buffer;
+    if (!producer_->RequestBuffer(size, &buffer)) {
+        FML_LOG(ERROR) << "Could not request a buffer to render into.";
+        return nullptr;
+    }
+    if (buffer.pixels == nullptr || buffer.size.width() < size.width() ||
+        buffer.size.height() < size.height()) {
+        FML_LOG(ERROR) << "The requested buffer cannot hold the frame.";
+        producer_->CancelBuffer(buffer);
+        return nullptr;
+    }
+
+    auto it = surfaces_.find(buffer.id);
+    if (it != surfaces_.end() && (it->second.buffer.pixels != buffer.pixels ||
+                                  it->second.buffer.row_bytes != buffer.row_bytes ||
+                                  it->second.buffer.size != buffer.size)) {
+        // The queue reallocated the buffer.
+        surfaces_.erase(it);
+        it = surfaces_.end();
+    }
+
+    if (it == surfaces_.end()) {
+        // Any part of the buffer beyond the frame still ends up on screen.
+        // Clear it once, rather than leave garbage there.
+        memset(buffer.pixels, 0, buffer.row_bytes * buffer.size.height());
+
+        SkImageInfo image_info = SkImageInfo::Make(size.width(), size.height(), color_type_,
+                                                   alpha_type_, SkColorSpace::MakeSRGB());
+        auto surface = SkSurface::MakeRasterDirect(image_info, buffer.pixels, buffer.row_bytes);
+        if (surface == nullptr) {
+            FML_LOG(ERROR) << "Could not wrap the requested buffer in a surface.";
+            producer_->CancelBuffer(buffer);
+            return nullptr;
+        }
+        it = surfaces_.emplace(buffer.id, BufferSurface{buffer, std::move(surface)}).first;
+    }
+
+    acquired_ = &it->second;
+    acquired_->frame = frame_;
+    return acquired_->surface;
+}
+
+size_t OhosSoftwarePresenter::GetBufferCount() const
+{
+    return surfaces_.size();
+}
+
+void OhosSoftwarePresenter::PruneBuffers()
+{
+    for (auto it = surfaces_.begin(); it != surfaces_.end();) {
+        if (frame_ - it->second.frame > kMaxBufferAge) {
+            it = surfaces_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool OhosSoftwarePresenter::PresentBackingStore(sk_sp<SkSurface> backing_store)
+{
+    TRACE_EVENT0("flutter", "OhosSoftwarePresenter::PresentBackingStore");
+    if (acquired_ == nullptr || backing_store != acquired_->surface) {
+        FML_LOG(ERROR) << "Presenting a backing store that was not acquired.";
+        return false;
+    }
+    const OhosBufferProducer::Buffer buffer = acquired_->buffer;
+    acquired_ = nullptr;
+
+    SkIRect damage = SkIRect::MakeSize(size_);
+    SkPixmap frame;
+    if (backing_store->peekPixels(&frame)) {
+        damage = GPUSurfaceSoftware::ComputeFrameDamage(frame, flushed_row_hashes_, &row_hashes_);
+    } else {
+        row_hashes_.clear();
+    }
+    if (damage.isEmpty()) {
+        // Nothing changed since the last frame.
+        producer_->CancelBuffer(buffer);
+        return true;
+    }
+
+    if (!producer_->FlushBuffer(buffer, damage)) {
+        FML_LOG(ERROR) << "Could not flush the rendered buffer.";
+        flushed_row_hashes_.clear();
+        return false;
+    }
+    flushed_row_hashes_.swap(row_hashes_);
+    return true;
+}
+
+}  // namespace flutter
@@ -0,0 +1,111 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_OHOS_OHOS_SOFTWARE_PRESENTER_H_
+#define FLUTTER_SHELL_PLATFORM_OHOS_OHOS_SOFTWARE_PRESENTER_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkRect.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+
+// The producer side of the buffer queue a software surface presents through.
+// On OHOS this is the window's OHOS::Surface. Keeping it behind this interface
+// lets OhosSoftwarePresenter run against a mock queue on other platforms.
+class OhosBufferProducer {
+public:
+    struct Buffer {
+        // Identifies the buffer for as long as it is part of the queue.
+        uint32_t id = 0;
+        void* pixels = nullptr;
+        size_t row_bytes = 0;
+        // May be larger than requested, e.g. when the width has to be aligned.
+        SkISize size = SkISize::MakeEmpty();
+    };
+
+    virtual ~OhosBufferProducer() = default;
+
+    // Dequeues a buffer of at least |size| pixels that the CPU can write to.
+    // The buffer may hold any frame presented earlier, or garbage.
+    virtual bool RequestBuffer(const SkISize& size, Buffer* buffer) = 0;
+
+    // Queues |buffer| for display. Only |damage| differs from the buffer
+    // flushed before it.
+    virtual bool FlushBuffer(const Buffer& buffer, const SkIRect& damage) = 0;
+
+    // Returns |buffer| to the queue without displaying it.
+    virtual void CancelBuffer(const Buffer& buffer) = 0;
+};
+
+// Renders software frames straight into the buffers of the queue, instead of
+// into a private surface whose pixels are then copied into a buffer.
+//
+// The presenter tracks the age of each buffer of the queue, and forgets the
+// ones the queue stops handing out, e.g. after it reallocated them. Each frame
+// is damaged only in the rows whose hashes differ from those of the frame
+// flushed before it, so no buffer but the one being presented is read. A frame
+// that is identical to the previous one is not queued at all.
+class OhosSoftwarePresenter {
+public:
+    OhosSoftwarePresenter(std::unique_ptr<OhosBufferProducer> producer,
+                          SkColorType color_type,
+                          SkAlphaType alpha_type);
+
+    ~OhosSoftwarePresenter();
+
+    // Dequeues a buffer and returns a surface of |size| that renders into it.
+    sk_sp<SkSurface> AcquireBackingStore(const SkISize& size);
+
+    // Queues the buffer |backing_store| renders into.
+    bool PresentBackingStore(sk_sp<SkSurface> backing_store);
+
+    // The number of buffers of the queue the presenter keeps surfaces for.
+    size_t GetBufferCount() const;
+
+    // Buffers the queue has not handed out for this many frames are forgotten.
+    // Deeper than the queues OHOS windows use.
+    static constexpr uint64_t kMaxBufferAge = 8;
+
+private:
+    struct BufferSurface {
+        OhosBufferProducer::Buffer buffer;
+        sk_sp<SkSurface> surface;
+        // The frame last rendered into the buffer.
+        uint64_t frame = 0;
+    };
+
+    const std::unique_ptr<OhosBufferProducer> producer_;
+    const SkColorType color_type_;
+    const SkAlphaType alpha_type_;
+
+    // Surfaces over the buffers in the queue, by buffer id, all of size_.
+    std::map<uint32_t, BufferSurface> surfaces_;
+    SkISize size_ = SkISize::MakeEmpty();
+
+    // The number of frames acquired so far.
+    uint64_t frame_ = 0;
+
+    // The buffer dequeued for the frame being rendered.
+    BufferSurface* acquired_ = nullptr;
+
+    // The row hashes of the frame flushed last, or empty if there is no frame
+    // of size_ on screen. |row_hashes_| holds those of the frame being
+    // presented (see GPUSurfaceSoftware::ComputeFrameDamage).
+    std::vector<uint64_t> flushed_row_hashes_;
+    std::vector<uint64_t> row_hashes_;
+
+    void PruneBuffers();
+
+    FML_DISALLOW_COPY_AND_ASSIGN(OhosSoftwarePresenter);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_PLATFORM_OHOS_OHOS_SOFTWARE_PRESENTER_H_
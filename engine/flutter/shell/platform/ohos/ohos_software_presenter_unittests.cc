@@ -0,0 +1,202 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <vector>
+
+#include "flutter/shell/platform/ohos/ohos_software_presenter.h"
+#include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+
+namespace flutter {
+namespace testing {
+
+// A queue of heap allocated buffers, handed out round robin like a
+// BufferQueue with free buffers.
+class MockBufferProducer final : public OhosBufferProducer {
+public:
+    struct Flush {
+        uint32_t id;
+        SkIRect damage;
+    };
+
+    explicit MockBufferProducer(size_t queue_size) : memory_(queue_size) {}
+
+    bool RequestBuffer(const SkISize& size, Buffer* buffer) override
+    {
+        const uint32_t index = next_++ % memory_.size();
+        // Pad the width, like the OHOS queue does.
+        const int width = (size.width() + 15) / 16 * 16;
+        const size_t row_bytes = width * sizeof(uint32_t);
+        auto& memory = memory_[index];
+        if (memory.size() != row_bytes * size.height()) {
+            memory.assign(row_bytes * size.height(), 0xAB);
+        }
+        buffer->id = id_base_ + index;
+        buffer->pixels = memory.data();
+        buffer->row_bytes = row_bytes;
+        buffer->size = SkISize::Make(width, size.height());
+        return true;
+    }
+
+    bool FlushBuffer(const Buffer& buffer, const SkIRect& damage) override
+    {
+        flushes.push_back({buffer.id, damage});
+        return true;
+    }
+
+    void CancelBuffer(const Buffer& buffer) override
+    {
+        cancels++;
+    }
+
+    // Replaces every buffer of the queue with a new one.
+    void Reallocate()
+    {
+        id_base_ += memory_.size();
+        for (auto& memory : memory_) {
+            std::vector<uint8_t>().swap(memory);
+        }
+    }
+
+    const uint32_t* Pixels(uint32_t id) const
+    {
+        return reinterpret_cast<const uint32_t*>(memory_[id - id_base_].data());
+    }
+
+    std::vector<Flush> flushes;
+    int cancels = 0;
+
+private:
+    std::vector<std::vector<uint8_t>> memory_;
+    uint32_t next_ = 0;
+    uint32_t id_base_ = 0;
+};
+
+class OhosSoftwarePresenterTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        CreatePresenter(5);
+    }
+
+    void CreatePresenter(size_t queue_size)
+    {
+        auto producer = std::make_unique<MockBufferProducer>(queue_size);
+        producer_ = producer.get();
+        presenter_ = std::make_unique<OhosSoftwarePresenter>(
+            std::move(producer), kRGBA_8888_SkColorType, kPremul_SkAlphaType);
+    }
+
+    // Draws a frame filled with |background|, with |band| filled with |color|.
+    bool DrawFrame(const SkISize& size, SkColor background, const SkIRect& band, SkColor color)
+    {
+        auto surface = presenter_->AcquireBackingStore(size);
+        if (surface == nullptr) {
+            return false;
+        }
+        SkCanvas* canvas = surface->getCanvas();
+        canvas->clear(background);
+        SkPaint paint;
+        paint.setColor(color);
+        canvas->drawIRect(band, paint);
+        return presenter_->PresentBackingStore(surface);
+    }
+
+    MockBufferProducer* producer_ = nullptr;
+    std::unique_ptr<OhosSoftwarePresenter> presenter_;
+};
+
+TEST_F(OhosSoftwarePresenterTest, RendersIntoTheBuffer)
+{
+    const SkISize size = SkISize::Make(20, 10);
+    ASSERT_TRUE(DrawFrame(size, SK_ColorRED, SkIRect::MakeEmpty(), SK_ColorRED));
+
+    ASSERT_EQ(producer_->flushes.size(), 1u);
+    EXPECT_EQ(producer_->flushes[0].damage, SkIRect::MakeSize(size));
+
+    // The padding past the frame is cleared, and red is 0xFF0000FF in RGBA.
+    const uint32_t* pixels = producer_->Pixels(producer_->flushes[0].id);
+    const int stride = 32;
+    for (int y = 0; y < size.height(); y++) {
+        for (int x = 0; x < stride; x++) {
+            EXPECT_EQ(pixels[y * stride + x], x < size.width() ? 0xFF0000FFu : 0u);
+        }
+    }
+}
+
+TEST_F(OhosSoftwarePresenterTest, DamagesOnlyTheChangedRows)
+{
+    const SkISize size = SkISize::Make(20, 10);
+    ASSERT_TRUE(DrawFrame(size, SK_ColorWHITE, SkIRect::MakeLTRB(0, 2, 5, 4), SK_ColorBLUE));
+    ASSERT_TRUE(DrawFrame(size, SK_ColorWHITE, SkIRect::MakeLTRB(3, 6, 8, 7), SK_ColorBLUE));
+
+    ASSERT_EQ(producer_->flushes.size(), 2u);
+    EXPECT_NE(producer_->flushes[0].id, producer_->flushes[1].id);
+    EXPECT_EQ(producer_->flushes[1].damage, SkIRect::MakeLTRB(0, 2, size.width(), 7));
+}
+
+TEST_F(OhosSoftwarePresenterTest, DamagesOnlyTheChangedRowsOfASingleBuffer)
+{
+    CreatePresenter(1);
+    const SkISize size = SkISize::Make(20, 10);
+    ASSERT_TRUE(DrawFrame(size, SK_ColorWHITE, SkIRect::MakeLTRB(0, 2, 5, 4), SK_ColorBLUE));
+    ASSERT_TRUE(DrawFrame(size, SK_ColorWHITE, SkIRect::MakeLTRB(3, 6, 8, 7), SK_ColorBLUE));
+
+    ASSERT_EQ(producer_->flushes.size(), 2u);
+    EXPECT_EQ(producer_->flushes[0].id, producer_->flushes[1].id);
+    EXPECT_EQ(producer_->flushes[1].damage, SkIRect::MakeLTRB(0, 2, size.width(), 7));
+}
+
+TEST_F(OhosSoftwarePresenterTest, ForgetsBuffersAfterTheQueueReallocates)
+{
+    const SkISize size = SkISize::Make(20, 10);
+    for (int i = 0; i < 5; i++) {
+        ASSERT_TRUE(DrawFrame(size, SK_ColorWHITE, SkIRect::MakeXYWH(i, 0, 1, 1), SK_ColorBLUE));
+    }
+    EXPECT_EQ(presenter_->GetBufferCount(), 5u);
+
+    producer_->Reallocate();
+    for (uint64_t i = 0; i <= OhosSoftwarePresenter::kMaxBufferAge; i++) {
+        ASSERT_TRUE(DrawFrame(size, SK_ColorWHITE, SkIRect::MakeXYWH(i, 1, 1, 1), SK_ColorBLUE));
+    }
+    EXPECT_EQ(presenter_->GetBufferCount(), 5u);
+
+    // The new buffers are cleared past the frame too, and still only damaged
+    // where the frame changed.
+    const MockBufferProducer::Flush& last = producer_->flushes.back();
+    EXPECT_EQ(last.damage, SkIRect::MakeLTRB(0, 1, size.width(), 2));
+    EXPECT_EQ(producer_->Pixels(last.id)[31], 0u);
+}
+
+TEST_F(OhosSoftwarePresenterTest, SkipsUnchangedFrames)
+{
+    const SkISize size = SkISize::Make(20, 10);
+    ASSERT_TRUE(DrawFrame(size, SK_ColorWHITE, SkIRect::MakeLTRB(0, 2, 5, 4), SK_ColorBLUE));
+    ASSERT_TRUE(DrawFrame(size, SK_ColorWHITE, SkIRect::MakeLTRB(0, 2, 5, 4), SK_ColorBLUE));
+
+    EXPECT_EQ(producer_->flushes.size(), 1u);
+    EXPECT_EQ(producer_->cancels, 1);
+}
+
+TEST_F(OhosSoftwarePresenterTest, DamagesEverythingAfterAResize)
+{
+    ASSERT_TRUE(DrawFrame(SkISize::Make(20, 10), SK_ColorWHITE, SkIRect::MakeEmpty(), 0));
+    ASSERT_TRUE(DrawFrame(SkISize::Make(30, 12), SK_ColorWHITE, SkIRect::MakeEmpty(), 0));
+
+    ASSERT_EQ(producer_->flushes.size(), 2u);
+    EXPECT_EQ(producer_->flushes[1].damage, SkIRect::MakeWH(30, 12));
+}
+
+TEST_F(OhosSoftwarePresenterTest, RejectsForeignBackingStores)
+{
+    auto surface = presenter_->AcquireBackingStore(SkISize::Make(20, 10));
+    ASSERT_NE(surface, nullptr);
+    auto other = SkSurface::MakeRasterN32Premul(20, 10);
+    EXPECT_FALSE(presenter_->PresentBackingStore(other));
+    EXPECT_TRUE(presenter_->PresentBackingStore(surface));
+}
+
+}  // namespace testing
+}  // namespace flutter
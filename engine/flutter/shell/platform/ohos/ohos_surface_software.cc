@@ -6,8 +6,8 @@
 
 #include "flutter/shell/platform/ohos/ohos_surface_software.h"
 
+#include <map>
 #include <memory>
-#include <vector>
 
 #include "flutter/fml/logging.h"
 #include "flutter/fml/trace_event.h"
@@ -37,6 +37,74 @@ bool GetSkColorType(int32_t buffer_format,
     return false;
 }
 
+// Requests CPU writable buffers from the window's surface.
+class SurfaceBufferProducer final : public OhosBufferProducer {
+public:
+    explicit SurfaceBufferProducer(const OHOS::sptr<OHOS::Surface>& surface) : surface_(surface) {}
+
+    bool RequestBuffer(const SkISize& size, Buffer* buffer) override
+    {
+        const int32_t pixelBase = 16;
+        OHOS::BufferRequestConfig requestConfig = {
+            .width = (size.width() + pixelBase - 1) / pixelBase * pixelBase,
+            .height = size.height(),
+            .strideAlignment = 0x8,
+            .format = PIXEL_FMT_RGBA_8888,
+            .usage = HBM_USE_CPU_READ | HBM_USE_CPU_WRITE | HBM_USE_MEM_DMA,
+            .timeout = 0,
+        };
+        OHOS::sptr<OHOS::SurfaceBuffer> surfaceBuffer;
+        int32_t releaseFence;
+        OHOS::SurfaceError ret = surface_->RequestBuffer(surfaceBuffer, releaseFence, requestConfig);
+        if (ret != OHOS::SURFACE_ERROR_OK || surfaceBuffer == nullptr || surfaceBuffer->GetSize() == 0) {
+            FML_LOG(ERROR) << "OhosSurfaceSoftware request surfaceBuffer fail";
+            return false;
+        }
+
+        buffer->id = surfaceBuffer->GetSeqNum();
+        buffer->pixels = surfaceBuffer->GetVirAddr();
+        buffer->row_bytes = surfaceBuffer->GetSize() / requestConfig.height;
+        buffer->size = SkISize::Make(requestConfig.width, requestConfig.height);
+        dequeued_[buffer->id] = surfaceBuffer;
+        return true;
+    }
+
+    bool FlushBuffer(const Buffer& buffer, const SkIRect& damage) override
+    {
+        auto it = dequeued_.find(buffer.id);
+        if (it == dequeued_.end()) {
+            return false;
+        }
+        OHOS::sptr<OHOS::SurfaceBuffer> surfaceBuffer = it->second;
+        dequeued_.erase(it);
+        OHOS::BufferFlushConfig flushConfig = {
+            .damage = {
+                .x = damage.x(),
+                .y = damage.y(),
+                .w = damage.width(),
+                .h = damage.height(),
+            },
+            .timestamp = 0
+        };
+        return surface_->FlushBuffer(surfaceBuffer, -1, flushConfig) == OHOS::SURFACE_ERROR_OK;
+    }
+
+    void CancelBuffer(const Buffer& buffer) override
+    {
+        auto it = dequeued_.find(buffer.id);
+        if (it != dequeued_.end()) {
+            surface_->CancelBuffer(it->second);
+            dequeued_.erase(it);
+        }
+    }
+
+private:
+    OHOS::sptr<OHOS::Surface> surface_;
+    // Only the buffers between RequestBuffer() and FlushBuffer() or
+    // CancelBuffer(). The queue owns the others, and may free them at any time.
+    std::map<uint32_t, OHOS::sptr<OHOS::SurfaceBuffer>> dequeued_;
+};
+
 }  // anonymous namespace
 
 OhosSurfaceSoftware::OhosSurfaceSoftware()
@@ -67,9 +135,7 @@ std::unique_ptr<Surface> OhosSurfaceSoftware::CreateGPUSurface()
 
 bool OhosSurfaceSoftware::OnScreenSurfaceResize(const SkISize& size)
 {
-    FML_LOG(INFO) << "OhosSurfaceSoftware::OnScreenSurfaceResize, software surface do noting";
-    requestConfig_.width = size.fWidth;
-    requestConfig_.height = size.fHeight;
+    // Buffers are requested at the size of each frame.
     return true;
 }
 
@@ -83,17 +149,13 @@ void OhosSurfaceSoftware::SetPlatformWindow(const OHOS::sptr<OHOS::Window> &wind
     surface_ = window->GetSurface();
     if (surface_ == nullptr) {
         FML_LOG(ERROR) << "OhosSurfaceSoftware::SetPlatformWindow, surface_ is nullptr";
+        presenter_ = nullptr;
         return;
     }
-    requestConfig_ = {
-        .width = surface_->GetDefaultWidth(),
-        .height = surface_->GetDefaultHeight(),
-        .strideAlignment = 0x8,
-        .format = PIXEL_FMT_RGBA_8888,
-        .usage = surface_->GetDefaultUsage(),
-    };
     // Set buffer size to 5 for enough buffer
     surface_->SetQueueSize(5);
+    presenter_ = std::make_unique<OhosSoftwarePresenter>(
+        std::make_unique<SurfaceBufferProducer>(surface_), target_color_type_, target_alpha_type_);
 }
 
 sk_sp<SkSurface> OhosSurfaceSoftware::AcquireBackingStore(
@@ -104,99 +166,23 @@ sk_sp<SkSurface> OhosSurfaceSoftware::AcquireBackingStore(
         return nullptr;
     }
 
-    if (sk_surface_ != nullptr && SkISize::Make(sk_surface_->width(), sk_surface_->height()) == size) {
-        // The old and new surface sizes are the same. Nothing to do here.
-        return sk_surface_;
+    if (presenter_ == nullptr) {
+        FML_LOG(ERROR) << "OhosSurfaceSoftware surface is nullptr";
+        return nullptr;
     }
 
-    SkImageInfo image_info = SkImageInfo::Make(
-        size.fWidth, size.fHeight, target_color_type_, target_alpha_type_, SkColorSpace::MakeSRGB());
-
-    sk_surface_ = SkSurface::MakeRaster(image_info);
-
-    return sk_surface_;
+    return presenter_->AcquireBackingStore(size);
 }
 
 bool OhosSurfaceSoftware::PresentBackingStore(
     sk_sp<SkSurface> backing_store)
 {
     TRACE_EVENT0("flutter", "OhosSurfaceSoftware::PresentBackingStore");
-    if (!IsValid() || backing_store == nullptr) {
+    if (!IsValid() || backing_store == nullptr || presenter_ == nullptr) {
         return false;
     }
 
-    FML_LOG(INFO) << "OhosSurfaceSoftware peek pixels";
-    SkPixmap pixmap;
-    if (!backing_store->peekPixels(&pixmap)) {
-        return false;
-    }
-
-    if (surface_ == nullptr) {
-        FML_LOG(ERROR) << "OhosSurfaceSoftware surface is nullptr";
-        return false;
-    }
-    int32_t pixelBase = 16;
-    int32_t convertWidth = requestConfig_.width % pixelBase == 0 ? requestConfig_.width
-        : (requestConfig_.width / pixelBase + 1) * pixelBase;
-    int32_t alignment = 8;
-    OHOS::BufferRequestConfig requestConfig = {
-        .width = convertWidth,
-        .height = requestConfig_.height,
-        .strideAlignment = alignment,
-        .format = PIXEL_FMT_RGBA_8888,
-        .usage = HBM_USE_CPU_READ | HBM_USE_CPU_WRITE | HBM_USE_MEM_DMA,
-        .timeout = 0,
-    };
-    OHOS::sptr<OHOS::SurfaceBuffer> surfaceBuffer;
-    int32_t releaseFence;
-
-    OHOS::SurfaceError ret = surface_->RequestBuffer(surfaceBuffer, releaseFence, requestConfig);
-    if (ret != OHOS::SURFACE_ERROR_OK || surfaceBuffer == nullptr || surfaceBuffer->GetSize() == 0) {
-        FML_LOG(ERROR) << "OhosSurfaceSoftware request surfaceBuffer fail";
-        return false;
-    }
-
-    SurfaceDrawBuffer(requestConfig, surfaceBuffer, pixmap);
-    SurfaceFlushBuffer(surfaceBuffer);
-
-    return true;
-}
-
-void OhosSurfaceSoftware::SurfaceDrawBuffer(
-    OHOS::BufferRequestConfig& requestConfig, OHOS::sptr<OHOS::SurfaceBuffer> surfaceBuffer, SkPixmap& pixmap)
-{
-    SkColorType color_type;
-    SkAlphaType alpha_type;
-    if (GetSkColorType(requestConfig.format, &color_type, &alpha_type)) {
-        SkImageInfo native_image_info = SkImageInfo::Make(
-            requestConfig.width, requestConfig.height, color_type, alpha_type);
-
-        std::unique_ptr<SkCanvas> canvas = SkCanvas::MakeRasterDirect(
-            native_image_info, surfaceBuffer->GetVirAddr(),
-            surfaceBuffer->GetSize() / requestConfig.height);
-
-        if (canvas) {
-            SkBitmap bitmap;
-            if (bitmap.installPixels(pixmap)) {
-                canvas->drawBitmapRect(bitmap, SkRect::MakeIWH(requestConfig.width, requestConfig.height), nullptr);
-            }
-        }
-    }
-}
-
-void OhosSurfaceSoftware::SurfaceFlushBuffer(OHOS::sptr<OHOS::SurfaceBuffer> surfaceBuffer)
-{
-    FML_LOG(INFO) << "OhosSurfaceSoftware flush buffer";
-    OHOS::BufferFlushConfig flushConfig = {
-        .damage = {
-            .x = 0,
-            .y = 0,
-            .w = requestConfig_.width,
-            .h = requestConfig_.height,
-        },
-        .timestamp = 0
-    };
-    surface_->FlushBuffer(surfaceBuffer, -1, flushConfig);
+    return presenter_->PresentBackingStore(std::move(backing_store));
 }
 
 ExternalViewEmbedder* OhosSurfaceSoftware::GetExternalViewEmbedder()
@@ -9,6 +9,7 @@
 
 #include "flutter/fml/macros.h"
 #include "flutter/shell/gpu/gpu_surface_software.h"
+#include "flutter/shell/platform/ohos/ohos_software_presenter.h"
 #include "flutter/shell/platform/ohos/ohos_surface.h"
 
 namespace flutter {
@@ -31,11 +32,6 @@ public:
 
     bool PresentBackingStore(sk_sp<SkSurface> backing_store) override;
 
-    void SurfaceDrawBuffer(
-        OHOS::BufferRequestConfig& requestConfig, OHOS::sptr<OHOS::SurfaceBuffer> surfaceBuffer, SkPixmap& pixmap);
-
-    void SurfaceFlushBuffer(OHOS::sptr<OHOS::SurfaceBuffer>);
-
     ExternalViewEmbedder* GetExternalViewEmbedder() override;
 
     // |OhosSurface|
@@ -48,13 +44,12 @@ public:
     virtual void TeardownOnScreenContext() override;
 
 private:
-    sk_sp<SkSurface> sk_surface_;
     SkColorType target_color_type_;
     SkAlphaType target_alpha_type_;
 
     OHOS::sptr<OHOS::Window> window_ = nullptr;
-    OHOS::BufferRequestConfig requestConfig_;
     OHOS::sptr<OHOS::Surface> surface_ = nullptr;
+    std::unique_ptr<OhosSoftwarePresenter> presenter_;
 
     FML_DISALLOW_COPY_AND_ASSIGN(OhosSurfaceSoftware);
 };
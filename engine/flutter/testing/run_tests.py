@@ -96,6 +96,9 @@ def RunCCTests(build_dir, filter):
 
   RunEngineExecutable(build_dir, 'ui_unittests', filter)
 
+  if IsLinux():
+    RunEngineExecutable(build_dir, 'ohos_unittests', filter)
+
   # These unit-tests are Objective-C and can only run on Darwin.
   if IsMac():
     RunEngineExecutable(build_dir, 'flutter_channels_unittests', filter)
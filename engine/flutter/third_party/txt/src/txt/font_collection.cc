@@ -105,8 +105,11 @@ size_t FontCollection::GetFontManagersCount() const {
 }
 
 void FontCollection::SetupDefaultFontManager() {
+  sk_sp<SkFontMgr> font_manager = default_font_manager_provider_
+                                      ? default_font_manager_provider_()
+                                      : GetDefaultFontManager();
   std::lock_guard<std::mutex> lock(fontManagerMutex_);
-  default_font_manager_ = GetDefaultFontManager();
+  default_font_manager_ = font_manager;
 }
 
 void FontCollection::SetDefaultFontManager(sk_sp<SkFontMgr> font_manager) {
@@ -114,6 +117,11 @@ void FontCollection::SetDefaultFontManager(sk_sp<SkFontMgr> font_manager) {
   default_font_manager_ = font_manager;
 }
 
+void FontCollection::SetDefaultFontManagerProvider(
+    FontManagerProvider provider) {
+  default_font_manager_provider_ = std::move(provider);
+}
+
 void FontCollection::SetAssetFontManager(sk_sp<SkFontMgr> font_manager) {
   asset_font_manager_ = font_manager;
 }
@@ -17,6 +17,7 @@
 #ifndef LIB_TXT_SRC_FONT_COLLECTION_H_
 #define LIB_TXT_SRC_FONT_COLLECTION_H_
 
+#include <functional>
 #include <memory>
 #include <set>
 #include <string>
@@ -47,6 +48,10 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
 
   void SetupDefaultFontManager();
   void SetDefaultFontManager(sk_sp<SkFontMgr> font_manager);
+  // Makes SetupDefaultFontManager(), which reloads the system fonts, take the
+  // default font manager from |provider| instead of creating its own.
+  using FontManagerProvider = std::function<sk_sp<SkFontMgr>()>;
+  void SetDefaultFontManagerProvider(FontManagerProvider provider);
   void SetAssetFontManager(sk_sp<SkFontMgr> font_manager);
   void SetDynamicFontManager(sk_sp<SkFontMgr> font_manager);
   void SetTestFontManager(sk_sp<SkFontMgr> font_manager);
@@ -104,6 +109,7 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
   };
 
   sk_sp<SkFontMgr> default_font_manager_;
+  FontManagerProvider default_font_manager_provider_;
   sk_sp<SkFontMgr> asset_font_manager_;
   sk_sp<SkFontMgr> dynamic_font_manager_;
   sk_sp<SkFontMgr> test_font_manager_;
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/codec/SkCodec.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkColorSpace.h"
+#include "include/core/SkData.h"
+#include "include/core/SkStream.h"
+#include "include/encode/SkPngEncoder.h"
+#include "include/utils/SkRandom.h"
+
+// Decodes a Display P3 png to sRGB N32 premul, exercising the row unpack, color transform
+// and premultiply of the decoder.  Unlike CodecBench, this needs no images directory.
+class CodecXformBench : public Benchmark {
+public:
+    explicit CodecXformBench(bool opaque)
+        : fOpaque(opaque)
+        , fName(SkStringPrintf("CodecXform_png_%s", opaque ? "RGB" : "RGBA")) {}
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        auto p3 = SkColorSpace::MakeRGB(SkNamedTransferFn::kSRGB, SkNamedGamut::kDCIP3);
+        SkBitmap src;
+        src.allocPixels(SkImageInfo::MakeN32(1024, 1024,
+                fOpaque ? kOpaque_SkAlphaType : kUnpremul_SkAlphaType, p3));
+        SkRandom rand;
+        for (int y = 0; y < src.height(); ++y)
+        for (int x = 0; x < src.width(); ++x) {
+            const U8CPU a = fOpaque ? 0xFF : rand.nextU() & 0xFF;
+            *src.getAddr32(x, y) = SkColorSetARGB(a, x >> 2, y >> 2, (x ^ y) & 0xFF);
+        }
+
+        // Favor decode speed over size, the filters and zlib are not what we're measuring.
+        SkPngEncoder::Options options;
+        options.fZLibLevel = 1;
+        SkDynamicMemoryWStream stream;
+        SkAssertResult(SkPngEncoder::Encode(&stream, src.pixmap(), options));
+        fData = stream.detachAsData();
+
+        fDst.allocPixels(SkImageInfo::MakeN32Premul(src.width(), src.height(),
+                                                    SkColorSpace::MakeSRGB()));
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops-- > 0) {
+            auto codec = SkCodec::MakeFromData(fData);
+            SkAssertResult(codec->getPixels(fDst.pixmap()) == SkCodec::kSuccess);
+        }
+    }
+
+private:
+    const bool     fOpaque;
+    const SkString fName;
+    sk_sp<SkData>  fData;
+    SkBitmap       fDst;
+};
+
+DEF_BENCH(return new CodecXformBench(true);)
+DEF_BENCH(return new CodecXformBench(false);)
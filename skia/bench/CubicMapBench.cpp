@@ -7,6 +7,10 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkCubicMap.h"
+#include "include/private/SkTo.h"
+#include "include/utils/SkRandom.h"
+
+#include <vector>
 
 class CubicMapBench : public Benchmark {
 public:
@@ -39,6 +43,59 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Many independent curves evaluated once each, as when ticking lots of eased animation
+// properties: individual computeYFromX() calls vs the batched ComputeYFromX().
+class CubicMapBatchBench : public Benchmark {
+public:
+    explicit CubicMapBatchBench(bool batched) : fBatched(batched) {}
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    const char* onGetName() override {
+        return fBatched ? "cubicmap_batch_1024" : "cubicmap_serial_1024";
+    }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        for (int i = 0; i < 1024; ++i) {
+            fCMaps.emplace_back(SkPoint{rand.nextF(), rand.nextF()},
+                                SkPoint{rand.nextF(), rand.nextF()});
+            fX.push_back(rand.nextF());
+        }
+        for (const auto& cmap : fCMaps) {
+            fMaps.push_back(&cmap);
+        }
+        fY.resize(fX.size());
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            if (fBatched) {
+                SkCubicMap::ComputeYFromX(fMaps.data(), fX.data(), fY.data(),
+                                          SkToInt(fMaps.size()));
+            } else {
+                for (size_t j = 0; j < fCMaps.size(); ++j) {
+                    fY[j] = fCMaps[j].computeYFromX(fX[j]);
+                }
+            }
+        }
+    }
+
+private:
+    const bool                     fBatched;
+    std::vector<SkCubicMap>        fCMaps;
+    std::vector<const SkCubicMap*> fMaps;
+    std::vector<float>             fX,
+                                   fY;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new CubicMapBatchBench(false); )
+DEF_BENCH( return new CubicMapBatchBench(true); )
+
 DEF_BENCH( return new CubicMapBench({1, 0}, {0,0}); )
 DEF_BENCH( return new CubicMapBench({1, 0}, {0,1}); )
 DEF_BENCH( return new CubicMapBench({1, 0}, {1,0}); )
@@ -308,6 +308,77 @@ DEF_BENCH( return new GradientBench(kConical_GradType, gGradData[3], false); )
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Fills a 4K target with a gently shaded multi-stop gradient, the kind UI themes are full of.
+// Without dithering, 8-bit raster targets look these colors up in a table; dithering keeps the
+// per pixel stop search, for comparison.
+class GradientFillBench : public Benchmark {
+public:
+    GradientFillBench(GradType gradType, bool dither)
+        : fGradType(gradType)
+        , fDither(dither) {
+        fName.printf("gradient_fill_4k_%s_8stops%s", gGrads[gradType].fName,
+                     dither ? "_dither" : "");
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kRaster_Backend;
+    }
+
+    SkIPoint onGetSize() override {
+        return SkIPoint::Make(kWidth, kHeight);
+    }
+
+    void onDelayedSetup() override {
+        static const SkColor kColors[] = {
+            0xFF3A5BA0, 0xFF4A6CB0, 0xFF5E7FC0, 0xFF7391CC,
+            0xFF88A2D4, 0xFF9DB3DC, 0xFFB3C4E4, 0xFFC8D5EC,
+        };
+        static const SkScalar kPos[] = {
+            0.0f, 0.1f, 0.25f, 0.4f, 0.6f, 0.75f, 0.9f, 1.0f,
+        };
+        const GradData data = { SK_ARRAY_COUNT(kColors), kColors, kPos, "" };
+        const SkPoint pts[2] = {
+            { 0, 0 },
+            { SkIntToScalar(kWidth), SkIntToScalar(kHeight) }
+        };
+
+        fPaint.setShader(gGrads[fGradType].fMaker(pts, data, SkTileMode::kClamp, 1.0f));
+        fPaint.setDither(fDither);
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        const SkRect r = SkRect::MakeIWH(kWidth, kHeight);
+        for (int i = 0; i < loops; i++) {
+            canvas->drawRect(r, fPaint);
+        }
+    }
+
+private:
+    static const int kWidth  = 3840;
+    static const int kHeight = 2160;
+
+    SkString       fName;
+    SkPaint        fPaint;
+    const GradType fGradType;
+    const bool     fDither;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new GradientFillBench(kLinear_GradType, false); )
+DEF_BENCH( return new GradientFillBench(kLinear_GradType, true); )
+DEF_BENCH( return new GradientFillBench(kRadial_GradType, false); )
+DEF_BENCH( return new GradientFillBench(kRadial_GradType, true); )
+DEF_BENCH( return new GradientFillBench(kConical_GradType, false); )
+DEF_BENCH( return new GradientFillBench(kConical_GradType, true); )
+
+///////////////////////////////////////////////////////////////////////////////
+
 class Gradient2Bench : public Benchmark {
     SkString fName;
     bool     fHasAlpha;
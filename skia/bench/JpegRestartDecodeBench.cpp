@@ -0,0 +1,73 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/codec/SkCodec.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkStream.h"
+#include "include/encode/SkJpegEncoder.h"
+#include "include/utils/SkRandom.h"
+
+// Decodes a 12 megapixel jpeg with a restart marker on every MCU row, serially (threads == 0)
+// or in stripes on a thread pool.
+class JpegRestartDecodeBench : public Benchmark {
+public:
+    explicit JpegRestartDecodeBench(int threads)
+        : fThreads(threads)
+        , fName(SkStringPrintf("JpegRestartDecode_12MP_%dthreads", threads)) {}
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkBitmap src;
+        src.allocN32Pixels(4000, 3000, true);
+        SkRandom rand;
+        for (int y = 0; y < src.height(); ++y)
+        for (int x = 0; x < src.width(); ++x) {
+            *src.getAddr32(x, y) = SkPreMultiplyARGB(0xFF, x >> 4, y >> 4,
+                                                     (x ^ y) + (rand.nextU() & 0x1F));
+        }
+
+        SkJpegEncoder::Options options;
+        options.fQuality     = 90;
+        options.fRestartRows = 1;
+        SkDynamicMemoryWStream stream;
+        SkAssertResult(SkJpegEncoder::Encode(&stream, src.pixmap(), options));
+        fData = stream.detachAsData();
+
+        fDst.allocN32Pixels(src.width(), src.height(), true);
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkCodec::Options options;
+        options.fExecutor = fExecutor.get();
+        while (loops-- > 0) {
+            auto codec = SkCodec::MakeFromData(fData);
+            SkAssertResult(codec->getPixels(fDst.info(), fDst.getPixels(), fDst.rowBytes(),
+                                            &options) == SkCodec::kSuccess);
+        }
+    }
+
+private:
+    const int                   fThreads;
+    const SkString              fName;
+    sk_sp<SkData>               fData;
+    SkBitmap                    fDst;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
+DEF_BENCH(return new JpegRestartDecodeBench(0);)
+DEF_BENCH(return new JpegRestartDecodeBench(4);)
+DEF_BENCH(return new JpegRestartDecodeBench(8);)
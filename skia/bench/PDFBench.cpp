@@ -75,6 +75,7 @@ DEF_BENCH(return new PDFScalarBench("PDFScalar_random", next_any);)
 
 #ifdef SK_SUPPORT_PDF
 
+#include "src/pdf/SkDeflate.h"
 #include "src/pdf/SkPDFBitmap.h"
 #include "src/pdf/SkPDFDocumentPriv.h"
 #include "src/pdf/SkPDFShader.h"
@@ -183,6 +184,49 @@ private:
     std::unique_ptr<SkStreamAsset> fAsset;
 };
 
+/** Test DEFLATE on a multi-megabyte page content stream (the 78k command stream
+    repeated), either serially or in parallel chunks on an executor. */
+class PDFDeflateBench : public Benchmark {
+public:
+    PDFDeflateBench(bool threaded) : fThreaded(threaded) {}
+
+protected:
+    const char* onGetName() override {
+        return fThreaded ? "PDFDeflate_5MB_threaded" : "PDFDeflate_5MB";
+    }
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+    void onDelayedSetup() override {
+        sk_sp<SkData> commands = GetResourceAsData("pdf_command_stream.txt");
+        if (!commands) {
+            return;
+        }
+        SkDynamicMemoryWStream content;
+        while (content.bytesWritten() < 5 * 1024 * 1024) {
+            content.write(commands->data(), commands->size());
+        }
+        fContent = content.detachAsData();
+        if (fThreaded) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool();
+        }
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        if (!fContent) { return; }
+        while (loops-- > 0) {
+            SkNullWStream wStream;
+            SkDeflateWStream deflateWStream(&wStream, -1, false, fExecutor.get());
+            deflateWStream.write(fContent->data(), fContent->size());
+            deflateWStream.finalize();
+        }
+    }
+
+private:
+    const bool fThreaded;
+    sk_sp<SkData> fContent;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
 struct PDFColorComponentBench : public Benchmark {
     bool isSuitableFor(Backend b) override {
         return b == kNonRendering_Backend;
@@ -305,6 +349,8 @@ struct PDFClipPathBenchmark : public Benchmark {
 DEF_BENCH(return new PDFImageBench;)
 DEF_BENCH(return new PDFJpegImageBench;)
 DEF_BENCH(return new PDFCompressionBench;)
+DEF_BENCH(return new PDFDeflateBench(false);)
+DEF_BENCH(return new PDFDeflateBench(true);)
 DEF_BENCH(return new PDFColorComponentBench;)
 DEF_BENCH(return new PDFShaderBench;)
 DEF_BENCH(return new WritePDFTextBenchmark;)
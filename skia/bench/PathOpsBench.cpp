@@ -12,6 +12,7 @@
 #include "include/pathops/SkPathOps.h"
 #include "include/private/SkTArray.h"
 #include "include/utils/SkRandom.h"
+#include "src/pathops/SkPathOpsCommon.h"
 
 class PathOpsBench : public Benchmark {
     SkString    fName;
@@ -80,6 +81,48 @@ private:
 };
 
 
+// Line-only inputs, as produced by clip and mask composition. Each input is run through Op()
+// (which takes the polygon path) and through the general curve engine, for comparison.
+class PathOpsPolygonBench : public Benchmark {
+    SkString    fName;
+    SkPath      fPath1, fPath2;
+    SkPathOp    fOp;
+    bool        fGeneral;
+
+public:
+    PathOpsPolygonBench(const char suffix[], const SkPath& path1, const SkPath& path2,
+                        SkPathOp op, bool general)
+        : fPath1(path1), fPath2(path2), fOp(op), fGeneral(general) {
+        fName.printf("pathops_polygon_%s%s", suffix, general ? "_general" : "");
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; i++) {
+            for (int j = 0; j < 100; ++j) {
+                SkPath result;
+                if (fGeneral) {
+                    OpDebug(fPath1, fPath2, fOp, &result
+                            SkDEBUGPARAMS(true) SkDEBUGPARAMS(nullptr));
+                } else {
+                    Op(fPath1, fPath2, fOp, &result);
+                }
+            }
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
 DEF_BENCH( return new PathOpsBench("sect", kIntersect_SkPathOp); )
 DEF_BENCH( return new PathOpsBench("join", kUnion_SkPathOp); )
 
@@ -96,3 +139,57 @@ static SkPath makerects() {
 }
 
 DEF_BENCH( return new PathOpsSimplifyBench("rects", makerects()); )
+
+static SkPath makerect(const SkRect& r) {
+    SkPath path;
+    path.addRect(r);
+    return path;
+}
+
+static SkPath makeflatrrect(const SkRect& r, SkScalar radius) {
+    // Flattening a rounded rect: the corners become 8 segment polylines.
+    SkPath path;
+    const SkVector corners[] = {
+        { r.fRight - radius, r.fTop + radius }, { r.fRight - radius, r.fBottom - radius },
+        { r.fLeft + radius, r.fBottom - radius }, { r.fLeft + radius, r.fTop + radius },
+    };
+    for (int c = 0; c < 4; ++c) {
+        for (int i = 0; i <= 8; ++i) {
+            const SkScalar angle = (c - 1 + i / 8.f) * SK_ScalarPI / 2;
+            const SkPoint pt = corners[c] + SkVector::Make(SkScalarCos(angle) * radius,
+                                                           SkScalarSin(angle) * radius);
+            if (c == 0 && i == 0) {
+                path.moveTo(pt);
+            } else {
+                path.lineTo(pt);
+            }
+        }
+    }
+    path.close();
+    return path;
+}
+
+static SkPath makepolygon(int count) {
+    SkRandom rand;
+    SkPath path;
+    path.moveTo(rand.nextRangeF(0, 100), rand.nextRangeF(0, 100));
+    for (int i = 1; i < count; ++i) {
+        path.lineTo(rand.nextRangeF(0, 100), rand.nextRangeF(0, 100));
+    }
+    path.close();
+    return path;
+}
+
+#define DEF_POLYGON_BENCH(suffix, path1, path2, op)                                 \
+    DEF_BENCH( return new PathOpsPolygonBench(suffix, path1, path2, op, false); ) \
+    DEF_BENCH( return new PathOpsPolygonBench(suffix, path1, path2, op, true); )
+
+DEF_POLYGON_BENCH("rects_join", makerect({0, 0, 60, 40}), makerect({30, 20, 90, 60}),
+                  kUnion_SkPathOp)
+DEF_POLYGON_BENCH("rects_diff", makerect({0, 0, 60, 40}), makerect({30, 20, 90, 60}),
+                  kDifference_SkPathOp)
+DEF_POLYGON_BENCH("rrect_sect", makeflatrrect({0, 0, 60, 40}, 10), makerect({30, 20, 90, 60}),
+                  kIntersect_SkPathOp)
+DEF_POLYGON_BENCH("rrects_join", makeflatrrect({0, 0, 60, 40}, 10),
+                  makeflatrrect({30, 20, 90, 60}, 15), kUnion_SkPathOp)
+DEF_POLYGON_BENCH("poly_xor", makepolygon(12), makerect({25, 25, 75, 75}), kXOR_SkPathOp)
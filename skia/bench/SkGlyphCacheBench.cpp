@@ -10,6 +10,7 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkFontMgr.h"
 #include "include/core/SkGraphics.h"
 #include "include/core/SkTypeface.h"
 #include "src/core/SkStrikeCache.h"
@@ -110,7 +111,63 @@ private:
     SkString fName;
 };
 
+// Generates glyphs concurrently from a cold cache, spreading a fixed amount of work over
+// |faceCount| system typefaces, to measure scaler contention across threads.
+class SkGlyphGenerationMT : public Benchmark {
+public:
+    explicit SkGlyphGenerationMT(int faceCount) : fFaceCount(faceCount) { }
+
+protected:
+    const char* onGetName() override {
+        fName.printf("SkGlyphGenerationMT_%dfaces", fFaceCount);
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        // Unlike the portable test typefaces, system typefaces go through the platform scaler.
+        sk_sp<SkFontMgr> fontMgr = SkFontMgr::RefDefault();
+        for (int i = 0; i < fontMgr->countFamilies() && fTypefaces.count() < fFaceCount; ++i) {
+            sk_sp<SkFontStyleSet> styleSet(fontMgr->createStyleSet(i));
+            if (styleSet && styleSet->count() > 0) {
+                if (sk_sp<SkTypeface> typeface{styleSet->createTypeface(0)}) {
+                    fTypefaces.push_back(std::move(typeface));
+                }
+            }
+        }
+        if (fTypefaces.empty()) {
+            fTypefaces.push_back(SkTypeface::MakeDefault());
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int work = 0; work < loops; work++) {
+            SkGraphics::PurgeFontCache();
+            SkTaskGroup().batch(kTaskCount, [&](int taskIndex) {
+                SkFont font;
+                font.setEdging(SkFont::Edging::kAntiAlias);
+                font.setSubpixel(true);
+                font.setTypeface(fTypefaces[taskIndex % fTypefaces.count()]);
+                do_font_stuff(&font);
+            });
+        }
+    }
+
+private:
+    static constexpr int kTaskCount = 8;
+
+    typedef Benchmark INHERITED;
+    const int fFaceCount;
+    SkTArray<sk_sp<SkTypeface>> fTypefaces;
+    SkString fName;
+};
+
 DEF_BENCH( return new SkGlyphCacheBasic(256 * 1024); )
 DEF_BENCH( return new SkGlyphCacheBasic(32 * 1024 * 1024); )
 DEF_BENCH( return new SkGlyphCacheStressTest(256 * 1024); )
 DEF_BENCH( return new SkGlyphCacheStressTest(32 * 1024 * 1024); )
+DEF_BENCH( return new SkGlyphGenerationMT(1); )
+DEF_BENCH( return new SkGlyphGenerationMT(8); )
@@ -0,0 +1,258 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkData.h"
+#include "include/core/SkSurface.h"
+#include "include/private/SkTArray.h"
+#include "modules/skottie/include/Skottie.h"
+#include "modules/skottie/utils/SkottieUtils.h"
+#include "modules/sksg/include/SkSGInvalidationController.h"
+#include "src/core/SkOSFile.h"
+#include "src/utils/SkOSPath.h"
+#include "tools/ProcStats.h"
+#include "tools/flags/CommandLineFlags.h"
+
+#include <cmath>
+
+#if defined(SK_BUILD_FOR_ANDROID)
+static DEFINE_string(lotties, "/data/local/tmp/lotties",
+                     "Lottie files (or directories of .json files) for SkottieBench.");
+#else
+static DEFINE_string(lotties, "/tmp/lotties",
+                     "Lottie files (or directories of .json files) for SkottieBench.");
+#endif
+
+namespace {
+
+// Benches are registered statically, but the input set is only known after flag parsing:
+// we reserve a fixed number of slots, and unused slots are simply not suitable for any backend.
+static constexpr int kMaxLottieFiles = 32;
+
+const SkTArray<SkString>& lottie_files() {
+    static const SkTArray<SkString> gFiles = []() {
+        SkTArray<SkString> files;
+        for (int i = 0; i < FLAGS_lotties.count(); ++i) {
+            if (SkStrEndsWith(FLAGS_lotties[i], ".json")) {
+                files.push_back(SkString(FLAGS_lotties[i]));
+            } else {
+                SkOSFile::Iter it(FLAGS_lotties[i], ".json");
+                SkString path;
+                while (it.next(&path)) {
+                    files.push_back(SkOSPath::Join(FLAGS_lotties[i], path.c_str()));
+                }
+            }
+        }
+        if (files.count() > kMaxLottieFiles) {
+            SkDebugf("!! SkottieBench: only the first %d of %d animations will run.\n",
+                     kMaxLottieFiles, files.count());
+        }
+        return files;
+    }();
+
+    return gFiles;
+}
+
+// Measures the per-frame CPU cost (seek + raster) of a Lottie animation, played back at 60fps.
+//
+// In full mode, each frame is redrawn from scratch.  In damage mode, the animation renders into
+// a persistent surface and only repaints the invalidated regions (Animation::renderDamage).
+// In cached mode, frames are replayed from a raster skottie_utils::FrameCache.
+class SkottieBench : public Benchmark {
+public:
+    enum class Mode {
+        kFull,
+        kDamage,
+        kCached,
+    };
+
+    SkottieBench(int index, Mode mode)
+        : fIndex(index)
+        , fMode(mode) {
+        static constexpr const char* kModeNames[] = { "full", "damage", "cached" };
+        const auto* mode_name = kModeNames[static_cast<int>(fMode)];
+
+        if (fIndex < lottie_files().count()) {
+            fPath = lottie_files()[fIndex];
+            fName.printf("skottie_%s_%s", mode_name, SkOSPath::Basename(fPath.c_str()).c_str());
+        } else {
+            fName.printf("skottie_%s_%d", mode_name, fIndex);
+        }
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend && !fPath.isEmpty();
+    }
+
+    void onDelayedSetup() override {
+        fAnimation = skottie::Animation::MakeFromFile(fPath.c_str());
+        if (!fAnimation) {
+            SkDebugf("!! Could not load animation: %s\n", fPath.c_str());
+            return;
+        }
+
+        const auto size = fAnimation->size().toCeil();
+        fSurface = SkSurface::MakeRasterN32Premul(size.width(), size.height());
+        if (!fSurface) {
+            fAnimation = nullptr;
+            return;
+        }
+
+        fFrame = 0;
+        fAnimation->seek(0);
+        fAnimation->render(fSurface->getCanvas());
+
+        if (fMode == Mode::kCached) {
+            static constexpr size_t kCacheBudget = 64 * 1024 * 1024;
+            fCache = skottie_utils::FrameCache::Make(fAnimation,
+                                                     skottie_utils::FrameCache::Mode::kRaster,
+                                                     kCacheBudget, size);
+        }
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        if (fCache) {
+            const auto& stats = fCache->stats();
+            SkDebugf("%s: %zu hits, %zu misses, %zu frames cached (%zu bytes)\n",
+                     fName.c_str(), stats.fHits, stats.fMisses,
+                     stats.fFrameCount, stats.fBytesUsed);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        if (!fAnimation) {
+            return;
+        }
+
+        static constexpr double kFrameDuration = 1.0 / 60;
+        auto* canvas = fSurface->getCanvas();
+
+        for (int i = 0; i < loops; ++i) {
+            const auto t = std::fmod(++fFrame * kFrameDuration, fAnimation->duration());
+
+            switch (fMode) {
+            case Mode::kFull:
+                fAnimation->seekFrameTime(t);
+                canvas->clear(SK_ColorTRANSPARENT);
+                fAnimation->render(canvas);
+                break;
+            case Mode::kDamage: {
+                sksg::InvalidationController ic;
+                fAnimation->seekFrameTime(t, &ic);
+                fAnimation->renderDamage(canvas, ic);
+            } break;
+            case Mode::kCached:
+                canvas->clear(SK_ColorTRANSPARENT);
+                fCache->render(canvas, t);
+                break;
+            }
+        }
+    }
+
+private:
+    const int                                  fIndex;
+    const Mode                                 fMode;
+    SkString                                   fPath,
+                                               fName;
+    sk_sp<skottie::Animation>                  fAnimation;
+    sk_sp<SkSurface>                           fSurface;
+    std::unique_ptr<skottie_utils::FrameCache> fCache;
+    int                                        fFrame = 0;
+
+    using INHERITED = Benchmark;
+};
+
+// Measures animation load time, from either the JSON source or its precompiled binary form
+// (Animation::Builder::Precompile).
+//
+// Peak memory is reported once per bench, as the max RSS growth over the first load.  This is
+// only meaningful when running a single bench per process (e.g. --match skottie_load_skb_foo).
+class SkottieLoadBench : public Benchmark {
+public:
+    SkottieLoadBench(int index, bool precompiled)
+        : fPrecompiled(precompiled) {
+        const auto* prefix = fPrecompiled ? "skb" : "json";
+        if (index < lottie_files().count()) {
+            fPath = lottie_files()[index];
+            fName.printf("skottie_load_%s_%s", prefix, SkOSPath::Basename(fPath.c_str()).c_str());
+        } else {
+            fName.printf("skottie_load_%s_%d", prefix, index);
+        }
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend && !fPath.isEmpty();
+    }
+
+    void onDelayedSetup() override {
+        fData = SkData::MakeFromFileName(fPath.c_str());
+        if (fData && fPrecompiled) {
+            fData = skottie::Animation::Builder::Precompile(
+                        static_cast<const char*>(fData->data()), fData->size());
+        }
+        if (!fData) {
+            SkDebugf("!! Could not load animation: %s\n", fPath.c_str());
+            return;
+        }
+
+        const auto rss0 = sk_tools::getMaxResidentSetSizeMB();
+        skottie::Animation::Builder builder;
+        const auto anim = builder.make(static_cast<const char*>(fData->data()), fData->size());
+        const auto rss1 = sk_tools::getMaxResidentSetSizeMB();
+
+        if (anim) {
+            SkDebugf("%s: %zu bytes, parse %.2fms, scene %.2fms, peak RSS +%dMB\n",
+                     fName.c_str(), fData->size(), builder.getStats().fJsonParseTimeMS,
+                     builder.getStats().fSceneParseTimeMS, rss1 - rss0);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        if (!fData) {
+            return;
+        }
+
+        for (int i = 0; i < loops; ++i) {
+            skottie::Animation::Make(static_cast<const char*>(fData->data()), fData->size());
+        }
+    }
+
+private:
+    const bool        fPrecompiled;
+    SkString          fPath,
+                      fName;
+    sk_sp<SkData>     fData;
+
+    using INHERITED = Benchmark;
+};
+
+} // namespace
+
+#define DEF_SKOTTIE_BENCH(N)                              \
+    DEF_BENCH( return new SkottieBench(N, SkottieBench::Mode::kFull);   ) \
+    DEF_BENCH( return new SkottieBench(N, SkottieBench::Mode::kDamage); ) \
+    DEF_BENCH( return new SkottieBench(N, SkottieBench::Mode::kCached); ) \
+    DEF_BENCH( return new SkottieLoadBench(N, false);                   ) \
+    DEF_BENCH( return new SkottieLoadBench(N, true);                    )
+
+DEF_SKOTTIE_BENCH( 0) DEF_SKOTTIE_BENCH( 1) DEF_SKOTTIE_BENCH( 2) DEF_SKOTTIE_BENCH( 3)
+DEF_SKOTTIE_BENCH( 4) DEF_SKOTTIE_BENCH( 5) DEF_SKOTTIE_BENCH( 6) DEF_SKOTTIE_BENCH( 7)
+DEF_SKOTTIE_BENCH( 8) DEF_SKOTTIE_BENCH( 9) DEF_SKOTTIE_BENCH(10) DEF_SKOTTIE_BENCH(11)
+DEF_SKOTTIE_BENCH(12) DEF_SKOTTIE_BENCH(13) DEF_SKOTTIE_BENCH(14) DEF_SKOTTIE_BENCH(15)
+DEF_SKOTTIE_BENCH(16) DEF_SKOTTIE_BENCH(17) DEF_SKOTTIE_BENCH(18) DEF_SKOTTIE_BENCH(19)
+DEF_SKOTTIE_BENCH(20) DEF_SKOTTIE_BENCH(21) DEF_SKOTTIE_BENCH(22) DEF_SKOTTIE_BENCH(23)
+DEF_SKOTTIE_BENCH(24) DEF_SKOTTIE_BENCH(25) DEF_SKOTTIE_BENCH(26) DEF_SKOTTIE_BENCH(27)
+DEF_SKOTTIE_BENCH(28) DEF_SKOTTIE_BENCH(29) DEF_SKOTTIE_BENCH(30) DEF_SKOTTIE_BENCH(31)
+
+static_assert(kMaxLottieFiles == 32, "DEF_SKOTTIE_BENCH slot count mismatch");
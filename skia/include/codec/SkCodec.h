@@ -26,6 +26,7 @@
 
 class SkColorSpace;
 class SkData;
+class SkExecutor;
 class SkFrameHolder;
 class SkPngChunkReader;
 class SkSampler;
@@ -277,6 +278,8 @@ public:
             , fSubset(nullptr)
             , fFrameIndex(0)
             , fPriorFrame(kNoFrame)
+            , fExecutor(nullptr)
+            , fUseDecoderThreads(false)
         {}
 
         ZeroInitialized            fZeroInitialized;
@@ -320,6 +323,25 @@ public:
          *  If set to kNoFrame, the codec will decode any necessary required frame(s) first.
          */
         int                        fPriorFrame;
+
+        /**
+         *  If not NULL, getPixels() may split the decode into independent pieces and run
+         *  them on this executor.  getPixels() still blocks until the whole image has been
+         *  decoded, so this only helps if the executor has threads of its own.
+         *
+         *  Currently only used by JPEG images with restart markers, which are ignored by
+         *  scanline and incremental decodes.
+         */
+        SkExecutor*                fExecutor;
+
+        /**
+         *  If true, the underlying decoder may start threads of its own to speed up the
+         *  decode.  Unlike fExecutor, the threads are not under the client's control.
+         *
+         *  Currently only used by lossy WebP images (when libwebp is built with
+         *  WEBP_USE_THREAD), in getPixels() and incremental decodes alike.
+         */
+        bool                       fUseDecoderThreads;
     };
 
     /**
@@ -151,10 +151,13 @@ struct Metadata {
     /** Executor to handle threaded work within PDF Backend. If this is nullptr,
         then all work will be done serially on the main thread. To have worker
         threads assist with various tasks, set this to a valid SkExecutor
-        instance. Currently used for executing Deflate algorithm in parallel.
+        instance. Currently used for executing Deflate algorithm in parallel,
+        and for converting pages to PDF content while the caller draws the
+        next pages (pages are recorded, and converted in order; endPage()
+        blocks if several recorded pages are waiting).
 
-        If set, the PDF output will be non-reproducible in the order and
-        internal numbering of objects, but should render the same.
+        If set, the PDF output will be non-reproducible in the order of
+        objects, but should render the same.
 
         Experimental.
     */
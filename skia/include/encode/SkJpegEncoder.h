@@ -61,6 +61,13 @@ public:
          *  In the second case, the encoder supports linear or legacy blending.
          */
         AlphaOption fAlphaOption = AlphaOption::kIgnore;
+
+        /**
+         *  If positive, a restart marker is written every |fRestartRows| rows of MCUs.
+         *  This costs a few bytes per marker, but allows decoders (including SkCodec)
+         *  to decode horizontal stripes of the image in parallel.
+         */
+        int fRestartRows = 0;
     };
 
     /**
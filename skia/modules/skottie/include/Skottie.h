@@ -27,6 +27,7 @@ namespace skjson { class ObjectValue; }
 namespace sksg {
 
 class InvalidationController;
+class Profiler;
 class Scene;
 
 } // namespace sksg
@@ -123,7 +124,19 @@ public:
 
     class Builder final {
     public:
-        Builder();
+        enum Flags : uint32_t {
+            // Precomp layers are built on first activation (the first seek into their
+            // [in..out) range), instead of at load time.  The JSON DOM is retained for the
+            // lifetime of the animation.
+            kDeferPrecompLoading     = 0x01,
+            // In conjunction with kDeferPrecompLoading: deferred precomp layers are discarded
+            // when leaving their active range, and rebuilt on reactivation.  Property
+            // observers are notified again (with new handles) on every rebuild; handles from
+            // a previous build no longer affect the animation.
+            kReleaseInactivePrecomps = 0x02,
+        };
+
+        explicit Builder(uint32_t flags = 0);
         ~Builder();
 
         struct Stats {
@@ -171,17 +184,30 @@ public:
 
         /**
          * Animation factories.
+         *
+         * In addition to Lottie JSON, these accept precompiled animations (see Precompile()),
+         * which load faster and with less transient memory.
          */
         sk_sp<Animation> make(SkStream*);
         sk_sp<Animation> make(const char* data, size_t length);
         sk_sp<Animation> makeFromFile(const char path[]);
 
+        /**
+         * Converts Lottie JSON into a precompiled, position-independent binary form which can be
+         * passed to the factories above (and mmap-ed via makeFromFile()) in place of the JSON
+         * source, to skip text parsing at load time.
+         *
+         * @return the precompiled animation, or nullptr if the input is not valid JSON.
+         */
+        static sk_sp<SkData> Precompile(const char* data, size_t length);
+
     private:
         sk_sp<ResourceProvider> fResourceProvider;
         sk_sp<SkFontMgr>        fFontMgr;
         sk_sp<PropertyObserver> fPropertyObserver;
         sk_sp<Logger>           fLogger;
         sk_sp<MarkerObserver>   fMarkerObserver;
+        const uint32_t          fFlags;
         Stats                   fStats;
     };
 
@@ -214,6 +240,32 @@ public:
     void render(SkCanvas* canvas, const SkRect* dst = nullptr) const;
     void render(SkCanvas* canvas, const SkRect* dst, RenderFlags) const;
 
+    /**
+     * Incrementally draws the current animation frame, by only repainting the regions
+     * invalidated since the previous frame.
+     *
+     * The destination is expected to retain the previously rendered frame (e.g. a raster
+     * canvas or a cached SkSurface dedicated to this animation), drawn with the same canvas
+     * matrix and |dst| rect.  The damaged area is cleared to transparent and redrawn, while
+     * all other pixels are preserved.
+     *
+     * Typical usage:
+     *
+     *   sksg::InvalidationController ic;
+     *   animation->seek(t, &ic);
+     *   animation->renderDamage(canvas, ic);
+     *
+     * Note: the first frame (and any frame following a seek() without an invalidation
+     * controller) must be drawn using render().
+     *
+     * @param canvas   destination canvas, holding the previous frame
+     * @param ic       invalidation controller populated by seek()
+     * @param dst      optional destination rect
+     * @param flags    optional RenderFlags
+     */
+    void renderDamage(SkCanvas* canvas, const sksg::InvalidationController& ic,
+                      const SkRect* dst = nullptr, RenderFlags = 0) const;
+
     /**
      * Updates the animation state for |t|.
      *
@@ -233,6 +285,19 @@ public:
      */
     SkScalar duration() const { return fDuration; }
 
+    /**
+     * Returns the animation frame rate (frames per second).
+     */
+    SkScalar fps() const { return fFPS; }
+
+    /**
+     * Attaches a scene graph profiler (not owned), which collects per-node revalidation and
+     * per-animator tick costs for subsequent seek()/render() calls.  Pass nullptr to detach.
+     *
+     * See SkSGProfiler.h for the collected data and reporting.
+     */
+    void setProfiler(sksg::Profiler*);
+
     const SkString& version() const { return fVersion;   }
     const SkSize&      size() const { return fSize;      }
 
@@ -242,14 +307,16 @@ private:
     };
 
     Animation(std::unique_ptr<sksg::Scene>, SkString ver, const SkSize& size,
-              SkScalar inPoint, SkScalar outPoint, SkScalar duration, uint32_t flags = 0);
+              SkScalar inPoint, SkScalar outPoint, SkScalar duration, SkScalar fps,
+              uint32_t flags = 0);
 
     std::unique_ptr<sksg::Scene> fScene;
     const SkString               fVersion;
     const SkSize                 fSize;
     const SkScalar               fInPoint,
                                  fOutPoint,
-                                 fDuration;
+                                 fDuration,
+                                 fFPS;
     const uint32_t               fFlags;
 
     typedef SkNVRefCnt<Animation> INHERITED;
@@ -96,6 +96,9 @@ using TransformPropertyHandle = PropertyHandle<TransformPropertyValue, Transform
  * When registered with an animation builder, PropertyObserver receives notifications for
  * various properties of layer and shape nodes.  The |node_name| argument corresponds to the
  * name ("nm") node property.
+ *
+ * Properties of deferred precomp layers (see Animation::Builder::kDeferPrecompLoading) are
+ * reported when the precomp is first activated, and reported again each time it is rebuilt.
  */
 class SK_API PropertyObserver : public SkRefCnt {
 public:
@@ -439,7 +439,7 @@ sk_sp<sksg::RenderNode> AnimationBuilder::attachLayer(const skjson::ObjectValue*
     }
 
     AutoScope ascope(this, std::move(layer_transform_rec.fTransformScope));
-    const auto transform_animator_count = fCurrentAnimatorScope->size();
+    auto transform_animator_count = fCurrentAnimatorScope->size();
 
     const auto is_hidden = ParseDefault<bool>((*jlayer)["hd"], false) || type == kCameraLayerType;
     const auto& build_info = gLayerBuildInfo[is_hidden ? kNullLayerType : type];
@@ -447,6 +447,12 @@ sk_sp<sksg::RenderNode> AnimationBuilder::attachLayer(const skjson::ObjectValue*
     // Build the layer content fragment.
     auto layer = (this->*(build_info.fBuilder))(*jlayer, &layer_info);
 
+    // Persistent content animators are dispatched along with the transform animators.
+    fCurrentAnimatorScope->insert(fCurrentAnimatorScope->begin() + transform_animator_count,
+                                  layer_info.fPersistentAnimators.begin(),
+                                  layer_info.fPersistentAnimators.end());
+    transform_animator_count += layer_info.fPersistentAnimators.size();
+
     // Clip layers with explicit dimensions.
     float w = 0, h = 0;
     if (Parse<float>((*jlayer)["w"], &w) && Parse<float>((*jlayer)["h"], &h)) {
@@ -489,7 +495,8 @@ sk_sp<sksg::RenderNode> AnimationBuilder::attachLayer(const skjson::ObjectValue*
 
     const auto has_animators = !fCurrentAnimatorScope->empty();
 
-    sk_sp<sksg::Animator> controller = sk_make_sp<LayerController>(ascope.release(),
+    auto layer_animators = ascope.release(&transform_animator_count);
+    sk_sp<sksg::Animator> controller = sk_make_sp<LayerController>(std::move(layer_animators),
                                                                    layer,
                                                                    transform_animator_count,
                                                                    layer_info.fInPoint,
@@ -13,6 +13,7 @@
 #include "include/core/SkImage.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPoint.h"
+#include "include/core/SkRegion.h"
 #include "include/core/SkStream.h"
 #include "include/private/SkTArray.h"
 #include "include/private/SkTo.h"
@@ -29,6 +30,7 @@
 #include "modules/sksg/include/SkSGRenderEffect.h"
 #include "modules/sksg/include/SkSGScene.h"
 #include "modules/sksg/include/SkSGTransform.h"
+#include "src/core/SkMakeUnique.h"
 #include "src/core/SkTraceEvent.h"
 
 #include <chrono>
@@ -270,7 +272,8 @@ AnimationBuilder::AnimationBuilder(sk_sp<ResourceProvider> rp, sk_sp<SkFontMgr>
                                    sk_sp<PropertyObserver> pobserver, sk_sp<Logger> logger,
                                    sk_sp<MarkerObserver> mobserver,
                                    Animation::Builder::Stats* stats,
-                                   const SkSize& size, float duration, float framerate)
+                                   const SkSize& size, float duration, float framerate,
+                                   uint32_t flags)
     : fResourceProvider(std::move(rp))
     , fLazyFontMgr(std::move(fontmgr))
     , fPropertyObserver(std::move(pobserver))
@@ -280,8 +283,11 @@ AnimationBuilder::AnimationBuilder(sk_sp<ResourceProvider> rp, sk_sp<SkFontMgr>
     , fSize(size)
     , fDuration(duration)
     , fFrameRate(framerate)
+    , fFlags(flags)
     , fHasNontrivialBlending(false) {}
 
+AnimationBuilder::~AnimationBuilder() = default;
+
 std::unique_ptr<sksg::Scene> AnimationBuilder::parse(const skjson::ObjectValue& jroot) {
     this->dispatchMarkers(jroot["markers"]);
 
@@ -293,6 +299,7 @@ std::unique_ptr<sksg::Scene> AnimationBuilder::parse(const skjson::ObjectValue&
 
     auto animators = ascope.release();
     fStats->fAnimatorCount = animators.size();
+    fKeyframeAnimators.clear();
 
     return sksg::Scene::Make(std::move(root), std::move(animators));
 }
@@ -419,7 +426,7 @@ sk_sp<SkData> ResourceProvider::loadFont(const char[], const char[]) const {
 
 void Logger::log(Level, const char[], const char*) {}
 
-Animation::Builder::Builder()  = default;
+Animation::Builder::Builder(uint32_t flags) : fFlags(flags) {}
 Animation::Builder::~Builder() = default;
 
 Animation::Builder& Animation::Builder::setResourceProvider(sk_sp<ResourceProvider> rp) {
@@ -482,15 +489,18 @@ sk_sp<Animation> Animation::Builder::make(const char* data, size_t data_len) {
     fStats.fJsonSize = data_len;
     const auto t0 = std::chrono::steady_clock::now();
 
-    const skjson::DOM dom(data, data_len);
-    if (!dom.root().is<skjson::ObjectValue>()) {
+    // Precompiled (binary DOM) inputs skip text parsing altogether.
+    auto dom = skjson::DOM::IsBinary(data, data_len)
+            ? skjson::DOM::MakeFromBinary(data, data_len)
+            : skstd::make_unique<skjson::DOM>(data, data_len);
+    if (!dom || !dom->root().is<skjson::ObjectValue>()) {
         // TODO: more error info.
         if (fLogger) {
             fLogger->log(Logger::Level::kError, "Failed to parse JSON input.\n");
         }
         return nullptr;
     }
-    const auto& json = dom.root().as<skjson::ObjectValue>();
+    const auto& json = dom->root().as<skjson::ObjectValue>();
 
     const auto t1 = std::chrono::steady_clock::now();
     fStats.fJsonParseTimeMS = std::chrono::duration<float, std::milli>{t1-t0}.count();
@@ -516,12 +526,18 @@ sk_sp<Animation> Animation::Builder::make(const char* data, size_t data_len) {
     }
 
     SkASSERT(resolvedProvider);
-    internal::AnimationBuilder builder(std::move(resolvedProvider), fFontMgr,
-                                       std::move(fPropertyObserver),
-                                       std::move(fLogger),
-                                       std::move(fMarkerObserver),
-                                       &fStats, size, duration, fps);
-    auto scene = builder.parse(json);
+    // Deferred precomps outlive this call, and share ownership of the builder (and DOM).
+    auto builder = std::make_shared<internal::AnimationBuilder>(std::move(resolvedProvider),
+                                                                fFontMgr,
+                                                                std::move(fPropertyObserver),
+                                                                std::move(fLogger),
+                                                                std::move(fMarkerObserver),
+                                                                &fStats, size, duration, fps,
+                                                                fFlags);
+    auto scene = builder->parse(json);
+    if (fFlags & kDeferPrecompLoading) {
+        builder->retainDOM(std::move(dom));
+    }
 
     const auto t2 = std::chrono::steady_clock::now();
     fStats.fSceneParseTimeMS = std::chrono::duration<float, std::milli>{t2-t1}.count();
@@ -532,8 +548,8 @@ sk_sp<Animation> Animation::Builder::make(const char* data, size_t data_len) {
     }
 
     uint32_t flags = 0;
-    if (builder.hasNontrivialBlending()) {
-        flags |= Flags::kRequiresTopLevelIsolation;
+    if (builder->hasNontrivialBlending()) {
+        flags |= Animation::Flags::kRequiresTopLevelIsolation;
     }
 
     return sk_sp<Animation>(new Animation(std::move(scene),
@@ -542,9 +558,24 @@ sk_sp<Animation> Animation::Builder::make(const char* data, size_t data_len) {
                                           inPoint,
                                           outPoint,
                                           duration,
+                                          fps,
                                           flags));
 }
 
+sk_sp<SkData> Animation::Builder::Precompile(const char* data, size_t data_len) {
+    TRACE_EVENT0("skottie", TRACE_FUNC);
+
+    const skjson::DOM dom(data, data_len);
+    if (!dom.root().is<skjson::ObjectValue>()) {
+        return nullptr;
+    }
+
+    SkDynamicMemoryWStream stream;
+    dom.writeBinary(&stream);
+
+    return stream.detachAsData();
+}
+
 sk_sp<Animation> Animation::Builder::makeFromFile(const char path[]) {
     const auto data = SkData::MakeFromFileName(path);
 
@@ -553,13 +584,15 @@ sk_sp<Animation> Animation::Builder::makeFromFile(const char path[]) {
 }
 
 Animation::Animation(std::unique_ptr<sksg::Scene> scene, SkString version, const SkSize& size,
-                     SkScalar inPoint, SkScalar outPoint, SkScalar duration, uint32_t flags)
+                     SkScalar inPoint, SkScalar outPoint, SkScalar duration, SkScalar fps,
+                     uint32_t flags)
     : fScene(std::move(scene))
     , fVersion(std::move(version))
     , fSize(size)
     , fInPoint(inPoint)
     , fOutPoint(outPoint)
     , fDuration(duration)
+    , fFPS(fps)
     , fFlags(flags) {
 
     // In case the client calls render before the first tick.
@@ -597,6 +630,47 @@ void Animation::render(SkCanvas* canvas, const SkRect* dstR, RenderFlags renderF
     fScene->render(canvas);
 }
 
+void Animation::renderDamage(SkCanvas* canvas, const sksg::InvalidationController& ic,
+                             const SkRect* dstR, RenderFlags renderFlags) const {
+    TRACE_EVENT0("skottie", TRACE_FUNC);
+
+    if (!fScene || ic.bounds().isEmpty())
+        return;
+
+    SkAutoCanvasRestore restore(canvas, true);
+
+    const SkRect srcR = SkRect::MakeSize(this->size());
+    if (dstR) {
+        canvas->concat(SkMatrix::MakeRectToRect(srcR, *dstR, SkMatrix::kCenter_ScaleToFit));
+    }
+
+    // Damage rects are in animation coordinates.  Map them to device space and snap to pixel
+    // boundaries: a non-AA clip ensures that we never blend partial coverage over the previous
+    // frame pixels.  Past a certain fragmentation level, the region ops are not worth it.
+    static constexpr ptrdiff_t kMaxDamageRects = 16;
+    const auto& ctm = canvas->getTotalMatrix();
+
+    SkRegion damage;
+    if (ic.end() - ic.begin() > kMaxDamageRects) {
+        damage.setRect(ctm.mapRect(ic.bounds()).roundOut());
+    } else {
+        for (const auto& r : ic) {
+            damage.op(ctm.mapRect(r).roundOut(), SkRegion::kUnion_Op);
+        }
+    }
+
+    canvas->clipRegion(damage);
+    canvas->clipRect(srcR);
+    canvas->clear(SK_ColorTRANSPARENT);
+
+    if ((fFlags & Flags::kRequiresTopLevelIsolation) &&
+        !(renderFlags & RenderFlag::kSkipTopLevelIsolation)) {
+        canvas->saveLayer(srcR, nullptr);
+    }
+
+    fScene->render(canvas);
+}
+
 void Animation::seek(SkScalar t, sksg::InvalidationController* ic) {
     TRACE_EVENT0("skottie", TRACE_FUNC);
 
@@ -609,6 +683,12 @@ void Animation::seek(SkScalar t, sksg::InvalidationController* ic) {
     fScene->animate(SkTPin(fInPoint + t * (fOutPoint - fInPoint), fInPoint, kLastValidFrame), ic);
 }
 
+void Animation::setProfiler(sksg::Profiler* profiler) {
+    if (fScene) {
+        fScene->setProfiler(profiler);
+    }
+}
+
 void Animation::seekFrameTime(double t, sksg::InvalidationController* ic) {
     if (double dur = this->duration()) {
         this->seek((SkScalar)(t / dur), ic);
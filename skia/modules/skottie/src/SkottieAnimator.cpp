@@ -49,18 +49,31 @@ protected:
         return *fCachedRec;
     }
 
-    float localT(const KeyframeRec& rec, float t) const {
+    // True if the value at |t| is interpolated (as opposed to one of the keyframe values).
+    static bool IsInterpolated(const KeyframeRec& rec, float t) {
         SkASSERT(rec.isValid());
-        SkASSERT(!rec.isConstant());
-        SkASSERT(t > rec.t0 && t < rec.t1);
+        return !rec.isConstant() && t > rec.t0 && t < rec.t1;
+    }
+
+    float linearT(const KeyframeRec& rec, float t) const {
+        SkASSERT(IsInterpolated(rec, t));
+        return (t - rec.t0) / (rec.t1 - rec.t0);
+    }
 
-        auto lt = (t - rec.t0) / (rec.t1 - rec.t0);
+    const SkCubicMap* cubicMap(const KeyframeRec& rec) const {
+        return rec.cmidx < 0 ? nullptr : &fCubicMaps[rec.cmidx];
+    }
+
+    float localT(const KeyframeRec& rec, float t) const {
+        const auto lt = this->linearT(rec, t);
+        const auto* cm = this->cubicMap(rec);
 
-        return rec.cmidx < 0
-            ? lt
-            : fCubicMaps[rec.cmidx].computeYFromX(lt);
+        return cm ? cm->computeYFromX(lt) : lt;
     }
 
+    // Applies the value at |t|, given its (eased) local time |lt| when interpolated.
+    virtual void applyKeyframe(const KeyframeRec&, float t, float lt) = 0;
+
     virtual int parseValue(const skjson::Value&, const AnimationBuilder* abuilder) = 0;
 
     void parseKeyFrames(const skjson::ArrayValue& jframes, const AnimationBuilder* abuilder) {
@@ -226,6 +239,81 @@ private:
     std::vector<SkCubicMap>  fCubicMaps;
     const KeyframeRec*       fCachedRec = nullptr;
 
+    friend class KeyframeAnimatorBatch;
+
+    using INHERITED = sksg::Animator;
+};
+
+// Ticks a run of keyframe animators as one unit, in three passes over per-batch SoA tables:
+//
+//   1) keyframe lookup and linear local time, for all animators
+//   2) eased local times for all cubic keyframes, via batched (SIMD) cubic map solves
+//   3) value interpolation and application, in the original animator order
+//
+// Keyframe animators only write their own property, so deferring application past the
+// evaluation of the run does not change any observable values.
+class KeyframeAnimatorBatch final : public sksg::Animator {
+public:
+    explicit KeyframeAnimatorBatch(std::vector<sk_sp<KeyframeAnimatorBase>>&& animators)
+        : fAnimators(std::move(animators))
+        , fRecs(fAnimators.size())
+        , fLocalT(fAnimators.size()) {
+        fCubicIndices.reserve(fAnimators.size());
+        fCubicMaps.reserve(fAnimators.size());
+        fCubicX.reserve(fAnimators.size());
+        fCubicY.reserve(fAnimators.size());
+    }
+
+protected:
+    void onTick(float t) override {
+        const auto count = fAnimators.size();
+
+        fCubicIndices.clear();
+        fCubicMaps.clear();
+        fCubicX.clear();
+
+        for (size_t i = 0; i < count; ++i) {
+            auto* animator = fAnimators[i].get();
+            const auto& rec = animator->frame(t);
+            fRecs[i] = &rec;
+
+            if (!KeyframeAnimatorBase::IsInterpolated(rec, t)) {
+                continue;
+            }
+
+            fLocalT[i] = animator->linearT(rec, t);
+            if (const auto* cm = animator->cubicMap(rec)) {
+                fCubicIndices.push_back(i);
+                fCubicMaps.push_back(cm);
+                fCubicX.push_back(fLocalT[i]);
+            }
+        }
+
+        if (!fCubicMaps.empty()) {
+            fCubicY.resize(fCubicMaps.size());
+            SkCubicMap::ComputeYFromX(fCubicMaps.data(), fCubicX.data(), fCubicY.data(),
+                                      SkToInt(fCubicMaps.size()));
+            for (size_t i = 0; i < fCubicIndices.size(); ++i) {
+                fLocalT[fCubicIndices[i]] = fCubicY[i];
+            }
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            fAnimators[i]->applyKeyframe(*fRecs[i], t, fLocalT[i]);
+        }
+    }
+
+private:
+    const std::vector<sk_sp<KeyframeAnimatorBase>> fAnimators;
+
+    // Per-tick scratch tables.
+    std::vector<const KeyframeAnimatorBase::KeyframeRec*> fRecs;
+    std::vector<float>                                    fLocalT;
+    std::vector<size_t>                                   fCubicIndices;
+    std::vector<const SkCubicMap*>                        fCubicMaps;
+    std::vector<float>                                    fCubicX,
+                                                          fCubicY;
+
     using INHERITED = sksg::Animator;
 };
 
@@ -244,7 +332,12 @@ public:
 
 protected:
     void onTick(float t) override {
-        fApplyFunc(*this->eval(this->frame(t), t, &fScratch));
+        const auto& rec = this->frame(t);
+        this->applyKeyframe(rec, t, IsInterpolated(rec, t) ? this->localT(rec, t) : 0);
+    }
+
+    void applyKeyframe(const KeyframeRec& rec, float t, float lt) override {
+        fApplyFunc(*this->eval(rec, t, lt, &fScratch));
     }
 
 private:
@@ -278,7 +371,7 @@ private:
         return SkToInt(fVs.size()) - 1;
     }
 
-    const T* eval(const KeyframeRec& rec, float t, T* v) const {
+    const T* eval(const KeyframeRec& rec, float t, float lt, T* v) const {
         SkASSERT(rec.isValid());
         if (rec.isConstant() || t <= rec.t0) {
             return &fVs[rec.vidx0];
@@ -286,7 +379,6 @@ private:
             return &fVs[rec.vidx1];
         }
 
-        const auto lt = this->localT(rec, t);
         const auto& v0 = fVs[rec.vidx0];
         const auto& v1 = fVs[rec.vidx1];
         ValueTraits<T>::Lerp(v0, v1, lt, v);
@@ -349,6 +441,7 @@ static inline bool BindPropertyImpl(const skjson::ObjectValue* jprop,
         return false;
     }
 
+    abuilder->registerKeyframeAnimator(animator);
     ascope->push_back(std::move(animator));
 
     return true;
@@ -382,6 +475,8 @@ public:
             return nullptr;
         }
 
+        abuilder->batchKeyframeAnimators(&split_animator->fAnimators);
+
         return split_animator;
     }
 
@@ -425,6 +520,45 @@ bool BindSplitPositionProperty(const skjson::Value& jv,
 
 } // namespace
 
+void AnimationBuilder::batchKeyframeAnimators(AnimatorScope* scope, size_t* split) const {
+    AnimatorScope batched;
+    batched.reserve(scope->size());
+
+    std::vector<sk_sp<KeyframeAnimatorBase>> run;
+    const auto flush_run = [&]() {
+        if (run.size() == 1) {
+            batched.push_back(std::move(run.front()));
+        } else if (run.size() > 1) {
+            batched.push_back(sk_make_sp<KeyframeAnimatorBatch>(std::move(run)));
+        }
+        run.clear();
+    };
+
+    size_t batched_split = 0;
+    for (size_t i = 0; i < scope->size(); ++i) {
+        if (split && i == *split) {
+            flush_run();
+            batched_split = batched.size();
+        }
+
+        auto& animator = (*scope)[i];
+        if (fKeyframeAnimators.count(animator.get())) {
+            // Registered animators are always KeyframeAnimatorBase instances.
+            run.push_back(sk_sp<KeyframeAnimatorBase>(
+                              static_cast<KeyframeAnimatorBase*>(animator.release())));
+        } else {
+            flush_run();
+            batched.push_back(std::move(animator));
+        }
+    }
+    flush_run();
+
+    if (split) {
+        *split = *split < scope->size() ? batched_split : batched.size();
+    }
+    *scope = std::move(batched);
+}
+
 template <>
 bool AnimationBuilder::bindProperty(const skjson::Value& jv,
                   std::function<void(const ScalarValue&)>&& apply,
@@ -19,11 +19,14 @@
 #include "src/utils/SkUTF.h"
 
 #include <functional>
+#include <memory>
+#include <unordered_map>
 
 class SkFontMgr;
 
 namespace skjson {
 class ArrayValue;
+class DOM;
 class ObjectValue;
 class Value;
 } // namespace skjson
@@ -46,15 +49,22 @@ class TextAdapter;
 
 using AnimatorScope = sksg::AnimatorList;
 
-class AnimationBuilder final : public SkNoncopyable {
+// Deferred (lazy) precomp layers keep a reference to the builder, which must then be
+// heap-allocated via std::make_shared.
+class AnimationBuilder final : public SkNoncopyable,
+                               public std::enable_shared_from_this<AnimationBuilder> {
 public:
     AnimationBuilder(sk_sp<ResourceProvider>, sk_sp<SkFontMgr>, sk_sp<PropertyObserver>,
                      sk_sp<Logger>, sk_sp<MarkerObserver>,
                      Animation::Builder::Stats*, const SkSize& size,
-                     float duration, float framerate);
+                     float duration, float framerate, uint32_t flags = 0);
+    ~AnimationBuilder();
 
     std::unique_ptr<sksg::Scene> parse(const skjson::ObjectValue&);
 
+    // Deferred fragments are built after parse(), and reference the DOM until then.
+    void retainDOM(std::unique_ptr<skjson::DOM> dom) { fRetainedDOM = std::move(dom); }
+
     struct FontInfo {
         SkString                  fFamily,
                                   fStyle;
@@ -81,6 +91,17 @@ public:
 
     void log(Logger::Level, const skjson::Value*, const char fmt[], ...) const;
 
+    // Keyframe animators registered at bind time are candidates for batched evaluation: runs
+    // of consecutive registered animators in |scope| are replaced with a single batch animator,
+    // without crossing the optional |split| index (which is updated to match).
+    // Registered animators are retained until the end of the build, so a registered address
+    // can not be reused by another animator when its scope is truncated or dropped.
+    void registerKeyframeAnimator(sk_sp<sksg::Animator> animator) const {
+        const auto* key = animator.get();
+        fKeyframeAnimators.emplace(key, std::move(animator));
+    }
+    void batchKeyframeAnimators(AnimatorScope* scope, size_t* split = nullptr) const;
+
     sk_sp<sksg::Color> attachColor(const skjson::ObjectValue&, const char prop_name[]) const;
     sk_sp<sksg::Transform> attachMatrix2D(const skjson::ObjectValue&, sk_sp<sksg::Transform>) const;
     sk_sp<sksg::Transform> attachMatrix3D(const skjson::ObjectValue&, sk_sp<sksg::Transform>,
@@ -103,7 +124,11 @@ public:
             fBuilder->fCurrentAnimatorScope = &fCurrentScope;
         }
 
-        AnimatorScope release() {
+        // Runs of keyframe animators are merged into batched evaluators on release.
+        // |split|, when specified, is a scope index which must remain a dispatch boundary; it is
+        // updated to the corresponding index in the returned scope.
+        AnimatorScope release(size_t* split = nullptr) {
+            fBuilder->batchKeyframeAnimators(&fCurrentScope, split);
             fBuilder->fCurrentAnimatorScope = fPrevScope;
             SkDEBUGCODE(fBuilder = nullptr);
 
@@ -194,6 +219,12 @@ private:
     sk_sp<sksg::RenderNode> attachSolidLayer  (const skjson::ObjectValue&, LayerInfo*) const;
     sk_sp<sksg::RenderNode> attachTextLayer   (const skjson::ObjectValue&, LayerInfo*) const;
 
+    sk_sp<sksg::RenderNode> attachDeferredPrecomp(const skjson::ObjectValue&, LayerInfo*,
+                                                  float time_bias, float time_scale,
+                                                  const skjson::ObjectValue* time_remap) const;
+    // Whether the content of a precomp layer (which may not be attached yet) uses blend modes.
+    bool precompHasBlending(const skjson::ObjectValue& jlayer) const;
+
     bool dispatchColorProperty(const sk_sp<sksg::Color>&) const;
     bool dispatchOpacityProperty(const sk_sp<sksg::OpacityEffect>&) const;
     bool dispatchTextProperty(const sk_sp<TextAdapter>&) const;
@@ -222,18 +253,24 @@ private:
     sk_sp<PropertyObserver>    fPropertyObserver;
     sk_sp<Logger>              fLogger;
     sk_sp<MarkerObserver>      fMarkerObserver;
-    Animation::Builder::Stats* fStats;
+    Animation::Builder::Stats* fStats;              // Only valid during parse().
     const SkSize               fSize;
     const float                fDuration,
                                fFrameRate;
+    const uint32_t             fFlags;                // Animation::Builder::Flags
+    std::unique_ptr<skjson::DOM> fRetainedDOM;
     mutable AnimatorScope*     fCurrentAnimatorScope;
+    mutable std::unordered_map<const sksg::Animator*,
+                               sk_sp<sksg::Animator>> fKeyframeAnimators;
     mutable const char*        fPropertyObserverContext;
     mutable bool               fHasNontrivialBlending : 1;
 
     struct LayerInfo {
-        SkSize      fSize;
-        const float fInPoint,
-                    fOutPoint;
+        SkSize        fSize;
+        const float   fInPoint,
+                      fOutPoint;
+        // Content animators which must tick even while the layer is inactive.
+        AnimatorScope fPersistentAnimators;
     };
 
     struct AssetInfo {
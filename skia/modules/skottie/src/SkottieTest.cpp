@@ -8,11 +8,14 @@
 #include "include/core/SkFontMgr.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkStream.h"
+#include "include/core/SkSurface.h"
 #include "include/core/SkTextBlob.h"
 #include "include/core/SkTypeface.h"
 #include "modules/skottie/include/Skottie.h"
 #include "modules/skottie/include/SkottieProperty.h"
 #include "modules/skottie/src/text/SkottieShaper.h"
+#include "modules/skottie/utils/SkottieUtils.h"
+#include "modules/sksg/include/SkSGInvalidationController.h"
 #include "src/core/SkFontDescriptor.h"
 #include "src/core/SkTextBlobPriv.h"
 #include "tests/Test.h"
@@ -355,6 +358,379 @@ DEF_TEST(Skottie_Annotations, reporter) {
     REPORTER_ASSERT(reporter, std::get<2>(observer->fMarkers[1]) == 0.75f);
 }
 
+DEF_TEST(Skottie_RenderDamage, reporter) {
+    // Static background + small moving square.
+    static constexpr char json[] = R"({
+                                     "v": "5.2.1",
+                                     "w": 100,
+                                     "h": 100,
+                                     "fr": 10,
+                                     "ip": 0,
+                                     "op": 10,
+                                     "layers": [
+                                       {
+                                         "ty": 1,
+                                         "ip": 0,
+                                         "op": 10,
+                                         "ks": {
+                                           "p": { "a": 1, "k": [
+                                             { "t": 0, "s": [ 10, 10 ], "e": [ 80, 80 ] },
+                                             { "t": 10 }
+                                           ]}
+                                         },
+                                         "sw": 10,
+                                         "sh": 10,
+                                         "sc": "#ff0000"
+                                       },
+                                       {
+                                         "ty": 1,
+                                         "ip": 0,
+                                         "op": 10,
+                                         "sw": 100,
+                                         "sh": 100,
+                                         "sc": "#00ff00"
+                                       }
+                                     ]
+                                   })";
+
+    SkMemoryStream stream(json, strlen(json));
+    auto animation = Animation::Make(&stream);
+    REPORTER_ASSERT(reporter, animation);
+    if (!animation) {
+        return;
+    }
+
+    const auto info = SkImageInfo::MakeN32Premul(100, 100);
+    auto incremental = SkSurface::MakeRaster(info),
+         reference   = SkSurface::MakeRaster(info);
+
+    animation->seek(0);
+    animation->render(incremental->getCanvas());
+
+    for (const auto t : { 0.5f, 0.7f, 0.2f }) {
+        sksg::InvalidationController ic;
+        animation->seek(t, &ic);
+
+        // Only the square (old + new positions) should be invalidated.
+        REPORTER_ASSERT(reporter, !ic.bounds().isEmpty());
+        REPORTER_ASSERT(reporter, ic.bounds().width() < 100 && ic.bounds().height() < 100);
+
+        animation->renderDamage(incremental->getCanvas(), ic);
+
+        reference->getCanvas()->clear(SK_ColorTRANSPARENT);
+        animation->render(reference->getCanvas());
+
+        auto img0 = incremental->makeImageSnapshot(),
+             img1 = reference->makeImageSnapshot();
+        REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(img0.get(), img1.get()));
+    }
+}
+
+DEF_TEST(Skottie_Precompiled, reporter) {
+    static constexpr char json[] = R"({
+                                     "v": "5.2.1",
+                                     "w": 100,
+                                     "h": 100,
+                                     "fr": 10,
+                                     "ip": 0,
+                                     "op": 10,
+                                     "layers": [
+                                       {
+                                         "ty": 1,
+                                         "ip": 0,
+                                         "op": 10,
+                                         "ks": {
+                                           "o": { "a": 1, "k": [
+                                             { "t": 0, "s": [ 100 ], "e": [ 25 ] },
+                                             { "t": 10 }
+                                           ]}
+                                         },
+                                         "sw": 50,
+                                         "sh": 50,
+                                         "sc": "#0000ff"
+                                       }
+                                     ]
+                                   })";
+
+    REPORTER_ASSERT(reporter, !Animation::Builder::Precompile("{ invalid", 9));
+
+    auto skb = Animation::Builder::Precompile(json, strlen(json));
+    REPORTER_ASSERT(reporter, skb);
+    if (!skb) {
+        return;
+    }
+
+    auto anim0 = Animation::Make(json, strlen(json)),
+         anim1 = Animation::Make(static_cast<const char*>(skb->data()), skb->size());
+    REPORTER_ASSERT(reporter, anim0 && anim1);
+    if (!anim0 || !anim1) {
+        return;
+    }
+
+    REPORTER_ASSERT(reporter, anim0->duration() == anim1->duration());
+    REPORTER_ASSERT(reporter, anim0->size()     == anim1->size());
+    REPORTER_ASSERT(reporter, anim0->version().equals(anim1->version()));
+
+    const auto info = SkImageInfo::MakeN32Premul(100, 100);
+    auto surf0 = SkSurface::MakeRaster(info),
+         surf1 = SkSurface::MakeRaster(info);
+
+    for (const auto t : { 0.0f, 0.3f, 0.9f }) {
+        anim0->seek(t);
+        anim1->seek(t);
+
+        surf0->getCanvas()->clear(SK_ColorTRANSPARENT);
+        surf1->getCanvas()->clear(SK_ColorTRANSPARENT);
+        anim0->render(surf0->getCanvas());
+        anim1->render(surf1->getCanvas());
+
+        auto img0 = surf0->makeImageSnapshot(),
+             img1 = surf1->makeImageSnapshot();
+        REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(img0.get(), img1.get()));
+    }
+}
+
+DEF_TEST(Skottie_DeferredPrecomps, reporter) {
+    // Two precomp layers, active in the first and second half of the timeline respectively
+    // (one stretched, one time-remapped).
+    static constexpr char json[] = R"({
+                                     "v": "5.2.1",
+                                     "w": 100,
+                                     "h": 100,
+                                     "fr": 10,
+                                     "ip": 0,
+                                     "op": 10,
+                                     "assets": [
+                                       {
+                                         "id": "comp",
+                                         "layers": [
+                                           {
+                                             "ty": 1,
+                                             "ip": 0,
+                                             "op": 20,
+                                             "ks": {
+                                               "p": { "a": 1, "k": [
+                                                 { "t": 0, "s": [ 10, 10 ], "e": [ 60, 40 ] },
+                                                 { "t": 10 }
+                                               ]},
+                                               "o": { "a": 1, "k": [
+                                                 { "t": 0, "s": [ 100 ], "e": [ 30 ] },
+                                                 { "t": 10 }
+                                               ]}
+                                             },
+                                             "sw": 30,
+                                             "sh": 30,
+                                             "sc": "#ff0000"
+                                           }
+                                         ]
+                                       }
+                                     ],
+                                     "layers": [
+                                       {
+                                         "ty": 0,
+                                         "refId": "comp",
+                                         "ip": 0,
+                                         "op": 5,
+                                         "st": 1,
+                                         "sr": 0.5,
+                                         "w": 100,
+                                         "h": 100
+                                       },
+                                       {
+                                         "ty": 0,
+                                         "refId": "comp",
+                                         "ip": 5,
+                                         "op": 10,
+                                         "tm": { "a": 1, "k": [
+                                           { "t": 5, "s": [ 1 ], "e": [ 0 ] },
+                                           { "t": 10 }
+                                         ]},
+                                         "w": 100,
+                                         "h": 100
+                                       }
+                                     ]
+                                   })";
+
+    auto eager = Animation::Builder().make(json, strlen(json)),
+         lazy  = Animation::Builder(Animation::Builder::kDeferPrecompLoading |
+                                    Animation::Builder::kReleaseInactivePrecomps)
+                     .make(json, strlen(json));
+    REPORTER_ASSERT(reporter, eager && lazy);
+    if (!eager || !lazy) {
+        return;
+    }
+
+    const auto info = SkImageInfo::MakeN32Premul(100, 100);
+    auto surf0 = SkSurface::MakeRaster(info),
+         surf1 = SkSurface::MakeRaster(info);
+
+    // Includes seeking back into released content.
+    for (const auto t : { 0.0f, 0.3f, 0.6f, 0.9f, 0.2f, 0.7f, 0.45f }) {
+        eager->seek(t);
+        lazy->seek(t);
+
+        surf0->getCanvas()->clear(SK_ColorTRANSPARENT);
+        surf1->getCanvas()->clear(SK_ColorTRANSPARENT);
+        eager->render(surf0->getCanvas());
+        lazy->render(surf1->getCanvas());
+
+        auto img0 = surf0->makeImageSnapshot(),
+             img1 = surf1->makeImageSnapshot();
+        REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(img0.get(), img1.get()), "t: %g", t);
+    }
+
+    // Released precomps are rebuilt with new nodes: observers receive new handles.
+    class OpacityObserver final : public PropertyObserver {
+    public:
+        void onOpacityProperty(const char[],
+                const PropertyObserver::LazyHandle<OpacityPropertyHandle>& lh) override {
+            fHandles.push_back(lh());
+        }
+
+        std::vector<std::unique_ptr<OpacityPropertyHandle>> fHandles;
+    };
+
+    auto observer = sk_make_sp<OpacityObserver>();
+    auto observed = Animation::Builder(Animation::Builder::kDeferPrecompLoading |
+                                       Animation::Builder::kReleaseInactivePrecomps)
+                        .setPropertyObserver(observer)
+                        .make(json, strlen(json));
+    REPORTER_ASSERT(reporter, observed);
+    if (!observed) {
+        return;
+    }
+
+    const auto built_handles = [&](float t) {
+        observed->seek(t);
+        return observer->fHandles.size();
+    };
+    const auto initial = observer->fHandles.size();
+    const auto first   = built_handles(0.2f),
+               second  = built_handles(0.7f),
+               rebuilt = built_handles(0.2f);
+    REPORTER_ASSERT(reporter, first > initial);
+    REPORTER_ASSERT(reporter, second > first);
+    REPORTER_ASSERT(reporter, rebuilt > second);
+
+    // The latest handle controls the rebuilt content.
+    observer->fHandles.back()->set(0);
+    surf0->getCanvas()->clear(SK_ColorTRANSPARENT);
+    observed->render(surf0->getCanvas());
+    SkBitmap bm;
+    REPORTER_ASSERT(reporter, bm.tryAllocPixels(info) && surf0->readPixels(bm, 0, 0));
+    for (int y = 0; y < bm.height(); ++y) {
+        for (int x = 0; x < bm.width(); ++x) {
+            REPORTER_ASSERT(reporter, *bm.getAddr32(x, y) == 0);
+        }
+    }
+}
+
+DEF_TEST(Skottie_FrameCache, reporter) {
+    // 10 frames of a square moving over a static background.
+    static constexpr char json[] = R"({
+                                     "v": "5.2.1",
+                                     "w": 10,
+                                     "h": 10,
+                                     "fr": 10,
+                                     "ip": 0,
+                                     "op": 10,
+                                     "layers": [
+                                       {
+                                         "ty": 1,
+                                         "ip": 0,
+                                         "op": 10,
+                                         "ks": {
+                                           "p": { "a": 1, "k": [
+                                             { "t": 0, "s": [ 1, 1 ], "e": [ 8, 8 ] },
+                                             { "t": 10 }
+                                           ]}
+                                         },
+                                         "sw": 2,
+                                         "sh": 2,
+                                         "sc": "#ff0000"
+                                       },
+                                       {
+                                         "ty": 1,
+                                         "ip": 0,
+                                         "op": 10,
+                                         "sw": 10,
+                                         "sh": 10,
+                                         "sc": "#00ff00"
+                                       }
+                                     ]
+                                   })";
+
+    SkMemoryStream stream(json, strlen(json));
+    auto animation = Animation::Make(&stream);
+    REPORTER_ASSERT(reporter, animation);
+    if (!animation) {
+        return;
+    }
+
+    const auto info        = SkImageInfo::MakeN32Premul(10, 10);
+    const auto frame_bytes = info.computeMinByteSize();
+    auto surface   = SkSurface::MakeRaster(info),
+         reference = SkSurface::MakeRaster(info);
+
+    auto check_frame = [&](double t) {
+        reference->getCanvas()->clear(SK_ColorTRANSPARENT);
+        animation->seekFrameTime(std::floor(std::fmod(t, 1.0) * 10) / 10);
+        animation->render(reference->getCanvas());
+
+        auto img0 = surface->makeImageSnapshot(),
+             img1 = reference->makeImageSnapshot();
+        REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(img0.get(), img1.get()));
+    };
+
+    // Room for two frames.
+    auto cache = skottie_utils::FrameCache::Make(animation,
+                                                 skottie_utils::FrameCache::Mode::kRaster,
+                                                 2 * frame_bytes);
+    REPORTER_ASSERT(reporter, cache);
+    if (!cache) {
+        return;
+    }
+
+    auto render = [&](double t) {
+        surface->getCanvas()->clear(SK_ColorTRANSPARENT);
+        cache->render(surface->getCanvas(), t);
+    };
+
+    // Times within a frame, and times one loop later, hit the same cached frame.
+    render(0.05);
+    render(0.08);
+    render(1.05);
+    check_frame(0.05);
+    REPORTER_ASSERT(reporter, cache->stats().fMisses    == 1);
+    REPORTER_ASSERT(reporter, cache->stats().fHits      == 2);
+    REPORTER_ASSERT(reporter, cache->stats().fFrameCount == 1);
+    REPORTER_ASSERT(reporter, cache->stats().fBytesUsed  == frame_bytes);
+
+    // Once the budget is used up, further frames are rendered but not admitted, and cached
+    // frames are kept.
+    render(0.15);
+    render(0.55);
+    check_frame(0.55);
+    render(0.55);
+    check_frame(0.55);
+    render(0.05);
+    check_frame(0.05);
+    REPORTER_ASSERT(reporter, cache->stats().fMisses    == 4);
+    REPORTER_ASSERT(reporter, cache->stats().fHits      == 3);
+    REPORTER_ASSERT(reporter, cache->stats().fFrameCount == 2);
+    REPORTER_ASSERT(reporter, cache->stats().fBytesUsed  == 2 * frame_bytes);
+
+    // Purging drops all frames and stats.
+    cache->purge();
+    REPORTER_ASSERT(reporter, cache->stats().fFrameCount == 0);
+    REPORTER_ASSERT(reporter, cache->stats().fBytesUsed  == 0);
+    render(0.05);
+    check_frame(0.05);
+    REPORTER_ASSERT(reporter, cache->stats().fMisses    == 1);
+    REPORTER_ASSERT(reporter, cache->stats().fHits      == 0);
+    REPORTER_ASSERT(reporter, cache->stats().fFrameCount == 1);
+}
+
 static SkRect ComputeBlobBounds(const sk_sp<SkTextBlob>& blob) {
     auto bounds = SkRect::MakeEmpty();
 
@@ -6,12 +6,15 @@
  */
 
 #include "include/core/SkCanvas.h"
+#include "include/core/SkData.h"
 #include "include/core/SkGraphics.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkSurface.h"
+#include "include/private/SkTo.h"
 #include "modules/skottie/include/Skottie.h"
 #include "modules/skottie/utils/SkottieUtils.h"
+#include "modules/sksg/include/SkSGProfiler.h"
 #include "src/core/SkMakeUnique.h"
 #include "src/core/SkOSFile.h"
 #include "src/utils/SkOSPath.h"
@@ -21,7 +24,8 @@
 
 static DEFINE_string2(input    , i, nullptr, "Input .json file.");
 static DEFINE_string2(writePath, w, nullptr, "Output directory.  Frames are names [0-9]{6}.png.");
-static DEFINE_string2(format   , f, "png"  , "Output format (png or skp)");
+static DEFINE_string2(format   , f, "png"  , "Output format (png, skp or skb)."
+                                             "  skb writes a single precompiled animation.");
 
 static DEFINE_double(t0,   0, "Timeline start [0..1].");
 static DEFINE_double(t1,   1, "Timeline stop [0..1].");
@@ -30,6 +34,8 @@ static DEFINE_double(fps, 30, "Decode frames per second.");
 static DEFINE_int(width , 800, "Render width.");
 static DEFINE_int(height, 600, "Render height.");
 
+static DEFINE_int(profile, 0, "Report the N most expensive scene graph nodes and animators.");
+
 namespace {
 
 class Sink {
@@ -154,6 +160,39 @@ private:
                           fWarnings;
 };
 
+// Converts the input to Skottie's precompiled binary form, after validating that it loads.
+bool precompile() {
+    const auto json = SkData::MakeFromFileName(FLAGS_input[0]);
+    if (!json) {
+        SkDebugf("Could not read '%s'.\n", FLAGS_input[0]);
+        return false;
+    }
+
+    const auto* json_data = static_cast<const char*>(json->data());
+    auto skb = skottie::Animation::Builder::Precompile(json_data, json->size());
+    if (!skb || !skottie::Animation::Make(static_cast<const char*>(skb->data()), skb->size())) {
+        SkDebugf("Could not precompile animation: '%s'.\n", FLAGS_input[0]);
+        return false;
+    }
+
+    auto basename = SkOSPath::Basename(FLAGS_input[0]);
+    if (basename.endsWith(".json")) {
+        basename.resize(basename.size() - strlen(".json"));
+    }
+    basename.append(".skb");
+
+    const auto path = SkOSPath::Join(FLAGS_writePath[0], basename.c_str());
+    SkFILEWStream stream(path.c_str());
+    if (!stream.isValid() || !stream.write(skb->data(), skb->size())) {
+        SkDebugf("Could not write '%s'.\n", path.c_str());
+        return false;
+    }
+
+    SkDebugf("Precompiled '%s' -> '%s' (%zu -> %zu bytes).\n",
+             FLAGS_input[0], path.c_str(), json->size(), skb->size());
+    return true;
+}
+
 } // namespace
 
 int main(int argc, char** argv) {
@@ -174,6 +213,10 @@ int main(int argc, char** argv) {
         return 1;
     }
 
+    if (0 == strcmp(FLAGS_format[0], "skb")) {
+        return precompile() ? 0 : 1;
+    }
+
     std::unique_ptr<Sink> sink;
     if (0 == strcmp(FLAGS_format[0], "png")) {
         sink = skstd::make_unique<PNGSink>();
@@ -203,11 +246,21 @@ int main(int argc, char** argv) {
                t1 = SkTPin(FLAGS_t1,  t0, 1.0),
                advance = 1 / std::min(anim->duration() * FLAGS_fps, kMaxFrames);
 
+    sksg::Profiler profiler;
+    if (FLAGS_profile > 0) {
+        anim->setProfiler(&profiler);
+    }
+
     size_t frame_index = 0;
     for (auto t = t0; t <= t1; t += advance) {
         anim->seek(t);
         sink->handleFrame(anim, frame_index++);
     }
 
+    if (FLAGS_profile > 0) {
+        anim->setProfiler(nullptr);
+        SkDebugf("%s", profiler.report(SkToSizeT(FLAGS_profile)).c_str());
+    }
+
     return 0;
 }
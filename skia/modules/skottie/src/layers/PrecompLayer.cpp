@@ -9,6 +9,7 @@
 
 #include "modules/skottie/src/SkottieJson.h"
 #include "modules/skottie/src/SkottieValue.h"
+#include "modules/sksg/include/SkSGGroup.h"
 #include "modules/sksg/include/SkSGRenderNode.h"
 #include "modules/sksg/include/SkSGScene.h"
 #include "src/core/SkTLazy.h"
@@ -31,6 +32,11 @@ sk_sp<sksg::RenderNode> AnimationBuilder::attachPrecompLayer(const skjson::Objec
     layer_info->fSize = SkSize::Make(ParseDefault<float>(jlayer["w"], 0.0f),
                                      ParseDefault<float>(jlayer["h"], 0.0f));
 
+    if (fFlags & Animation::Builder::kDeferPrecompLoading) {
+        return this->attachDeferredPrecomp(jlayer, layer_info, -start_time,
+                                           sk_ieee_float_divide(1, stretch_time), time_remap);
+    }
+
     SkTLazy<AutoScope> local_scope;
     if (requires_time_mapping) {
         local_scope.init(this);
@@ -86,5 +92,165 @@ sk_sp<sksg::RenderNode> AnimationBuilder::attachPrecompLayer(const skjson::Objec
     return precomp_layer;
 }
 
+sk_sp<sksg::RenderNode> AnimationBuilder::attachDeferredPrecomp(
+        const skjson::ObjectValue& jlayer, LayerInfo* layer_info, float time_bias,
+        float time_scale, const skjson::ObjectValue* time_remap) const {
+    // Stands in for the precomp content, which is built on first activation and optionally
+    // discarded on deactivation.  Ticked regardless of layer activity (in order to observe
+    // deactivation), it applies the same t-adjustments as CompTimeMapper.
+    class DeferredPrecompController final : public sksg::Animator {
+    public:
+        DeferredPrecompController(std::shared_ptr<const AnimationBuilder> abuilder,
+                                  const skjson::ObjectValue& jlayer,
+                                  sk_sp<sksg::Group> container,
+                                  float in, float out, float time_bias, float time_scale)
+            : fBuilder(std::move(abuilder))
+            , fLayer(jlayer)
+            , fContainer(std::move(container))
+            , fIn(in)
+            , fOut(out)
+            , fTimeBias(time_bias)
+            , fTimeScale(time_scale) {}
+
+        void setRemapAnimators(AnimatorScope&& animators) {
+            fRemapAnimators = std::move(animators);
+        }
+
+        void remapTime(float t) { fRemappedTime.set(t); }
+
+    protected:
+        void onTick(float t) override {
+            if (t < fIn || t >= fOut) {
+                if (fBuilt && (fBuilder->fFlags & Animation::Builder::kReleaseInactivePrecomps)) {
+                    fContainer->clear();
+                    fAnimators.clear();
+                    fBuilt = false;
+                }
+                return;
+            }
+
+            if (!fBuilt) {
+                this->build();
+            }
+
+            // Time remapping is driven by the layer time, and applies to the current frame.
+            for (const auto& animator : fRemapAnimators) {
+                animator->tick(t);
+            }
+            if (fRemappedTime.isValid()) {
+                t = *fRemappedTime.get();
+            }
+
+            const auto comp_t = (t + fTimeBias) * fTimeScale;
+            for (const auto& animator : fAnimators) {
+                animator->tick(comp_t);
+            }
+        }
+
+    private:
+        void build() {
+            const AnimationBuilder* abuilder = fBuilder.get();
+            const AutoPropertyTracker apt(abuilder, fLayer);
+
+            AutoScope ascope(abuilder);
+            auto content = abuilder->attachAssetRef(fLayer,
+                [abuilder] (const skjson::ObjectValue& jcomp) {
+                    return abuilder->attachComposition(jcomp);
+                });
+            fAnimators = ascope.release();
+            // The batching registry is only meaningful for the duration of a build (and retains
+            // the registered animators until cleared).
+            abuilder->fKeyframeAnimators.clear();
+
+            if (content) {
+                fContainer->addChild(std::move(content));
+            }
+            fBuilt = true;
+        }
+
+        const std::shared_ptr<const AnimationBuilder> fBuilder;
+        const skjson::ObjectValue&                    fLayer;
+        const sk_sp<sksg::Group>                      fContainer;
+        const float                                   fIn,
+                                                      fOut,
+                                                      fTimeBias,
+                                                      fTimeScale;
+        AnimatorScope                                 fRemapAnimators,
+                                                      fAnimators;
+        SkTLazy<float>                                fRemappedTime;
+        bool                                          fBuilt = false;
+    };
+
+    auto container = sksg::Group::Make();
+    auto controller = sk_make_sp<DeferredPrecompController>(this->shared_from_this(), jlayer,
+                                                            container,
+                                                            layer_info->fInPoint,
+                                                            layer_info->fOutPoint,
+                                                            time_bias,
+                                                            sk_float_isfinite(time_scale)
+                                                                ? time_scale : 0);
+
+    if (time_remap) {
+        AutoScope ascope(this);
+        // Raw pointer capture: the controller owns the remap animators.
+        auto* remap_controller = controller.get();
+        auto  frame_rate = fFrameRate;
+        this->bindProperty<ScalarValue>(*time_remap,
+                [remap_controller, frame_rate](const ScalarValue& t) {
+                    remap_controller->remapTime(t * frame_rate);
+                });
+        controller->setRemapAnimators(ascope.release());
+    }
+
+    // Deferred content is not attached yet: look for blending in its JSON instead.
+    if (this->precompHasBlending(jlayer)) {
+        fHasNontrivialBlending = true;
+    }
+
+    layer_info->fPersistentAnimators.push_back(std::move(controller));
+
+    return std::move(container);
+}
+
+bool AnimationBuilder::precompHasBlending(const skjson::ObjectValue& jlayer) const {
+    const auto refId = ParseDefault<SkString>(jlayer["refId"], SkString());
+    const auto* asset_info = fAssets.find(refId);
+    if (!asset_info || asset_info->fIsAttaching) {
+        // Missing assets and cycles are reported when attaching.
+        return false;
+    }
+
+    // Any non-normal blend mode ("bm") on layers or shapes, including nested precomps.
+    std::function<bool(const skjson::Value&)> has_blending = [&](const skjson::Value& jv) {
+        if (const skjson::ArrayValue* jarray = jv) {
+            for (const auto& jelem : *jarray) {
+                if (has_blending(jelem)) {
+                    return true;
+                }
+            }
+        } else if (const skjson::ObjectValue* jobject = jv) {
+            if (ParseDefault<size_t>((*jobject)["bm"], 0) != 0) {
+                return true;
+            }
+            if (ParseDefault<int>((*jobject)["ty"], -1) == 0 &&
+                this->precompHasBlending(*jobject)) {
+                return true;
+            }
+            for (const auto& jmember : *jobject) {
+                if (has_blending(jmember.fValue)) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+
+    asset_info->fIsAttaching = true;
+    const auto result = has_blending(*asset_info->fAsset);
+    asset_info->fIsAttaching = false;
+
+    return result;
+}
+
 } // namespace internal
 } // namespace skottie
@@ -8,8 +8,12 @@
 #include "modules/skottie/utils/SkottieUtils.h"
 
 #include "include/codec/SkCodec.h"
+#include "include/core/SkCanvas.h"
 #include "include/core/SkData.h"
 #include "include/core/SkImage.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/core/SkSurface.h"
 #include "include/utils/SkAnimCodecPlayer.h"
 #include "src/core/SkMakeUnique.h"
 #include "src/core/SkOSFile.h"
@@ -232,4 +236,120 @@ bool CustomPropertyManager::setTransform(const PropKey& key,
     return this->set(key, t, fTransformMap);
 }
 
+std::unique_ptr<FrameCache> FrameCache::Make(sk_sp<skottie::Animation> animation, Mode mode,
+                                             size_t byte_budget, const SkISize& raster_size) {
+    if (!animation || !(animation->fps() > 0) || !(animation->duration() > 0)) {
+        return nullptr;
+    }
+
+    const auto size = raster_size.isEmpty() ? animation->size().toCeil() : raster_size;
+    if (mode == Mode::kRaster && size.isEmpty()) {
+        return nullptr;
+    }
+
+    return std::unique_ptr<FrameCache>(
+                new FrameCache(std::move(animation), mode, byte_budget, size));
+}
+
+FrameCache::FrameCache(sk_sp<skottie::Animation> animation, Mode mode, size_t byte_budget,
+                       const SkISize& raster_size)
+    : fAnimation(std::move(animation))
+    , fMode(mode)
+    , fBudget(byte_budget)
+    , fRasterSize(raster_size)
+    , fFrameCount(std::max(1, static_cast<int>(std::ceil(fAnimation->duration() *
+                                                         fAnimation->fps())))) {}
+
+FrameCache::~FrameCache() = default;
+
+int FrameCache::frameIndex(double t) const {
+    const double duration = fAnimation->duration();
+
+    t = std::fmod(t, duration);
+    if (t < 0) {
+        t += duration;
+    }
+
+    return SkTPin(static_cast<int>(t * fAnimation->fps()), 0, fFrameCount - 1);
+}
+
+FrameCache::Frame FrameCache::makeFrame() const {
+    Frame frame;
+
+    switch (fMode) {
+    case Mode::kPicture: {
+        SkPictureRecorder recorder;
+        fAnimation->render(recorder.beginRecording(SkRect::MakeSize(fAnimation->size())));
+        frame.fPicture = recorder.finishRecordingAsPicture();
+    } break;
+    case Mode::kRaster: {
+        auto surface = SkSurface::MakeRasterN32Premul(fRasterSize.width(), fRasterSize.height());
+        if (surface) {
+            const auto dst = SkRect::Make(fRasterSize);
+            fAnimation->render(surface->getCanvas(), &dst);
+            frame.fImage = surface->makeImageSnapshot();
+        }
+    } break;
+    }
+
+    return frame;
+}
+
+void FrameCache::drawFrame(SkCanvas* canvas, const Frame& frame, const SkRect* dst) const {
+    const auto src = SkRect::MakeSize(fAnimation->size());
+    const auto matrix = dst ? SkMatrix::MakeRectToRect(src, *dst, SkMatrix::kCenter_ScaleToFit)
+                            : SkMatrix::I();
+
+    if (frame.fPicture) {
+        canvas->drawPicture(frame.fPicture, &matrix, nullptr);
+    } else if (frame.fImage) {
+        // Raster frames are pre-scaled to fit fRasterSize (matching Animation::render).
+        const auto raster_matrix = SkMatrix::MakeRectToRect(src, SkRect::Make(fRasterSize),
+                                                            SkMatrix::kCenter_ScaleToFit);
+        SkPaint paint;
+        paint.setFilterQuality(kLow_SkFilterQuality);
+        canvas->drawImageRect(frame.fImage,
+                              raster_matrix.mapRect(src),
+                              matrix.mapRect(src),
+                              &paint);
+    }
+}
+
+void FrameCache::render(SkCanvas* canvas, double t, const SkRect* dst) {
+    const auto index = this->frameIndex(t);
+
+    if (const auto* frame = fFrames.find(index)) {
+        fStats.fHits++;
+        this->drawFrame(canvas, *frame, dst);
+        return;
+    }
+
+    fStats.fMisses++;
+    fAnimation->seekFrameTime(index / fAnimation->fps());
+
+    if (fStats.fBytesUsed >= fBudget) {
+        // Budget exhausted: stop admitting frames.
+        fAnimation->render(canvas, dst);
+        return;
+    }
+
+    auto frame = this->makeFrame();
+    const auto frame_bytes = frame.fPicture ? frame.fPicture->approximateBytesUsed()
+                           : frame.fImage   ? frame.fImage->imageInfo().computeMinByteSize()
+                                            : 0;
+
+    this->drawFrame(canvas, frame, dst);
+
+    if (frame_bytes && fStats.fBytesUsed + frame_bytes <= fBudget) {
+        fFrames.set(index, std::move(frame));
+        fStats.fFrameCount++;
+        fStats.fBytesUsed += frame_bytes;
+    }
+}
+
+void FrameCache::purge() {
+    fFrames.reset();
+    fStats = Stats();
+}
+
 } // namespace skottie_utils
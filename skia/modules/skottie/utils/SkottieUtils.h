@@ -9,6 +9,7 @@
 #define SkottieUtils_DEFINED
 
 #include "include/core/SkColor.h"
+#include "include/core/SkSize.h"
 #include "include/core/SkString.h"
 #include "include/private/SkTHash.h"
 #include "modules/skottie/include/Skottie.h"
@@ -20,8 +21,10 @@
 #include <vector>
 
 class SkAnimCodecPlayer;
+class SkCanvas;
 class SkData;
 class SkImage;
+class SkPicture;
 
 namespace skottie_utils {
 
@@ -145,6 +148,76 @@ private:
     std::vector<MarkerInfo>                   fMarkers;
 };
 
+/**
+ * Frame cache for looping animations.
+ *
+ * Frame times are quantized to the animation frame rate.  Each distinct frame is rendered
+ * once, and subsequent loops replay it from the cache without ticking the animation --
+ * either as an SkPicture (resolution independent, typically smaller) or as a raster SkImage
+ * (blit cost at playback).
+ *
+ * Cached frames are never evicted: for cyclic access patterns, LRU eviction would produce
+ * no hits at all as soon as the loop outgrows the budget.  Instead, frames are admitted
+ * until the budget is exhausted, and the remaining ones are rendered directly.
+ */
+class FrameCache final {
+public:
+    enum class Mode {
+        kPicture,
+        kRaster,
+    };
+
+    struct Stats {
+        size_t fHits       = 0,
+               fMisses     = 0,
+               fFrameCount = 0, // Number of cached frames.
+               fBytesUsed  = 0; // Memory used by cached frames.
+    };
+
+    /**
+     * @param raster_size  Frame resolution for kRaster mode, typically matching the
+     *                     destination size in device pixels (defaults to the animation size).
+     */
+    static std::unique_ptr<FrameCache> Make(sk_sp<skottie::Animation>, Mode,
+                                            size_t byte_budget,
+                                            const SkISize& raster_size = SkISize::MakeEmpty());
+    ~FrameCache();
+
+    /**
+     * Draws the animation frame for time |t| (in seconds, wrapped to the animation duration),
+     * from the cache when possible.
+     */
+    void render(SkCanvas*, double t, const SkRect* dst = nullptr);
+
+    const Stats& stats() const { return fStats; }
+
+    /**
+     * Drops all cached frames (and resets stats), e.g. after animation property changes.
+     */
+    void purge();
+
+private:
+    struct Frame {
+        sk_sp<SkPicture> fPicture;
+        sk_sp<SkImage>   fImage;
+    };
+
+    FrameCache(sk_sp<skottie::Animation>, Mode, size_t byte_budget, const SkISize& raster_size);
+
+    int frameIndex(double t) const;
+    Frame makeFrame() const;
+    void drawFrame(SkCanvas*, const Frame&, const SkRect* dst) const;
+
+    const sk_sp<skottie::Animation> fAnimation;
+    const Mode                      fMode;
+    const size_t                    fBudget;
+    const SkISize                   fRasterSize;
+    const int                       fFrameCount;
+
+    SkTHashMap<int, Frame>          fFrames;
+    Stats                           fStats;
+};
+
 } // namespace skottie_utils
 
 #endif // SkottieUtils_DEFINED
@@ -2,9 +2,14 @@
 #ifndef ParagraphCache_DEFINED
 #define ParagraphCache_DEFINED
 
+#include "include/core/SkFont.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkString.h"
 #include "include/private/SkMutex.h"
 #include "src/core/SkLRUCache.h"
 
+#include <vector>
+
 #define PARAGRAPH_CACHE_STATS
 
 namespace skia {
@@ -35,6 +40,68 @@ class ParagraphCacheValue;
 
 bool operator==(const ParagraphCacheKey& a, const ParagraphCacheKey& b);
 
+// Second cache level: individually shaped runs, keyed on the run text, the text around it
+// that the shaper sees as context, and all the other shaping inputs.  Left-to-right runs are
+// cached word by word (split at word boundaries next to whitespace), so editing a word only
+// misses on the words around the edit.  Unlike paragraph entries, runs are shared across
+// paragraphs: editing a paragraph, or laying out different paragraphs with repeated
+// words/labels, mostly hits this cache.
+// Safe for concurrent use.
+class ShapedRunCache {
+public:
+    struct Key {
+        SkString      fText;
+        // Up to kContextLength code points before and after the run.
+        SkString      fPreContext;
+        SkString      fPostContext;
+        SkFont        fFont;
+        SkString      fLanguage;
+        SkFourByteTag fScript;
+        uint8_t       fBidiLevel;
+
+        bool operator==(const Key& other) const;
+    };
+
+    // Shaping results, relative to the run origin (positions) and run text start (clusters).
+    struct Value : public SkNVRefCnt<Value> {
+        SkVector               fAdvance;
+        std::vector<SkGlyphID> fGlyphs;
+        std::vector<SkPoint>   fPositions;
+        std::vector<uint32_t>  fClusters;
+    };
+
+    // HarfBuzz keeps this many code points of the text around a run as shaping context
+    // (HB_BUFFER_CONTEXT_LENGTH).  Shaping a run with this much context on either side gives
+    // the same result as shaping it as part of the whole paragraph.
+    static constexpr int kContextLength = 5;
+
+    ShapedRunCache();
+
+    sk_sp<const Value> find(const Key& key);
+    void insert(const Key& key, sk_sp<const Value> value);
+
+    void reset();
+    void printStatistics();
+    void turnOn(bool value);
+    int count();
+
+private:
+    static const int kMaxEntries = 1024;
+
+    struct KeyHash {
+        uint32_t operator()(const Key& key) const;
+    };
+
+    SkMutex fRunMutex;
+    SkLRUCache<Key, sk_sp<const Value>, KeyHash> fLRUCacheMap;
+    bool fCacheIsOn;
+
+#ifdef PARAGRAPH_CACHE_STATS
+    int fTotalRequests;
+    int fCacheMisses;
+#endif
+};
+
 class ParagraphCache {
 public:
     ParagraphCache();
@@ -50,9 +117,11 @@ public:
         fChecker = std::move(checker);
     }
     void printStatistics();
-    void turnOn(bool value) { fCacheIsOn = value; }
+    void turnOn(bool value) { fCacheIsOn = value; fRunCache.turnOn(value); }
     int count() { return fLRUCacheMap.count(); }
 
+    ShapedRunCache* getRunCache() { return &fRunCache; }
+
  private:
 
     struct Entry;
@@ -72,6 +141,8 @@ public:
     SkLRUCache<ParagraphCacheKey, std::unique_ptr<Entry>, KeyHash> fLRUCacheMap;
     bool fCacheIsOn;
 
+    ShapedRunCache fRunCache;
+
 #ifdef PARAGRAPH_CACHE_STATS
     int fTotalRequests;
     int fCacheMisses;
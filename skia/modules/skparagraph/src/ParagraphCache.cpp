@@ -1,5 +1,6 @@
 // Copyright 2019 Google LLC.
 #include "modules/skparagraph/include/ParagraphCache.h"
+#include "include/private/SkChecksum.h"
 #include "modules/skparagraph/src/ParagraphImpl.h"
 
 namespace skia {
@@ -116,6 +117,98 @@ bool operator==(const ParagraphCacheKey& a, const ParagraphCacheKey& b) {
     return true;
 }
 
+bool ShapedRunCache::Key::operator==(const Key& other) const {
+    return fBidiLevel == other.fBidiLevel &&
+           fScript    == other.fScript    &&
+           fFont      == other.fFont      &&
+           fText      == other.fText      &&
+           fPreContext  == other.fPreContext  &&
+           fPostContext == other.fPostContext &&
+           fLanguage  == other.fLanguage;
+}
+
+uint32_t ShapedRunCache::KeyHash::operator()(const Key& key) const {
+    uint32_t hash = SkGoodHash()(key.fText);
+    hash = SkChecksum::Mix(hash ^ SkGoodHash()(key.fPreContext));
+    hash = SkChecksum::Mix(hash ^ SkGoodHash()(key.fPostContext));
+    hash = SkChecksum::Mix(hash ^ SkGoodHash()(key.fLanguage));
+    hash = SkChecksum::Mix(hash ^ key.fScript);
+    hash = SkChecksum::Mix(hash ^ key.fBidiLevel);
+    hash = SkChecksum::Mix(hash ^ SkGoodHash()(key.fFont.getSize()));
+    if (key.fFont.getTypeface() != nullptr) {
+        hash = SkChecksum::Mix(hash ^ key.fFont.getTypeface()->uniqueID());
+    }
+    return hash;
+}
+
+ShapedRunCache::ShapedRunCache()
+    : fLRUCacheMap(kMaxEntries)
+    , fCacheIsOn(true)
+#ifdef PARAGRAPH_CACHE_STATS
+    , fTotalRequests(0)
+    , fCacheMisses(0)
+#endif
+{ }
+
+sk_sp<const ShapedRunCache::Value> ShapedRunCache::find(const Key& key) {
+    SkAutoMutexExclusive lock(fRunMutex);
+    if (!fCacheIsOn) {
+        return nullptr;
+    }
+#ifdef PARAGRAPH_CACHE_STATS
+    ++fTotalRequests;
+#endif
+    // Values are immutable: we hand out a ref and don't need to hold the lock while copying.
+    sk_sp<const Value>* value = fLRUCacheMap.find(key);
+    if (!value) {
+#ifdef PARAGRAPH_CACHE_STATS
+        ++fCacheMisses;
+#endif
+        return nullptr;
+    }
+    return *value;
+}
+
+void ShapedRunCache::insert(const Key& key, sk_sp<const Value> value) {
+    SkAutoMutexExclusive lock(fRunMutex);
+    if (!fCacheIsOn) {
+        return;
+    }
+    if (!fLRUCacheMap.find(key)) {
+        fLRUCacheMap.insert(key, std::move(value));
+    }
+}
+
+void ShapedRunCache::reset() {
+    SkAutoMutexExclusive lock(fRunMutex);
+#ifdef PARAGRAPH_CACHE_STATS
+    fTotalRequests = 0;
+    fCacheMisses = 0;
+#endif
+    fLRUCacheMap.reset();
+}
+
+void ShapedRunCache::turnOn(bool value) {
+    SkAutoMutexExclusive lock(fRunMutex);
+    fCacheIsOn = value;
+}
+
+int ShapedRunCache::count() {
+    SkAutoMutexExclusive lock(fRunMutex);
+    return fLRUCacheMap.count();
+}
+
+void ShapedRunCache::printStatistics() {
+#ifdef PARAGRAPH_CACHE_STATS
+    SkAutoMutexExclusive lock(fRunMutex);
+    SkDebugf("--- Shaped Run Cache ---\n");
+    SkDebugf("Total requests: %d\n", fTotalRequests);
+    SkDebugf("Cache misses: %d\n", fCacheMisses);
+    SkDebugf("Cache miss %%: %f\n", (fTotalRequests > 0) ? 100.f * fCacheMisses / fTotalRequests : 0.f);
+    SkDebugf("---------------------\n");
+#endif
+}
+
 struct ParagraphCache::Entry {
 
     Entry(ParagraphCacheValue* value) : fValue(value) {}
@@ -176,6 +269,7 @@ void ParagraphCache::printStatistics() {
     int cacheHits = fTotalRequests - fCacheMisses;
     SkDebugf("Hash miss %%: %f\n", (cacheHits > 0) ? 100.f * fHashMisses / cacheHits : 0.f);
     SkDebugf("---------------------\n");
+    fRunCache.printStatistics();
 }
 
 void ParagraphCache::abandon() {
@@ -194,6 +288,7 @@ void ParagraphCache::reset() {
     fHashMisses = 0;
 #endif
     fLRUCacheMap.reset();
+    fRunCache.reset();
 }
 
 bool ParagraphCache::findParagraph(ParagraphImpl* paragraph) {
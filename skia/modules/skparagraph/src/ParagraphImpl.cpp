@@ -1,6 +1,7 @@
 // Copyright 2019 Google LLC.
 #include "modules/skparagraph/src/ParagraphImpl.h"
 #include <unicode/brkiter.h>
+#include <unicode/uchar.h>
 #include <unicode/ubidi.h>
 #include <unicode/unistr.h>
 #include <unicode/urename.h>
@@ -323,11 +324,48 @@ bool ParagraphImpl::shapeTextIntoEndlessLine() {
         explicit ShapeHandler(ParagraphImpl& paragraph, FontIterator* fontIterator)
                 : fParagraph(&paragraph)
                 , fFontIterator(fontIterator)
-                , fAdvance(SkVector::Make(0, 0)) {}
+                , fAdvance(SkVector::Make(0, 0))
+                , fTextOffset(0) {}
 
         SkVector advance() const { return fAdvance; }
 
+        // Runs are shaped one at a time, from a window of the text around the run: the shaper
+        // sees the window text starting at |offset|, and only the run in |keep| is added.
+        void setTextOffset(size_t offset, TextRange keep) {
+            fTextOffset = offset;
+            fKeep = keep;
+        }
+
+        // Appends a run from cached shaping results.
+        void addRun(const SkShaper::RunHandler::RunInfo& info,
+                    const ShapedRunCache::Value& value) {
+            auto& run = this->newRun(info);
+            SkASSERT(run.size() == value.fGlyphs.size());
+            for (size_t i = 0; i < value.fGlyphs.size(); ++i) {
+                run.fGlyphs[i] = value.fGlyphs[i];
+                run.fPositions[i] = value.fPositions[i] + run.fOffset;
+                run.fClusterIndexes[i] = value.fClusters[i] + fTextOffset;
+            }
+            fAdvance.fX += run.advance().fX;
+            fAdvance.fY = SkMaxScalar(fAdvance.fY, run.advance().fY);
+        }
+
     private:
+        Run& newRun(const RunInfo& info) {
+            const RunInfo paragraphInfo = {
+                info.fFont,
+                info.fBidiLevel,
+                info.fAdvance,
+                info.glyphCount,
+                Range(info.utf8Range.begin() + fTextOffset, info.utf8Range.size())
+            };
+            return fParagraph->fRuns.emplace_back(fParagraph,
+                                                  paragraphInfo,
+                                                  fFontIterator->currentLineHeight(),
+                                                  fParagraph->fRuns.count(),
+                                                  fAdvance.fX);
+        }
+
         void beginLine() override {}
 
         void runInfo(const RunInfo&) override {}
@@ -335,20 +373,20 @@ bool ParagraphImpl::shapeTextIntoEndlessLine() {
         void commitRunInfo() override {}
 
         Buffer runBuffer(const RunInfo& info) override {
-            auto& run = fParagraph->fRuns.emplace_back(fParagraph,
-                                                       info,
-                                                       fFontIterator->currentLineHeight(),
-                                                       fParagraph->fRuns.count(),
-                                                       fAdvance.fX);
-            return run.newRunBuffer();
+            return this->newRun(info).newRunBuffer();
         }
 
         void commitRunBuffer(const RunInfo&) override {
             auto& run = fParagraph->fRuns.back();
-            if (run.size() == 0) {
+            // Runs shaped from the context around the run are only there for the shaper
+            if (run.size() == 0 || !(run.fTextRange == fKeep)) {
                 fParagraph->fRuns.pop_back();
                 return;
             }
+            // Shaped clusters are relative to the run text
+            for (size_t i = 0; i < run.size(); ++i) {
+                run.fClusterIndexes[i] += fTextOffset;
+            }
             // Carve out the line text out of the entire run text
             fAdvance.fX += run.advance().fX;
             fAdvance.fY = SkMaxScalar(fAdvance.fY, run.advance().fY);
@@ -359,6 +397,89 @@ bool ParagraphImpl::shapeTextIntoEndlessLine() {
         ParagraphImpl* fParagraph;
         FontIterator* fFontIterator;
         SkVector fAdvance;
+        size_t fTextOffset;
+        TextRange fKeep;
+    };
+
+    // Splits the text window a run is shaped from into the context before the run, the run
+    // and the context after it.
+    class WindowFontRunIterator final : public SkShaper::FontRunIterator {
+    public:
+        WindowFontRunIterator(const SkFont& font, size_t runStart, size_t runEnd, size_t end)
+                : fFont(font), fEnds{runStart, runEnd, end}, fCurrent(0), fConsumed(0) {}
+
+        void consume() override {
+            while (fConsumed < 3 && fEnds[fConsumed] <= fCurrent) {
+                ++fConsumed;
+            }
+            SkASSERT(fConsumed < 3);
+            fCurrent = fEnds[fConsumed];
+        }
+        size_t endOfCurrentRun() const override { return fCurrent; }
+        bool atEnd() const override { return fCurrent == fEnds[2]; }
+        const SkFont& currentFont() const override { return fFont; }
+
+    private:
+        SkFont fFont;
+        size_t fEnds[3];
+        size_t fCurrent;
+        int fConsumed;
+    };
+
+    // Captures the shaping results of the run in |keep| (relative to the shaped text), to be
+    // shared via the cache.
+    class RunCapture final : public SkShaper::RunHandler {
+    public:
+        explicit RunCapture(TextRange keep) : fKeep(keep), fKeptRuns(0), fKeeping(false) {}
+
+        // The results, or null unless the shaper returned the kept text as exactly one run.
+        sk_sp<const ShapedRunCache::Value> detach() {
+            return fKeptRuns == 1 ? std::move(fValue) : nullptr;
+        }
+
+    private:
+        void beginLine() override {}
+
+        void runInfo(const RunInfo&) override {}
+
+        void commitRunInfo() override {}
+
+        Buffer runBuffer(const RunInfo& info) override {
+            fKeeping = info.utf8Range.begin() == fKeep.start &&
+                       info.utf8Range.end() == fKeep.end;
+            if (!fKeeping) {
+                fContextGlyphs.resize(info.glyphCount);
+                fContextPositions.resize(info.glyphCount);
+                return {fContextGlyphs.data(), fContextPositions.data(), nullptr, nullptr, {0, 0}};
+            }
+            ++fKeptRuns;
+            fValue = sk_make_sp<ShapedRunCache::Value>();
+            fValue->fAdvance = info.fAdvance;
+            fValue->fGlyphs.resize(info.glyphCount);
+            fValue->fPositions.resize(info.glyphCount);
+            fValue->fClusters.resize(info.glyphCount);
+            return {fValue->fGlyphs.data(), fValue->fPositions.data(), nullptr,
+                    fValue->fClusters.data(), {0, 0}};
+        }
+
+        void commitRunBuffer(const RunInfo&) override {
+            if (!fKeeping) {
+                return;
+            }
+            // Shaped clusters are relative to the shaped text
+            for (auto& cluster : fValue->fClusters) {
+                cluster -= fKeep.start;
+            }
+        }
+
+        void commitLine() override {}
+
+        TextRange fKeep;
+        int fKeptRuns;
+        bool fKeeping;
+        sk_sp<ShapedRunCache::Value> fValue;
+        std::vector<SkGlyphID> fContextGlyphs;
+        std::vector<SkPoint> fContextPositions;
     };
 
     if (fTextSpan.empty()) {
@@ -384,8 +505,164 @@ bool ParagraphImpl::shapeTextIntoEndlessLine() {
         }
         auto script = SkShaper::MakeHbIcuScriptRunIterator(fTextSpan.begin(), fTextSpan.size());
 
-        shaper->shape(fTextSpan.begin(), fTextSpan.size(), font, *bidi, *script, lang,
-                      std::numeric_limits<SkScalar>::max(), &handler);
+        // Split the text into runs ourselves (same as the shaper would), so that each run can
+        // be looked up in (or added to) the run cache independently.
+        auto* runCache = fFontCollection->getParagraphCache()->getRunCache();
+        SkShaper::RunIterator* iterators[] = { &font, bidi.get(), script.get(), &lang };
+        for (auto* iterator : iterators) {
+            iterator->consume();
+        }
+
+        // The text the shaper would see around a piece of the paragraph
+        auto contextBegin = [this](size_t start) {
+            const char* begin = fTextSpan.begin() + start;
+            for (int i = 0; i < ShapedRunCache::kContextLength && begin > fTextSpan.begin(); ++i) {
+                do {
+                    --begin;
+                } while (begin > fTextSpan.begin() && (*begin & 0xC0) == 0x80);
+            }
+            return begin;
+        };
+        auto contextEnd = [this](size_t end) {
+            const char* ptr = fTextSpan.begin() + end;
+            for (int i = 0; i < ShapedRunCache::kContextLength && ptr < fTextSpan.end(); ++i) {
+                SkUTF::NextUTF8(&ptr, fTextSpan.end());
+            }
+            return ptr;
+        };
+
+        // Runs are cached word by word.  Only word boundaries next to whitespace are used:
+        // glyphs do not interact across those, while words without spaces in between (as in
+        // Thai or CJK text) may still be shaped together.
+        TextBreaker words;
+        const bool splitWords = words.initialize(fTextSpan, UBRK_WORD);
+        size_t wordBreak = splitWords ? words.first() : fTextSpan.size();
+        auto isWhitespaceBoundary = [this](size_t pos) {
+            const char* next = fTextSpan.begin() + pos;
+            const char* prev = next;
+            do {
+                --prev;
+            } while (prev > fTextSpan.begin() && (*prev & 0xC0) == 0x80);
+            return u_isUWhiteSpace(SkUTF::NextUTF8(&prev, fTextSpan.end())) ||
+                   u_isUWhiteSpace(SkUTF::NextUTF8(&next, fTextSpan.end()));
+        };
+
+        // Looks up the shaping results of a piece of the current run, shaping and caching it
+        // on a miss.
+        auto shapeSegment = [&](size_t start, size_t end) -> sk_sp<const ShapedRunCache::Value> {
+            const char* windowBegin = contextBegin(start);
+            const char* windowEnd = contextEnd(end);
+            ShapedRunCache::Key key = {
+                SkString(fTextSpan.begin() + start, end - start),
+                SkString(windowBegin, fTextSpan.begin() + start - windowBegin),
+                SkString(fTextSpan.begin() + end, windowEnd - (fTextSpan.begin() + end)),
+                font.currentFont(),
+                SkString(lang.currentLanguage()),
+                script->currentScript(),
+                bidi->currentLevel()
+            };
+            if (auto value = runCache->find(key)) {
+                return value;
+            }
+
+            // Only the piece is kept, but HarfBuzz takes the text around it as context
+            // (joining, contextual forms, kerning across the boundary).
+            const size_t windowStart = windowBegin - fTextSpan.begin();
+            const auto windowLength = windowEnd - windowBegin;
+            WindowFontRunIterator runFont(key.fFont, start - windowStart, end - windowStart,
+                                          windowLength);
+            SkShaper::TrivialBiDiRunIterator runBidi(key.fBidiLevel, windowLength);
+            SkShaper::TrivialScriptRunIterator runScript(key.fScript, windowLength);
+            SkShaper::TrivialLanguageRunIterator runLang(key.fLanguage.c_str(), windowLength);
+            RunCapture capture(TextRange(start - windowStart, end - windowStart));
+            shaper->shape(windowBegin, windowLength,
+                          runFont, runBidi, runScript, runLang,
+                          std::numeric_limits<SkScalar>::max(), &capture);
+            auto value = capture.detach();
+            if (value) {
+                runCache->insert(key, value);
+            }
+            return value;
+        };
+
+        size_t runStart = 0;
+        while (runStart < fTextSpan.size()) {
+            size_t runEnd = fTextSpan.size();
+            for (auto* iterator : iterators) {
+                runEnd = std::min(runEnd, iterator->endOfCurrentRun());
+            }
+            if (runEnd <= runStart) {
+                // Should not happen with well behaved iterators
+                break;
+            }
+
+            // Each word of the run is looked up separately, so that editing one word only
+            // reshapes the words within the shaping context of the edit.  The words are then
+            // put back together into a single run.  Right-to-left runs are shaped in visual
+            // order, so they are looked up as a whole.
+            const bool rtl = (bidi->currentLevel() & 1) != 0;
+            auto value = sk_make_sp<ShapedRunCache::Value>();
+            size_t segmentStart = runStart;
+            while (segmentStart < runEnd) {
+                while (wordBreak <= segmentStart ||
+                       (wordBreak < runEnd && !isWhitespaceBoundary(wordBreak))) {
+                    wordBreak = words.next();
+                }
+                const size_t segmentEnd = rtl ? runEnd : std::min(runEnd, wordBreak);
+                auto segment = shapeSegment(segmentStart, segmentEnd);
+                if (!segment) {
+                    value = nullptr;
+                    break;
+                }
+                for (size_t i = 0; i < segment->fGlyphs.size(); ++i) {
+                    value->fGlyphs.push_back(segment->fGlyphs[i]);
+                    value->fPositions.push_back(segment->fPositions[i] +
+                                                SkVector::Make(value->fAdvance.fX, 0));
+                    value->fClusters.push_back(segment->fClusters[i] + segmentStart - runStart);
+                }
+                value->fAdvance.fX += segment->fAdvance.fX;
+                value->fAdvance.fY = SkMaxScalar(value->fAdvance.fY, segment->fAdvance.fY);
+                segmentStart = segmentEnd;
+            }
+
+            if (value) {
+                handler.setTextOffset(runStart, TextRange(runStart, runEnd));
+                const SkShaper::RunHandler::RunInfo info = {
+                    font.currentFont(),
+                    bidi->currentLevel(),
+                    value->fAdvance,
+                    value->fGlyphs.size(),
+                    SkShaper::RunHandler::Range(0, runEnd - runStart)
+                };
+                handler.addRun(info, *value);
+            } else {
+                // The shaper did not return a word as a single run (which the cache cannot
+                // represent): shape the whole run in place, with its context.
+                const char* windowBegin = contextBegin(runStart);
+                const char* windowEnd = contextEnd(runEnd);
+                const size_t windowStart = windowBegin - fTextSpan.begin();
+                const auto windowLength = windowEnd - windowBegin;
+                WindowFontRunIterator runFont(font.currentFont(), runStart - windowStart,
+                                              runEnd - windowStart, windowLength);
+                SkShaper::TrivialBiDiRunIterator runBidi(bidi->currentLevel(), windowLength);
+                SkShaper::TrivialScriptRunIterator runScript(script->currentScript(),
+                                                             windowLength);
+                SkShaper::TrivialLanguageRunIterator runLang(lang.currentLanguage(),
+                                                             windowLength);
+
+                handler.setTextOffset(windowStart, TextRange(runStart, runEnd));
+                shaper->shape(windowBegin, windowLength,
+                              runFont, runBidi, runScript, runLang,
+                              std::numeric_limits<SkScalar>::max(), &handler);
+            }
+
+            runStart = runEnd;
+            for (auto* iterator : iterators) {
+                if (iterator->endOfCurrentRun() == runEnd && !iterator->atEnd()) {
+                    iterator->consume();
+                }
+            }
+        }
     }
 
     if (fParagraphStyle.getTextAlign() == TextAlign::kJustify) {
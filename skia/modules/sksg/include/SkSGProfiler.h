@@ -0,0 +1,129 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkSGProfiler_DEFINED
+#define SkSGProfiler_DEFINED
+
+#include "include/core/SkRect.h"
+#include "include/core/SkString.h"
+#include "include/core/SkTypes.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace sksg {
+
+class Animator;
+class Node;
+
+/**
+ * Collects scene graph costs while attached to a Scene (see Scene::setProfiler()):
+ *
+ *   - per-node revalidation time, self (onRevalidate minus descendants) and total
+ *   - per-animator tick time, self (minus nested animators) and total
+ *   - per-node invalidation counts
+ *
+ * Nodes and animators are identified by address, plus bounds for nodes.  Only the thread
+ * driving the scene is instrumented; a detached profiler adds no overhead beyond a
+ * thread-local check per revalidated node and animator tick.
+ */
+class Profiler final {
+public:
+    struct NodeStats {
+        const Node* fNode           = nullptr;
+        SkRect      fBounds         = SkRect::MakeEmpty(); // As of the last revalidation.
+        double      fSelfMS         = 0,
+                    fTotalMS        = 0;
+        uint32_t    fRevalidations  = 0,
+                    fInvalidations  = 0;
+    };
+
+    struct AnimatorStats {
+        const Animator* fAnimator = nullptr;
+        double          fSelfMS   = 0,
+                        fTotalMS  = 0;
+        uint32_t        fTicks    = 0;
+    };
+
+    Profiler();
+    ~Profiler();
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    void reset();
+
+    // Number of Scene::animate() calls observed.
+    size_t frameCount() const { return fFrameCount; }
+
+    // Top-level totals, over all observed frames.
+    double revalidateMS() const { return fRevalidateMS; }
+    double tickMS()       const { return fTickMS; }
+
+    // The |count| most expensive nodes/animators, by descending self time.
+    std::vector<NodeStats>     topNodes(size_t count) const;
+    std::vector<AnimatorStats> topAnimators(size_t count) const;
+
+    // Human readable summary of the top |count| offenders.
+    SkString report(size_t count = 10) const;
+
+private:
+    friend class Animator;
+    friend class Node;
+    friend class Scene;
+
+    // Installs a profiler for the current thread, for the scope lifetime.
+    class ScopedActivation {
+    public:
+        explicit ScopedActivation(Profiler*);
+        ~ScopedActivation();
+
+    private:
+        Profiler* fPrev;
+    };
+
+    class NodeScope {
+    public:
+        NodeScope(const Node*, const SkRect* bounds);
+        ~NodeScope();
+
+    private:
+        Profiler*     fProfiler;
+        const Node*   fNode;
+        const SkRect* fBounds;
+        double        fStart;
+    };
+
+    class AnimatorScope {
+    public:
+        explicit AnimatorScope(const Animator*);
+        ~AnimatorScope();
+
+    private:
+        Profiler*       fProfiler;
+        const Animator* fAnimator;
+        double          fStart;
+    };
+
+    static void RecordInvalidation(const Node*);
+
+    void beginFrame() { fFrameCount++; }
+    double enter();
+    // Computes the total and self (minus nested scopes) time of the scope started at |start|.
+    void exit(double start, double* totalMS, double* selfMS);
+
+    std::unordered_map<const Node*, NodeStats>         fNodes;
+    std::unordered_map<const Animator*, AnimatorStats> fAnimators;
+    std::vector<double>                                fChildTimes; // Nesting stack (ns).
+    size_t                                             fFrameCount   = 0;
+    double                                             fRevalidateMS = 0,
+                                                       fTickMS       = 0;
+};
+
+} // namespace sksg
+
+#endif // SkSGProfiler_DEFINED
@@ -20,6 +20,7 @@ struct SkPoint;
 namespace sksg {
 
 class InvalidationController;
+class Profiler;
 class RenderNode;
 
 /**
@@ -71,11 +72,16 @@ public:
     void animate(float t, InvalidationController* = nullptr);
     const RenderNode* nodeAt(const SkPoint&) const;
 
+    // Attaches a profiler (not owned) to collect revalidation and animation costs in
+    // subsequent animate()/render() calls.  Pass nullptr to detach.
+    void setProfiler(Profiler* profiler) { fProfiler = profiler; }
+
 private:
     Scene(sk_sp<RenderNode> root, AnimatorList&& animators);
 
     const sk_sp<RenderNode> fRoot;
     const AnimatorList      fAnimators;
+    Profiler*               fProfiler = nullptr;
 };
 
 } // namespace sksg
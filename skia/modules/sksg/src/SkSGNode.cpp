@@ -7,6 +7,7 @@
 
 #include "modules/sksg/include/SkSGInvalidationController.h"
 #include "modules/sksg/include/SkSGNode.h"
+#include "modules/sksg/include/SkSGProfiler.h"
 #include "src/core/SkRectPriv.h"
 
 #include <algorithm>
@@ -116,6 +117,8 @@ void Node::invalidate(bool damageBubbling) {
         return;
     }
 
+    Profiler::RecordInvalidation(this);
+
     if (damageBubbling && !(fInvalTraits & kBubbleDamage_Trait)) {
         // Found a damage observer.
         fFlags |= kDamage_Flag;
@@ -136,6 +139,8 @@ const SkRect& Node::revalidate(InvalidationController* ic, const SkMatrix& ctm)
         return fBounds;
     }
 
+    Profiler::NodeScope profile_scope(this, &fBounds);
+
     const auto generate_damage =
             ic && ((fFlags & kDamage_Flag) || (fInvalTraits & kOverrideDamage_Trait));
     if (!generate_damage) {
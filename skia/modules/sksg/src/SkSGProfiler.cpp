@@ -0,0 +1,171 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "modules/sksg/include/SkSGProfiler.h"
+
+#include "include/core/SkTime.h"
+
+#include <algorithm>
+
+namespace sksg {
+
+namespace {
+
+thread_local Profiler* gActiveProfiler = nullptr;
+
+template <typename Stats, typename Key>
+std::vector<Stats> top_by_self_time(const std::unordered_map<Key, Stats>& map, size_t count) {
+    std::vector<Stats> stats;
+    stats.reserve(map.size());
+    for (const auto& entry : map) {
+        stats.push_back(entry.second);
+    }
+
+    count = std::min(count, stats.size());
+    std::partial_sort(stats.begin(), stats.begin() + count, stats.end(),
+                      [](const Stats& a, const Stats& b) { return a.fSelfMS > b.fSelfMS; });
+    stats.resize(count);
+
+    return stats;
+}
+
+} // namespace
+
+Profiler::Profiler()  = default;
+Profiler::~Profiler() = default;
+
+void Profiler::reset() {
+    SkASSERT(fChildTimes.empty());
+    fNodes.clear();
+    fAnimators.clear();
+    fFrameCount   = 0;
+    fRevalidateMS = 0;
+    fTickMS       = 0;
+}
+
+std::vector<Profiler::NodeStats> Profiler::topNodes(size_t count) const {
+    return top_by_self_time(fNodes, count);
+}
+
+std::vector<Profiler::AnimatorStats> Profiler::topAnimators(size_t count) const {
+    return top_by_self_time(fAnimators, count);
+}
+
+SkString Profiler::report(size_t count) const {
+    SkString report;
+    report.appendf("sksg profile: %zu frames, %.3fms tick, %.3fms revalidate (%zu animators, "
+                   "%zu nodes)\n",
+                   fFrameCount, fTickMS, fRevalidateMS, fAnimators.size(), fNodes.size());
+
+    const double frames = std::max<size_t>(fFrameCount, 1);
+
+    report.append("  Animators, by self tick time:\n"
+                  "      self ms  total ms   ms/frame     ticks  animator\n");
+    for (const auto& a : this->topAnimators(count)) {
+        report.appendf("    %9.3f %9.3f %10.4f %9u  %p\n",
+                       a.fSelfMS, a.fTotalMS, a.fSelfMS / frames, a.fTicks, a.fAnimator);
+    }
+
+    report.append("  Nodes, by self revalidation time:\n"
+                  "      self ms  total ms   ms/frame    revals    invals  node"
+                  "                bounds\n");
+    for (const auto& n : this->topNodes(count)) {
+        report.appendf("    %9.3f %9.3f %10.4f %9u %9u  %-18p  [%g %g %g %g]\n",
+                       n.fSelfMS, n.fTotalMS, n.fSelfMS / frames,
+                       n.fRevalidations, n.fInvalidations, n.fNode,
+                       n.fBounds.left(), n.fBounds.top(), n.fBounds.right(), n.fBounds.bottom());
+    }
+
+    return report;
+}
+
+double Profiler::enter() {
+    fChildTimes.push_back(0);
+    return SkTime::GetNSecs();
+}
+
+void Profiler::exit(double start, double* totalMS, double* selfMS) {
+    SkASSERT(!fChildTimes.empty());
+    const auto total = SkTime::GetNSecs() - start,
+               child = fChildTimes.back();
+    fChildTimes.pop_back();
+    if (!fChildTimes.empty()) {
+        fChildTimes.back() += total;
+    }
+
+    *totalMS = total * 1e-6;
+    *selfMS  = (total - child) * 1e-6;
+}
+
+void Profiler::RecordInvalidation(const Node* node) {
+    if (auto* profiler = gActiveProfiler) {
+        auto& stats = profiler->fNodes[node];
+        stats.fNode = node;
+        stats.fInvalidations++;
+    }
+}
+
+Profiler::ScopedActivation::ScopedActivation(Profiler* profiler)
+    : fPrev(gActiveProfiler) {
+    gActiveProfiler = profiler;
+}
+
+Profiler::ScopedActivation::~ScopedActivation() {
+    gActiveProfiler = fPrev;
+}
+
+Profiler::NodeScope::NodeScope(const Node* node, const SkRect* bounds)
+    : fProfiler(gActiveProfiler)
+    , fNode(node)
+    , fBounds(bounds)
+    , fStart(fProfiler ? fProfiler->enter() : 0) {}
+
+Profiler::NodeScope::~NodeScope() {
+    if (!fProfiler) {
+        return;
+    }
+
+    double total, self;
+    fProfiler->exit(fStart, &total, &self);
+
+    auto& stats = fProfiler->fNodes[fNode];
+    stats.fNode     = fNode;
+    stats.fBounds   = *fBounds;
+    stats.fSelfMS  += self;
+    stats.fTotalMS += total;
+    stats.fRevalidations++;
+
+    if (fProfiler->fChildTimes.empty()) {
+        fProfiler->fRevalidateMS += total;
+    }
+}
+
+Profiler::AnimatorScope::AnimatorScope(const Animator* animator)
+    : fProfiler(gActiveProfiler)
+    , fAnimator(animator)
+    , fStart(fProfiler ? fProfiler->enter() : 0) {}
+
+Profiler::AnimatorScope::~AnimatorScope() {
+    if (!fProfiler) {
+        return;
+    }
+
+    double total, self;
+    fProfiler->exit(fStart, &total, &self);
+
+    auto& stats = fProfiler->fAnimators[fAnimator];
+    stats.fAnimator = fAnimator;
+    stats.fSelfMS  += self;
+    stats.fTotalMS += total;
+    stats.fTicks++;
+
+    if (fProfiler->fChildTimes.empty()) {
+        fProfiler->fTickMS += total;
+    }
+}
+
+} // namespace sksg
@@ -11,6 +11,7 @@
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPaint.h"
 #include "modules/sksg/include/SkSGInvalidationController.h"
+#include "modules/sksg/include/SkSGProfiler.h"
 #include "modules/sksg/include/SkSGRenderNode.h"
 
 namespace sksg {
@@ -19,6 +20,7 @@ Animator::Animator()  = default;
 Animator::~Animator() = default;
 
 void Animator::tick(float t) {
+    Profiler::AnimatorScope profile_scope(this);
     this->onTick(t);
 }
 
@@ -42,6 +44,8 @@ Scene::Scene(sk_sp<RenderNode> root, AnimatorList&& animators)
 Scene::~Scene() = default;
 
 void Scene::render(SkCanvas* canvas) const {
+    Profiler::ScopedActivation profiler_activation(fProfiler);
+
     // Ensure the SG is revalidated.
     // Note: this is a no-op if the scene has already been revalidated - e.g. in animate().
     fRoot->revalidate(nullptr, SkMatrix::I());
@@ -49,6 +53,11 @@ void Scene::render(SkCanvas* canvas) const {
 }
 
 void Scene::animate(float t, InvalidationController* ic) {
+    Profiler::ScopedActivation profiler_activation(fProfiler);
+    if (fProfiler) {
+        fProfiler->beginFrame();
+    }
+
     for (const auto& anim : fAnimators) {
         anim->tick(t);
     }
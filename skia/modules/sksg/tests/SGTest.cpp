@@ -15,8 +15,10 @@
 #include "modules/sksg/include/SkSGGroup.h"
 #include "modules/sksg/include/SkSGInvalidationController.h"
 #include "modules/sksg/include/SkSGPaint.h"
+#include "modules/sksg/include/SkSGProfiler.h"
 #include "modules/sksg/include/SkSGRect.h"
 #include "modules/sksg/include/SkSGRenderEffect.h"
+#include "modules/sksg/include/SkSGScene.h"
 #include "modules/sksg/include/SkSGTransform.h"
 #include "src/core/SkRectPriv.h"
 
@@ -355,4 +357,63 @@ DEF_TEST(SGInvalidation, reporter) {
     inval_group_remove(reporter);
 }
 
+DEF_TEST(SGProfiler, reporter) {
+    class RectAnimator final : public sksg::Animator {
+    public:
+        explicit RectAnimator(sk_sp<sksg::Rect> rect) : fRect(std::move(rect)) {}
+
+    private:
+        void onTick(float t) override { fRect->setR(100 + t); }
+
+        const sk_sp<sksg::Rect> fRect;
+    };
+
+    auto rect1 = sksg::Rect::Make(SkRect::MakeWH(100, 100)),
+         rect2 = sksg::Rect::Make(SkRect::MakeLTRB(200, 200, 300, 300));
+    auto color = sksg::Color::Make(SK_ColorBLACK);
+    auto root = sksg::Group::Make();
+    root->addChild(sksg::Draw::Make(rect1, color));
+    root->addChild(sksg::Draw::Make(rect2, color));
+
+    auto animator = sk_make_sp<RectAnimator>(rect1);
+    sksg::AnimatorList animators;
+    animators.push_back(animator);
+    auto scene = sksg::Scene::Make(root, std::move(animators));
+
+    sksg::Profiler profiler;
+    scene->animate(0);
+    scene->setProfiler(&profiler);
+    for (int i = 1; i <= 10; ++i) {
+        scene->animate(i);
+    }
+    scene->setProfiler(nullptr);
+    scene->animate(11);
+
+    REPORTER_ASSERT(reporter, profiler.frameCount() == 10);
+
+    const auto top_animators = profiler.topAnimators(5);
+    REPORTER_ASSERT(reporter, top_animators.size() == 1);
+    REPORTER_ASSERT(reporter, top_animators[0].fAnimator == animator.get());
+    REPORTER_ASSERT(reporter, top_animators[0].fTicks == 10);
+
+    // Only the animated rect and its ancestors are revalidated.
+    const auto top_nodes = profiler.topNodes(100);
+    REPORTER_ASSERT(reporter, top_nodes.size() == 3);
+    for (const auto& stats : top_nodes) {
+        REPORTER_ASSERT(reporter, stats.fNode != rect2.get());
+        REPORTER_ASSERT(reporter, stats.fRevalidations == 10);
+        REPORTER_ASSERT(reporter, stats.fInvalidations == 10);
+        REPORTER_ASSERT(reporter, stats.fSelfMS <= stats.fTotalMS);
+        if (stats.fNode == rect1.get()) {
+            REPORTER_ASSERT(reporter, stats.fBounds == SkRect::MakeWH(110, 100));
+        }
+    }
+    REPORTER_ASSERT(reporter, profiler.topNodes(1).size() == 1);
+    REPORTER_ASSERT(reporter, !profiler.report(5).isEmpty());
+
+    profiler.reset();
+    REPORTER_ASSERT(reporter, profiler.frameCount() == 0);
+    REPORTER_ASSERT(reporter, profiler.topNodes(10).empty());
+}
+
 #endif // !defined(SK_BUILD_FOR_GOOGLE3)
@@ -8,6 +8,8 @@
 #include "src/codec/SkJpegCodec.h"
 
 #include "include/codec/SkCodec.h"
+#include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkTypes.h"
 #include "include/private/SkColorData.h"
@@ -15,8 +17,13 @@
 #include "include/private/SkTo.h"
 #include "src/codec/SkCodecPriv.h"
 #include "src/codec/SkJpegDecoderMgr.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/pdf/SkJpegInfo.h"
 
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
 // stdio is needed for libjpeg-turbo
 #include <stdio.h>
 #include "src/codec/SkJpegUtility.h"
@@ -308,6 +315,8 @@ SkJpegCodec::SkJpegCodec(SkEncodedInfo&& info, std::unique_ptr<SkStream> stream,
     , fSwizzlerSubset(SkIRect::MakeEmpty())
 {}
 
+SkJpegCodec::~SkJpegCodec() = default;
+
 /*
  * Return the row bytes of a particular image type and width
  */
@@ -381,6 +390,7 @@ bool SkJpegCodec::onRewind() {
     fSwizzleSrcRow = nullptr;
     fColorXformSrcRow = nullptr;
     fStorage.reset();
+    fIncrementalDecode.reset();
 
     return true;
 }
@@ -569,6 +579,293 @@ static inline bool needs_swizzler_to_convert_from_cmyk(J_COLOR_SPACE jpegColorTy
     return !hasCMYKColorSpace || !hasColorSpaceXform;
 }
 
+namespace {
+
+// Where the pieces of a sequential, single scan jpeg live in its encoded data.
+struct RestartLayout {
+    // Everything from SOI through SOS, except for APPn and COM segments that cannot
+    // affect the pixels.
+    std::vector<uint8_t>                   fHeader;
+    // Offset of the big endian image height in fHeader.
+    size_t                                 fHeightOffset = 0;
+    // Entropy coded data between restart markers, as [start, end) offsets into the
+    // encoded data.
+    std::vector<std::pair<size_t, size_t>> fSegments;
+};
+
+}  // namespace
+
+static bool is_sof_marker(uint8_t marker) {
+    // DHT, JPG and DAC share the SOFn range.
+    return marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC;
+}
+
+static bool parse_restart_layout(const uint8_t* data, size_t size, RestartLayout* layout) {
+    if (!SkJpegCodec::IsJpeg(data, size)) {
+        return false;
+    }
+    layout->fHeader.assign(data, data + 2);
+
+    size_t offset = 2;
+    for (;;) {
+        if (offset + 2 > size || 0xFF != data[offset]) {
+            return false;
+        }
+        // Markers may be preceded by any number of fill bytes.
+        while (offset + 2 < size && 0xFF == data[offset + 1]) {
+            offset++;
+        }
+        if (offset + 4 > size) {
+            return false;
+        }
+        const uint8_t marker = data[offset + 1];
+        if (0x01 == marker || (marker >= 0xD0 && marker <= 0xD9)) {
+            // No standalone markers are expected before the scan.
+            return false;
+        }
+        const size_t segmentSize = 2 + ((data[offset + 2] << 8) | data[offset + 3]);
+        if (segmentSize < 4 || offset + segmentSize > size) {
+            return false;
+        }
+        const uint8_t* segment = data + offset;
+        offset += segmentSize;
+
+        if (is_sof_marker(marker)) {
+            // Baseline and extended sequential Huffman only.
+            if ((0xC0 != marker && 0xC1 != marker) || segmentSize < 10) {
+                return false;
+            }
+            layout->fHeightOffset = layout->fHeader.size() + 5;
+        } else if ((marker >= 0xE1 && marker <= 0xED) || 0xEF == marker || 0xFE == marker) {
+            // Exif, ICC, XMP, comments...  JFIF (APP0) and Adobe (APP14) markers are kept,
+            // since they determine the encoded color space.
+            continue;
+        }
+        layout->fHeader.insert(layout->fHeader.end(), segment, segment + segmentSize);
+
+        if (0xDA == marker) {
+            break;
+        }
+    }
+    if (!layout->fHeightOffset) {
+        return false;
+    }
+
+    size_t start = offset;
+    for (;;) {
+        const uint8_t* ff = (const uint8_t*) memchr(data + offset, 0xFF, size - offset);
+        if (!ff || ff + 1 >= data + size) {
+            // Truncated.  Let the serial decode report what it can.
+            return false;
+        }
+        offset = ff - data;
+        const uint8_t marker = data[offset + 1];
+        if (0x00 == marker || 0xFF == marker) {
+            // Stuffed zero or fill byte.
+            offset += (0x00 == marker) ? 2 : 1;
+            continue;
+        }
+        if (marker >= 0xD0 && marker <= 0xD7) {
+            if ((marker & 7) != (layout->fSegments.size() & 7)) {
+                return false;
+            }
+            layout->fSegments.push_back({start, offset});
+            offset += 2;
+            start = offset;
+            continue;
+        }
+        if (0xD9 == marker) {
+            layout->fSegments.push_back({start, offset});
+            return true;
+        }
+        // DNL, or more scans.
+        return false;
+    }
+}
+
+/*
+ * Builds a standalone jpeg for segments [firstSegment, endSegment), which must hold exactly
+ * |height| rows of pixels.  Restart markers are renumbered to start at RST0.
+ */
+static sk_sp<SkData> make_stripe_jpeg(const uint8_t* data, const RestartLayout& layout,
+                                      size_t firstSegment, size_t endSegment, int height) {
+    SkASSERT(firstSegment < endSegment && height <= 0xFFFF);
+    // RST markers between the segments, plus EOI.
+    size_t size = layout.fHeader.size() + 2 * (endSegment - firstSegment);
+    for (size_t i = firstSegment; i < endSegment; i++) {
+        size += layout.fSegments[i].second - layout.fSegments[i].first;
+    }
+
+    sk_sp<SkData> jpeg = SkData::MakeUninitialized(size);
+    uint8_t* dst = (uint8_t*) jpeg->writable_data();
+    memcpy(dst, layout.fHeader.data(), layout.fHeader.size());
+    dst[layout.fHeightOffset]     = height >> 8;
+    dst[layout.fHeightOffset + 1] = height & 0xFF;
+    dst += layout.fHeader.size();
+
+    for (size_t i = firstSegment; i < endSegment; i++) {
+        if (i > firstSegment) {
+            *dst++ = 0xFF;
+            *dst++ = 0xD0 + ((i - firstSegment - 1) & 7);
+        }
+        const size_t segmentSize = layout.fSegments[i].second - layout.fSegments[i].first;
+        memcpy(dst, data + layout.fSegments[i].first, segmentSize);
+        dst += segmentSize;
+    }
+    *dst++ = 0xFF;
+    *dst++ = 0xD9;
+    SkASSERT(dst == jpeg->bytes() + size);
+
+    return jpeg;
+}
+
+bool SkJpegCodec::decodeStripe(sk_sp<SkData> jpeg, int skipRows, int rows,
+                               const SkImageInfo& dstInfo, void* dst, size_t rowBytes) const {
+    SkMemoryStream stream(std::move(jpeg));
+    JpegDecoderMgr decoderMgr(&stream);
+    // Wide enough for any output color space.
+    SkAutoTMalloc<uint8_t> storage(dstInfo.width() * sizeof(uint32_t));
+
+    skjpeg_error_mgr::AutoPushJmpBuf jmp(decoderMgr.errorMgr());
+    if (setjmp(jmp)) {
+        return decoderMgr.returnFalse("decodeStripe");
+    }
+
+    decoderMgr.init();
+    jpeg_decompress_struct* dinfo = decoderMgr.dinfo();
+    if (JPEG_HEADER_OK != jpeg_read_header(dinfo, true)) {
+        return false;
+    }
+
+    // Match the serial decode.
+    const jpeg_decompress_struct* settings = fDecoderMgr->dinfo();
+    dinfo->out_color_space     = settings->out_color_space;
+    dinfo->dct_method          = settings->dct_method;
+    dinfo->do_fancy_upsampling = settings->do_fancy_upsampling;
+    dinfo->dither_mode         = settings->dither_mode;
+
+    if (!jpeg_start_decompress(dinfo) || (int) dinfo->output_width != dstInfo.width()) {
+        return false;
+    }
+
+    JSAMPLE* scratch = storage.get();
+    for (int y = 0; y < skipRows; y++) {
+        if (1 != jpeg_read_scanlines(dinfo, &scratch, 1)) {
+            return false;
+        }
+    }
+
+    // As in readRows(), 4 byte destinations are color transformed in place.
+    const bool decodeToScratch = this->colorXform() &&
+                                 sizeof(uint32_t) != dstInfo.bytesPerPixel();
+    for (int y = 0; y < rows; y++) {
+        JSAMPLE* decodeDst = decodeToScratch ? scratch : (JSAMPLE*) dst;
+        if (1 != jpeg_read_scanlines(dinfo, &decodeDst, 1)) {
+            return false;
+        }
+        if (this->colorXform()) {
+            this->applyColorXform(dst, decodeDst, dstInfo.width());
+        }
+        dst = SkTAddOffset<void>(dst, rowBytes);
+    }
+
+    // The rows below the stripe only provided context, there is no need to finish.
+    return true;
+}
+
+bool SkJpegCodec::decodeStripesInParallel(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                          SkExecutor* executor) {
+    // Stripes are cut at restart markers, which reset the entropy decoder.  They must also fall
+    // on MCU row boundaries, so only sequential, single scan images qualify.
+    const jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    if (!dinfo->restart_interval || dinfo->progressive_mode ||
+        dinfo->comps_in_scan != dinfo->num_components ||
+        dstInfo.dimensions() != this->dimensions()) {
+        return false;
+    }
+
+    // Stripes are decoded from the encoded bytes in place.  Streams which are not memory backed
+    // are decoded serially: buffering them would copy the whole file up front, whereas the
+    // serial decoder consumes them incrementally.
+    SkStream* stream = this->stream();
+    const uint8_t* data = (const uint8_t*) stream->getMemoryBase();
+    if (!data || !stream->hasLength()) {
+        return false;
+    }
+
+    int mcuWidth  = DCTSIZE,
+        mcuHeight = DCTSIZE;
+    if (dinfo->num_components > 1) {
+        mcuWidth  *= dinfo->max_h_samp_factor;
+        mcuHeight *= dinfo->max_v_samp_factor;
+    }
+    const int width           = dinfo->image_width,
+              height          = dinfo->image_height,
+              mcusPerRow      = (width  + mcuWidth  - 1) / mcuWidth,
+              mcuRows         = (height + mcuHeight - 1) / mcuHeight,
+              restartInterval = dinfo->restart_interval;
+
+    // A restart marker starts MCU row r when r * mcusPerRow is a multiple of the interval,
+    // i.e. every |period| rows.
+    int a = restartInterval, b = mcusPerRow;
+    while (b) {
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+    const int period = restartInterval / a;
+
+    constexpr int kMaxStripes         = 8;
+    constexpr int kMinPeriodsInStripe = 4;
+    constexpr int kMinStripeHeight    = 128;
+    const int periods = (mcuRows + period - 1) / period;
+    const int stripeCount = std::min({ kMaxStripes, periods / kMinPeriodsInStripe,
+                                       height / kMinStripeHeight });
+    if (stripeCount < 2) {
+        return false;
+    }
+
+    RestartLayout layout;
+    if (!parse_restart_layout(data, stream->getLength(), &layout)) {
+        return false;
+    }
+    const int64_t mcuCount = (int64_t) mcusPerRow * mcuRows;
+    if ((int64_t) layout.fSegments.size() != (mcuCount + restartInterval - 1) / restartInterval) {
+        return false;
+    }
+    auto segment_at = [&](int mcuRow) {
+        return mcuRow == mcuRows ? layout.fSegments.size()
+                                 : (size_t) ((int64_t) mcuRow * mcusPerRow / restartInterval);
+    };
+
+    std::atomic<bool> failed(false);
+    SkTaskGroup tasks(*executor);
+    for (int i = 0; i < stripeCount; i++) {
+        tasks.add([&, i] {
+            const int first = periods *  i      / stripeCount * period,
+                      last  = std::min(periods * (i + 1) / stripeCount * period, mcuRows);
+
+            // Fancy upsampling reads the neighboring MCU rows, so decode a period above and
+            // below the stripe for it to see the same context as the serial decode.
+            const int decodeFirst = i > 0 ? first - period : 0,
+                      decodeLast  = std::min(last + period, mcuRows);
+
+            const int firstRow = first * mcuHeight;
+            sk_sp<SkData> jpeg = make_stripe_jpeg(data, layout, segment_at(decodeFirst),
+                    segment_at(decodeLast),
+                    std::min(decodeLast * mcuHeight, height) - decodeFirst * mcuHeight);
+            if (!this->decodeStripe(std::move(jpeg), firstRow - decodeFirst * mcuHeight,
+                                    std::min(last * mcuHeight, height) - firstRow, dstInfo,
+                                    SkTAddOffset<void>(dst, firstRow * rowBytes), rowBytes)) {
+                failed = true;
+            }
+        });
+    }
+    tasks.wait();
+
+    return !failed;
+}
+
 /*
  * Performs the jpeg decode
  */
@@ -590,6 +887,13 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
         return fDecoderMgr->returnFailure("setjmp", kInvalidInput);
     }
 
+    const bool needsCMYKToRGB = needs_swizzler_to_convert_from_cmyk(dinfo->out_color_space,
+            this->getEncodedInfo().profile(), this->colorXform());
+    if (options.fExecutor && !needsCMYKToRGB &&
+        this->decodeStripesInParallel(dstInfo, dst, dstRowBytes, options.fExecutor)) {
+        return kSuccess;
+    }
+
     if (!jpeg_start_decompress(dinfo)) {
         return fDecoderMgr->returnFailure("startDecompress", kInvalidInput);
     }
@@ -598,8 +902,7 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
     // If it's not, we want to know because it means our strategy is not optimal.
     SkASSERT(1 == dinfo->rec_outbuf_height);
 
-    if (needs_swizzler_to_convert_from_cmyk(dinfo->out_color_space,
-                                            this->getEncodedInfo().profile(), this->colorXform())) {
+    if (needsCMYKToRGB) {
         this->initializeSwizzler(dstInfo, options, true);
     }
 
@@ -614,6 +917,208 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
     return kSuccess;
 }
 
+/*
+ * The state of an incremental decode.  libjpeg-turbo reads from fData, which holds the encoded
+ * data it has not consumed yet.  When fData runs out, filling the input buffer fails, which
+ * makes libjpeg-turbo suspend: it backs up to a point it can resume from once more data has
+ * been appended.
+ */
+struct SkJpegCodec::IncrementalDecode {
+    // Null if the stream is in memory, in which case fData already holds all of it.
+    SkStream*            fStream;
+    std::vector<JOCTET>  fData;
+    // Bytes libjpeg-turbo asked to skip beyond the end of fData.
+    size_t               fSkip = 0;
+
+    void*                fDst;
+    size_t               fRowBytes;
+    bool                 fStarted = false;
+    // The scan being output (progressive images only), or 0 between output passes.
+    int                  fOutputScan = 0;
+    // The last scan output in full.
+    int                  fLastScan = 0;
+    int                  fRowsDecoded = 0;
+    std::vector<uint8_t> fSkippedRow;
+
+    static boolean FillInputBuffer(j_decompress_ptr) {
+        return false;
+    }
+
+    static void SkipInputData(j_decompress_ptr dinfo, long numBytes) {
+        if (numBytes <= 0) {
+            return;
+        }
+        jpeg_source_mgr* src = dinfo->src;
+        size_t bytes = (size_t) numBytes;
+        if (bytes > src->bytes_in_buffer) {
+            auto* decode = static_cast<IncrementalDecode*>(dinfo->client_data);
+            decode->fSkip += bytes - src->bytes_in_buffer;
+            bytes = src->bytes_in_buffer;
+        }
+        src->next_input_byte += bytes;
+        src->bytes_in_buffer -= bytes;
+    }
+
+    // Drops the data libjpeg-turbo has consumed, and appends the data which has arrived since.
+    void appendAvailableData(jpeg_source_mgr* src) {
+        fData.erase(fData.begin(), fData.end() - src->bytes_in_buffer);
+        if (fStream) {
+            constexpr size_t kChunkSize = 4096;
+            size_t bytesRead;
+            do {
+                const size_t size = fData.size();
+                fData.resize(size + kChunkSize);
+                bytesRead = fStream->read(fData.data() + size, kChunkSize);
+                fData.resize(size + bytesRead);
+            } while (bytesRead > 0);
+        }
+        const size_t skip = std::min(fSkip, fData.size());
+        fSkip -= skip;
+        src->next_input_byte = fData.data() + skip;
+        src->bytes_in_buffer = fData.size() - skip;
+    }
+};
+
+SkCodec::Result SkJpegCodec::onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst,
+                                                      size_t rowBytes, const Options& options) {
+    if (options.fSubset) {
+        // Subsets are not supported.
+        return kUnimplemented;
+    }
+
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    SkASSERT(fReadyState == dinfo->global_state);
+
+    fIncrementalDecode.reset(new IncrementalDecode);
+    IncrementalDecode* decode = fIncrementalDecode.get();
+    SkStream* stream = this->stream();
+    decode->fStream = (stream->hasLength() && stream->getMemoryBase()) ? nullptr : stream;
+    decode->fDst = dst;
+    decode->fRowBytes = rowBytes;
+
+    // Take over the source manager, starting with whatever the header left unconsumed.
+    jpeg_source_mgr* src = dinfo->src;
+    decode->fData.assign(src->next_input_byte, src->next_input_byte + src->bytes_in_buffer);
+    src->next_input_byte = decode->fData.data();
+    src->bytes_in_buffer = decode->fData.size();
+    src->fill_input_buffer = IncrementalDecode::FillInputBuffer;
+    src->skip_input_data = IncrementalDecode::SkipInputData;
+    dinfo->client_data = decode;
+
+    // Buffered-image mode lets us output the scans of a progressive image as they arrive,
+    // rather than having jpeg_start_decompress() absorb the entire image first.
+    dinfo->buffered_image = jpeg_has_multiple_scans(dinfo);
+    return kSuccess;
+}
+
+SkCodec::Result SkJpegCodec::onIncrementalDecode(int* rowsDecoded) {
+    IncrementalDecode* decode = fIncrementalDecode.get();
+    SkASSERT(decode);
+    const SkImageInfo& dstInfo = this->dstInfo();
+    const Options& options = this->options();
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+
+    skjpeg_error_mgr::AutoPushJmpBuf jmp(fDecoderMgr->errorMgr());
+    if (setjmp(jmp)) {
+        return fDecoderMgr->returnFailure("setjmp", kInvalidInput);
+    }
+
+    decode->appendAvailableData(dinfo->src);
+
+    if (!decode->fStarted) {
+        if (!jpeg_start_decompress(dinfo)) {
+            if (rowsDecoded) {
+                *rowsDecoded = 0;
+            }
+            return kIncompleteInput;
+        }
+        SkASSERT(1 == dinfo->rec_outbuf_height);
+
+        const bool needsCMYKToRGB = needs_swizzler_to_convert_from_cmyk(dinfo->out_color_space,
+                this->getEncodedInfo().profile(), this->colorXform());
+        // getSampler() may already have set up the swizzler and storage.
+        if (!fSwizzler) {
+            if (needsCMYKToRGB) {
+                this->initializeSwizzler(dstInfo, options, true);
+            }
+            this->allocateStorage(dstInfo);
+        }
+        decode->fStarted = true;
+    }
+
+    // Resumes the current output pass, returning true once it has output every row.  Rows
+    // skipped by a sampler (see getSampler()) are decoded into a scratch row.
+    const int sampleY = fSwizzler ? fSwizzler->sampleY() : 1;
+    const int dstHeight = get_scaled_dimension(dinfo->output_height, sampleY);
+    auto readRemainingRows = [&]() {
+        while (dinfo->output_scanline < dinfo->output_height) {
+            const int row = dinfo->output_scanline;
+            const int dstRow = row / sampleY;
+            const bool sampled = row % sampleY == get_start_coord(sampleY) && dstRow < dstHeight;
+            void* dst;
+            if (sampled) {
+                dst = SkTAddOffset<void>(decode->fDst, dstRow * decode->fRowBytes);
+            } else {
+                decode->fSkippedRow.resize(decode->fRowBytes);
+                dst = decode->fSkippedRow.data();
+            }
+            if (1 != this->readRows(dstInfo, dst, decode->fRowBytes, 1, options)) {
+                return false;
+            }
+            if (sampled) {
+                decode->fRowsDecoded = std::max(decode->fRowsDecoded, dstRow + 1);
+            }
+        }
+        return true;
+    };
+
+    if (!dinfo->buffered_image) {
+        if (readRemainingRows()) {
+            return kSuccess;
+        }
+        if (rowsDecoded) {
+            *rowsDecoded = decode->fRowsDecoded;
+        }
+        return kIncompleteInput;
+    }
+
+    for (;;) {
+        if (decode->fOutputScan) {
+            if (!readRemainingRows() || !jpeg_finish_output(dinfo)) {
+                break;
+            }
+            decode->fLastScan = decode->fOutputScan;
+            decode->fOutputScan = 0;
+            if (jpeg_input_complete(dinfo) && decode->fLastScan == dinfo->input_scan_number) {
+                return kSuccess;
+            }
+        }
+
+        while (!jpeg_input_complete(dinfo)) {
+            if (JPEG_SUSPENDED == jpeg_consume_input(dinfo)) {
+                break;
+            }
+        }
+
+        // While more data is expected, show the last scan received in full, unless there is
+        // nothing better to show than the first scan so far.
+        int scan = dinfo->input_scan_number;
+        if (scan > 1 && !jpeg_input_complete(dinfo) && decode->fStream &&
+                !decode->fStream->isAtEnd()) {
+            scan--;
+        }
+        if (scan <= decode->fLastScan || !jpeg_start_output(dinfo, scan)) {
+            break;
+        }
+        decode->fOutputScan = scan;
+    }
+
+    if (rowsDecoded) {
+        *rowsDecoded = decode->fRowsDecoded;
+    }
+    return kIncompleteInput;
+}
+
 void SkJpegCodec::allocateStorage(const SkImageInfo& dstInfo) {
     int dstWidth = dstInfo.width();
 
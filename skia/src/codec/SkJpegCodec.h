@@ -31,6 +31,8 @@ public:
      */
     static std::unique_ptr<SkCodec> MakeFromStream(std::unique_ptr<SkStream>, Result*);
 
+    ~SkJpegCodec() override;
+
 protected:
 
     /*
@@ -44,6 +46,15 @@ protected:
     Result onGetPixels(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes, const Options&,
             int*) override;
 
+    /*
+     * Incremental decoding.  libjpeg-turbo suspends when it runs out of data and resumes where
+     * it stopped once more has arrived.  Each scan of a progressive image is shown as soon as
+     * it has been received.
+     */
+    Result onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+            const Options&) override;
+    Result onIncrementalDecode(int* rowsDecoded) override;
+
     bool onQueryYUV8(SkYUVASizeInfo* sizeInfo, SkYUVColorSpace* colorSpace) const override;
 
     Result onGetYUV8Planes(const SkYUVASizeInfo& sizeInfo,
@@ -109,6 +120,18 @@ private:
     void allocateStorage(const SkImageInfo& dstInfo);
     int readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, int count, const Options&);
 
+    /*
+     * Decodes horizontal stripes of the image concurrently on |executor|, if the encoded data
+     * is in memory and has restart markers on MCU row boundaries.
+     *
+     * Returns false if the image does not qualify or any stripe fails to decode.  fDecoderMgr
+     * is left untouched, so the caller can fall back to the serial decode.
+     */
+    bool decodeStripesInParallel(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                 SkExecutor* executor);
+    bool decodeStripe(sk_sp<SkData> jpeg, int skipRows, int rows, const SkImageInfo& dstInfo,
+                      void* dst, size_t rowBytes) const;
+
     /*
      * Scanline decoding.
      */
@@ -136,6 +159,10 @@ private:
 
     std::unique_ptr<SkSwizzler>        fSwizzler;
 
+    // The state of an incremental decode, if one has been started since the last rewind.
+    struct IncrementalDecode;
+    std::unique_ptr<IncrementalDecode> fIncrementalDecode;
+
     friend class SkRawCodec;
 
     typedef SkCodec INHERITED;
@@ -133,16 +133,19 @@ static inline bool is_chunk(const png_byte* chunk, const char* tag) {
     return memcmp(chunk + 4, tag, 4) == 0;
 }
 
+// Passes the next |*length| bytes of |stream| to libpng. Returns false if the stream runs out
+// first, leaving the number of bytes that are still to come in |*length|.
 static inline bool process_data(png_structp png_ptr, png_infop info_ptr,
-        SkStream* stream, void* buffer, size_t bufferSize, size_t length) {
-    while (length > 0) {
-        const size_t bytesToProcess = std::min(bufferSize, length);
+        SkStream* stream, void* buffer, size_t bufferSize, size_t* length) {
+    while (*length > 0) {
+        const size_t bytesToProcess = std::min(bufferSize, *length);
         const size_t bytesRead = stream->read(buffer, bytesToProcess);
+        // Before processing, which may longjmp out of here.
+        *length -= bytesRead;
         png_process_data(png_ptr, info_ptr, (png_bytep) buffer, bytesRead);
         if (bytesRead < bytesToProcess) {
             return false;
         }
-        length -= bytesToProcess;
     }
     return true;
 }
@@ -186,7 +189,8 @@ bool AutoCleanPng::decodeBounds() {
 
         png_process_data(fPng_ptr, fInfo_ptr, chunk, 8);
         // Process the full chunk + CRC.
-        if (!process_data(fPng_ptr, fInfo_ptr, fStream, buffer, kBufferSize, length + 4)) {
+        size_t bytesLeft = length + 4;
+        if (!process_data(fPng_ptr, fInfo_ptr, fStream, buffer, kBufferSize, &bytesLeft)) {
             return false;
         }
     }
@@ -215,32 +219,40 @@ bool SkPngCodec::processData() {
     constexpr size_t kBufferSize = 4096;
     char buffer[kBufferSize];
 
+    // The stream may still be growing, so any read can come up short. What was read is kept
+    // track of, so that the next call picks up where this one stopped.
     bool iend = false;
     while (true) {
-        size_t length;
-        if (fDecodedIdat) {
-            // Parse chunk length and type.
-            if (this->stream()->read(buffer, 8) < 8) {
-                break;
-            }
+        if (0 == fChunkBytesLeft) {
+            if (fDecodedIdat) {
+                // Parse chunk length and type.
+                fChunkHeaderLength += this->stream()->read(fChunkHeader + fChunkHeaderLength,
+                                                           8 - fChunkHeaderLength);
+                if (fChunkHeaderLength < 8) {
+                    break;
+                }
+                fChunkHeaderLength = 0;
 
-            png_byte* chunk = reinterpret_cast<png_byte*>(buffer);
-            png_process_data(fPng_ptr, fInfo_ptr, chunk, 8);
-            if (is_chunk(chunk, "IEND")) {
-                iend = true;
-            }
+                png_byte* chunk = reinterpret_cast<png_byte*>(fChunkHeader);
+                png_process_data(fPng_ptr, fInfo_ptr, chunk, 8);
+                if (is_chunk(chunk, "IEND")) {
+                    iend = true;
+                }
 
-            length = png_get_uint_32(chunk);
-        } else {
-            length = fIdatLength;
-            png_byte idat[] = {0, 0, 0, 0, 'I', 'D', 'A', 'T'};
-            png_save_uint_32(idat, length);
-            png_process_data(fPng_ptr, fInfo_ptr, idat, 8);
-            fDecodedIdat = true;
+                fChunkBytesLeft = png_get_uint_32(chunk) + 4;
+            } else {
+                png_byte idat[] = {0, 0, 0, 0, 'I', 'D', 'A', 'T'};
+                png_save_uint_32(idat, fIdatLength);
+                png_process_data(fPng_ptr, fInfo_ptr, idat, 8);
+                fDecodedIdat = true;
+
+                fChunkBytesLeft = fIdatLength + 4;
+            }
         }
 
         // Process the full chunk + CRC.
-        if (!process_data(fPng_ptr, fInfo_ptr, this->stream(), buffer, kBufferSize, length + 4)
+        if (!process_data(fPng_ptr, fInfo_ptr, this->stream(), buffer, kBufferSize,
+                          &fChunkBytesLeft)
                 || iend) {
             break;
         }
@@ -460,6 +472,10 @@ static skcms_PixelFormat png_select_xform_format(const SkEncodedInfo& info) {
         } else if (SkEncodedInfo::kRGB_Color == info.color()) {
             return skcms_PixelFormat_RGB_161616BE;
         }
+    } else if (SkEncodedInfo::kRGB_Color == info.color()) {
+        // skcms unpacks, transforms and premultiplies in a single pass, so there is no
+        // need to expand to RGBA first.
+        return skcms_PixelFormat_RGB_888;
     } else if (SkEncodedInfo::kGray_Color == info.color()) {
         return skcms_PixelFormat_G_8;
     }
@@ -615,6 +631,8 @@ public:
         , fNumberPasses(numberPasses)
         , fFirstRow(0)
         , fLastRow(0)
+        , fSampleY(0)
+        , fRowsNeeded(0)
         , fLinesDecoded(0)
         , fInterlacedComplete(false)
         , fPng_rowbytes(0)
@@ -631,6 +649,11 @@ private:
     int                     fLastRow;
     void*                   fDst;
     size_t                  fRowBytes;
+    // Only every fSampleY'th row of [fFirstRow, fLastRow] is kept, fRowsNeeded in all.
+    // Zero until the sampler is known, on the first call to decode().
+    int                     fSampleY;
+    int                     fRowsNeeded;
+    // Rows of fInterlaceBuffer initialized by the first pass.
     int                     fLinesDecoded;
     bool                    fInterlacedComplete;
     size_t                  fPng_rowbytes;
@@ -638,30 +661,36 @@ private:
 
     typedef SkPngCodec INHERITED;
 
-    // FIXME: Currently sharing interlaced callback for all rows and subset. It's not
-    // as expensive as the subset version of non-interlaced, but it still does extra
-    // work.
+    // libpng still has to inflate and unfilter every row of every pass, since each row is
+    // filtered against the one above it, but rows outside of the subset or skipped by
+    // sampling are neither combined nor stored.
     void interlacedRowCallback(png_bytep row, int rowNum, int pass) {
         if (rowNum < fFirstRow || rowNum > fLastRow || fInterlacedComplete) {
             // Ignore this row
             return;
         }
 
-        png_bytep oldRow = fInterlaceBuffer.get() + (rowNum - fFirstRow) * fPng_rowbytes;
+        const int offset = rowNum - fFirstRow - get_start_coord(fSampleY);
+        if (offset < 0 || offset % fSampleY != 0 || offset / fSampleY >= fRowsNeeded) {
+            // Sampled away.
+            return;
+        }
+        const int index = offset / fSampleY;
+
+        png_bytep oldRow = fInterlaceBuffer.get() + index * fPng_rowbytes;
         png_progressive_combine_row(this->png_ptr(), oldRow, row);
 
         if (0 == pass) {
             // The first pass initializes all rows.
             SkASSERT(row);
-            SkASSERT(fLinesDecoded == rowNum - fFirstRow);
+            SkASSERT(fLinesDecoded == index);
             fLinesDecoded++;
         } else {
-            SkASSERT(fLinesDecoded == fLastRow - fFirstRow + 1);
-            if (fNumberPasses - 1 == pass && rowNum == fLastRow) {
+            SkASSERT(fLinesDecoded == fRowsNeeded);
+            if (fNumberPasses - 1 == pass && index == fRowsNeeded - 1) {
                 // Last pass, and we have read all of the rows we care about.
                 fInterlacedComplete = true;
-                if (fLastRow != this->dimensions().height() - 1 ||
-                        (this->swizzler() && this->swizzler()->sampleY() != 1)) {
+                if (rowNum != this->dimensions().height() - 1) {
                     // Fake error to stop decoding scanlines. Only stop if we're not decoding the
                     // whole image, in which case processing the rest of the image might be
                     // expensive. When decoding the whole image, read through the IEND chunk to
@@ -674,13 +703,13 @@ private:
 
     Result decodeAllRows(void* dst, size_t rowBytes, int* rowsDecoded) override {
         const int height = this->dimensions().height();
-        this->setUpInterlaceBuffer(height);
         png_set_progressive_read_fn(this->png_ptr(), this, nullptr, InterlacedRowCallback,
                                     nullptr);
 
         fFirstRow = 0;
         fLastRow = height - 1;
         fLinesDecoded = 0;
+        this->setUpInterlaceBuffer(1);
 
         const bool success = this->processData();
         png_bytep srcRow = fInterlaceBuffer.get();
@@ -702,45 +731,30 @@ private:
     }
 
     void setRange(int firstRow, int lastRow, void* dst, size_t rowBytes) override {
-        // FIXME: We could skip rows in the interlace buffer that we won't put in the output.
-        this->setUpInterlaceBuffer(lastRow - firstRow + 1);
         png_set_progressive_read_fn(this->png_ptr(), this, nullptr, InterlacedRowCallback, nullptr);
         fFirstRow = firstRow;
         fLastRow = lastRow;
         fDst = dst;
         fRowBytes = rowBytes;
         fLinesDecoded = 0;
+        // The sampler is set up after this call, so wait for decode() to size the buffer.
+        fSampleY = 0;
     }
 
     Result decode(int* rowsDecoded) override {
-        const bool success = this->processData();
-
-        // Now apply Xforms on all the rows that were decoded.
-        if (!fLinesDecoded) {
-            if (rowsDecoded) {
-                *rowsDecoded = 0;
-            }
-            return log_and_return_error(success);
+        if (!fSampleY) {
+            this->setUpInterlaceBuffer(this->swizzler() ? this->swizzler()->sampleY() : 1);
         }
 
-        const int sampleY = this->swizzler() ? this->swizzler()->sampleY() : 1;
-        const int rowsNeeded = get_scaled_dimension(fLastRow - fFirstRow + 1, sampleY);
+        const bool success = this->processData();
 
         // FIXME: For resuming interlace, we may swizzle a row that hasn't changed. But it
         // may be too tricky/expensive to handle that correctly.
-
-        // Offset srcRow by get_start_coord rows. We do not need to account for fFirstRow,
-        // since the first row in fInterlaceBuffer corresponds to fFirstRow.
-        int srcRow = get_start_coord(sampleY);
         void* dst = fDst;
-        int rowsWrittenToOutput = 0;
-        while (rowsWrittenToOutput < rowsNeeded && srcRow < fLinesDecoded) {
-            png_bytep src = SkTAddOffset<png_byte>(fInterlaceBuffer.get(), fPng_rowbytes * srcRow);
+        for (int rowNum = 0; rowNum < fLinesDecoded; rowNum++) {
+            png_bytep src = SkTAddOffset<png_byte>(fInterlaceBuffer.get(), fPng_rowbytes * rowNum);
             this->applyXformRow(dst, src);
             dst = SkTAddOffset<void>(dst, fRowBytes);
-
-            rowsWrittenToOutput++;
-            srcRow += sampleY;
         }
 
         if (success && fInterlacedComplete) {
@@ -748,14 +762,16 @@ private:
         }
 
         if (rowsDecoded) {
-            *rowsDecoded = rowsWrittenToOutput;
+            *rowsDecoded = fLinesDecoded;
         }
         return log_and_return_error(success);
     }
 
-    void setUpInterlaceBuffer(int height) {
+    void setUpInterlaceBuffer(int sampleY) {
+        fSampleY = sampleY;
+        fRowsNeeded = get_scaled_dimension(fLastRow - fFirstRow + 1, sampleY);
         fPng_rowbytes = png_get_rowbytes(this->png_ptr(), this->info_ptr());
-        fInterlaceBuffer.reset(fPng_rowbytes * height);
+        fInterlaceBuffer.reset(fPng_rowbytes * fRowsNeeded);
         fInterlacedComplete = false;
     }
 };
@@ -979,6 +995,8 @@ SkPngCodec::SkPngCodec(SkEncodedInfo&& encodedInfo, std::unique_ptr<SkStream> st
     , fBitDepth(bitDepth)
     , fIdatLength(0)
     , fDecodedIdat(false)
+    , fChunkBytesLeft(0)
+    , fChunkHeaderLength(0)
 {}
 
 SkPngCodec::~SkPngCodec() {
@@ -1015,11 +1033,6 @@ SkCodec::Result SkPngCodec::initializeXforms(const SkImageInfo& dstInfo, const O
     bool skipFormatConversion = false;
     switch (this->getEncodedInfo().color()) {
         case SkEncodedInfo::kRGB_Color:
-            if (this->getEncodedInfo().bitsPerComponent() != 16) {
-                break;
-            }
-
-            // Fall through
         case SkEncodedInfo::kRGBA_Color:
         case SkEncodedInfo::kGray_Color:
             skipFormatConversion = this->colorXform();
@@ -1084,8 +1097,7 @@ void SkPngCodec::initializeSwizzler(const SkImageInfo& dstInfo, const Options& o
         int srcBPP = 0;
         switch (this->getEncodedInfo().color()) {
             case SkEncodedInfo::kRGB_Color:
-                SkASSERT(this->getEncodedInfo().bitsPerComponent() == 16);
-                srcBPP = 6;
+                srcBPP = this->getEncodedInfo().bitsPerComponent() * 3 / 8;
                 break;
             case SkEncodedInfo::kRGBA_Color:
                 srcBPP = this->getEncodedInfo().bitsPerComponent() / 2;
@@ -1133,6 +1145,8 @@ bool SkPngCodec::onRewind() {
     fPng_ptr = png_ptr;
     fInfo_ptr = info_ptr;
     fDecodedIdat = false;
+    fChunkBytesLeft = 0;
+    fChunkHeaderLength = 0;
     return true;
 }
 
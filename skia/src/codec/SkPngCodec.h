@@ -115,6 +115,11 @@ private:
 
     size_t                         fIdatLength;
     bool                           fDecodedIdat;
+    // If the stream ran out of data, the bytes of the chunk being decoded (including its CRC)
+    // that processData() has yet to read, or the part of the next chunk header it has read.
+    size_t                         fChunkBytesLeft;
+    uint8_t                        fChunkHeader[8];
+    size_t                         fChunkHeaderLength;
 
     typedef SkCodec INHERITED;
 };
@@ -45,14 +45,16 @@ std::unique_ptr<SkCodec> SkWebpCodec::MakeFromStream(std::unique_ptr<SkStream> s
                                                      Result* result) {
     // Webp demux needs a contiguous data buffer.
     sk_sp<SkData> data = nullptr;
+    std::unique_ptr<SkStream> copiedStream;
     if (stream->getMemoryBase()) {
         // It is safe to make without copy because we'll hold onto the stream.
         data = SkData::MakeWithoutCopy(stream->getMemoryBase(), stream->getLength());
     } else {
         data = SkCopyStreamToData(stream.get());
 
-        // If we are forced to copy the stream to a data, we can go ahead and delete the stream.
-        stream.reset(nullptr);
+        // If we are forced to copy the stream to a data, we can go ahead and delete the stream,
+        // unless more of the image may still arrive on it (see below).
+        copiedStream = std::move(stream);
     }
 
     // It's a little strange that the |demux| will outlive |webpData|, though it needs the
@@ -170,10 +172,16 @@ std::unique_ptr<SkCodec> SkWebpCodec::MakeFromStream(std::unique_ptr<SkStream> s
     }
 
 
+    // A partially received image can be decoded incrementally as the rest of it arrives.
+    if (WEBP_DEMUX_DONE == state) {
+        copiedStream.reset(nullptr);
+    }
+
     *result = kSuccess;
     SkEncodedInfo info = SkEncodedInfo::Make(width, height, color, alpha, 8, std::move(profile));
     return std::unique_ptr<SkCodec>(new SkWebpCodec(std::move(info), std::move(stream),
-                                                    demux.release(), std::move(data), origin));
+                                                    demux.release(), std::move(data), origin,
+                                                    std::move(copiedStream)));
 }
 
 static WEBP_CSP_MODE webp_decode_mode(SkColorType dstCT, bool premultiply) {
@@ -348,22 +356,102 @@ static void blend_line(SkColorType dstCT, void* dst,
     p.run(0,0, width,1);
 }
 
+struct SkWebpCodec::Decode {
+    ~Decode() {
+        // The decoder refers to fConfig, so it has to go first.
+        fIDec.reset(nullptr);
+        WebPFreeDecBuffer(&fConfig.output);
+    }
+
+    WebPDecoderConfig fConfig;
+    SkAutoTCallVProc<WebPIDecoder, WebPIDelete> fIDec{nullptr};
+
+    int         fFrameIndex;
+    SkImageInfo fDstInfo;
+    void*       fDst;           // Points at the top left of the frame in the dst.
+    size_t      fRowBytes;
+    int         fDstY;
+    int         fScaledWidth;
+    int         fScaledHeight;
+    SkColorType fWebpColorType;
+    bool        fBlendWithPrevFrame;
+    bool        fFrameHasAlpha;
+
+    // Rows that have already been color transformed and/or blended into the dst.
+    int         fRowsFinished = 0;
+};
+
+SkWebpCodec::~SkWebpCodec() = default;
+
 SkCodec::Result SkWebpCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
                                          const Options& options, int* rowsDecodedPtr) {
+    Result result = this->startDecode(dstInfo, dst, rowBytes, options);
+    if (kSuccess != result || !fDecode) {
+        return result;
+    }
+
+    int rowsDecoded;
+    result = this->decodeAvailableRows(&rowsDecoded);
+    if (kIncompleteInput == result) {
+        if (rowsDecoded <= 0) {
+            result = kInvalidInput;
+        } else {
+            *rowsDecodedPtr = rowsDecoded + fDecode->fDstY;
+        }
+    }
+    fDecode.reset(nullptr);
+    return result;
+}
+
+SkCodec::Result SkWebpCodec::onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst,
+                                                      size_t rowBytes, const Options& options) {
+    // Unlike getPixels(), SkCodec does not check that the subset is one we can decode exactly.
+    if (options.fSubset) {
+        SkIRect subset = *options.fSubset;
+        if (!this->getValidSubset(&subset) || subset != *options.fSubset) {
+            return kInvalidParameters;
+        }
+    }
+
+    this->readMoreData();
+    return this->startDecode(dstInfo, dst, rowBytes, options);
+}
+
+SkCodec::Result SkWebpCodec::onIncrementalDecode(int* rowsDecodedPtr) {
+    if (!fDecode) {
+        return kSuccess;
+    }
+
+    this->readMoreData();
+
+    int rowsDecoded;
+    const Result result = this->decodeAvailableRows(&rowsDecoded);
+    if (kIncompleteInput == result) {
+        if (rowsDecodedPtr) {
+            *rowsDecodedPtr = rowsDecoded + fDecode->fDstY;
+        }
+    } else {
+        fDecode.reset(nullptr);
+    }
+    return result;
+}
+
+SkCodec::Result SkWebpCodec::startDecode(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                         const Options& options) {
+    fDecode.reset(nullptr);
+
     const int index = options.fFrameIndex;
     SkASSERT(0 == index || index < fFrameHolder.size());
     SkASSERT(0 == index || !options.fSubset);
 
-    WebPDecoderConfig config;
+    auto decode = skstd::make_unique<Decode>();
+    WebPDecoderConfig& config = decode->fConfig;
     if (0 == WebPInitDecoderConfig(&config)) {
         // ABI mismatch.
         // FIXME: New enum for this?
         return kInvalidInput;
     }
 
-    // Free any memory associated with the buffer. Must be called last, so we declare it first.
-    SkAutoTCallVProc<WebPDecBuffer, WebPFreeDecBuffer> autoFree(&(config.output));
-
     WebPIterator frame;
     SkAutoTCallVProc<WebPIterator, WebPDemuxReleaseIterator> autoFrame(&frame);
     // If this succeeded in onGetFrameCount(), it should succeed again here.
@@ -471,13 +559,21 @@ SkCodec::Result SkWebpCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst,
     if ((this->colorXform() && !is_8888(dstInfo.colorType())) || blendWithPrevFrame) {
         // We will decode the entire image and then perform the color transform.  libwebp
         // does not provide a row-by-row API.  This is a shame particularly when we do not want
-        // 8888, since we will need to create another image sized buffer.
-        webpDst.allocPixels(webpInfo);
+        // 8888, since we will need to create another image sized buffer.  Reuse the one from
+        // the previous frame when it is big enough.
+        const size_t webpRowBytes = webpInfo.minRowBytes();
+        webpDst.installPixels(webpInfo,
+                              fFrameStorage.reset(webpInfo.computeByteSize(webpRowBytes),
+                                                  SkAutoMalloc::kReuse_OnShrink),
+                              webpRowBytes);
     } else {
         // libwebp can decode directly into the output memory.
         webpDst.installPixels(webpInfo, dst, rowBytes);
     }
 
+    // Let libwebp filter lossy images on a thread of its own while it decodes the next rows.
+    config.options.use_threads = options.fUseDecoderThreads ? 1 : 0;
+
     config.output.colorspace = webp_decode_mode(webpInfo.colorType(),
             frame.has_alpha && dstInfo.alphaType() == kPremul_SkAlphaType && !this->colorXform());
     config.output.is_external_memory = 1;
@@ -486,37 +582,70 @@ SkCodec::Result SkWebpCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst,
     config.output.u.RGBA.stride = static_cast<int>(webpDst.rowBytes());
     config.output.u.RGBA.size = webpDst.computeByteSize();
 
-    SkAutoTCallVProc<WebPIDecoder, WebPIDelete> idec(WebPIDecode(nullptr, 0, &config));
-    if (!idec) {
+    decode->fIDec.reset(WebPIDecode(nullptr, 0, &config));
+    if (!decode->fIDec) {
         return kInvalidInput;
     }
 
+    decode->fFrameIndex = index;
+    decode->fDstInfo = dstInfo;
+    decode->fDst = SkTAddOffset<void>(dst, dstInfo.bytesPerPixel() * dstX + rowBytes * dstY);
+    decode->fRowBytes = rowBytes;
+    decode->fDstY = dstY;
+    decode->fScaledWidth = scaledWidth;
+    decode->fScaledHeight = scaledHeight;
+    decode->fWebpColorType = webpDst.colorType();
+    decode->fBlendWithPrevFrame = blendWithPrevFrame;
+    decode->fFrameHasAlpha = frame.has_alpha;
+    fDecode = std::move(decode);
+    return kSuccess;
+}
+
+
+SkCodec::Result SkWebpCodec::decodeAvailableRows(int* rowsDecodedPtr) {
+    SkASSERT(fDecode);
+    Decode& decode = *fDecode;
+    const WebPDecoderConfig& config = decode.fConfig;
+
+    WebPIterator frame;
+    SkAutoTCallVProc<WebPIterator, WebPDemuxReleaseIterator> autoFrame(&frame);
+    SkAssertResult(WebPDemuxGetFrame(fDemux, decode.fFrameIndex + 1, &frame));
+
+    // libwebp is in its update mode, so it is always handed everything received so far,
+    // even if fData has since been reallocated.
     int rowsDecoded = 0;
     SkCodec::Result result;
-    switch (WebPIUpdate(idec, frame.fragment.bytes, frame.fragment.size)) {
+    switch (WebPIUpdate(decode.fIDec, frame.fragment.bytes, frame.fragment.size)) {
         case VP8_STATUS_OK:
-            rowsDecoded = scaledHeight;
+            rowsDecoded = decode.fScaledHeight;
             result = kSuccess;
             break;
         case VP8_STATUS_SUSPENDED:
-            if (!WebPIDecGetRGB(idec, &rowsDecoded, nullptr, nullptr, nullptr)
-                    || rowsDecoded <= 0) {
-                return kInvalidInput;
+            // This fails if libwebp has not got as far as the first row.
+            if (!WebPIDecGetRGB(decode.fIDec, &rowsDecoded, nullptr, nullptr, nullptr)) {
+                rowsDecoded = 0;
             }
-            *rowsDecodedPtr = rowsDecoded + dstY;
             result = kIncompleteInput;
             break;
         default:
             return kInvalidInput;
     }
+    *rowsDecodedPtr = rowsDecoded;
+
+    const int firstRow = decode.fRowsFinished;
+    decode.fRowsFinished = SkTMax(firstRow, rowsDecoded);
 
-    const size_t dstBpp = dstInfo.bytesPerPixel();
-    dst = SkTAddOffset<void>(dst, dstBpp * dstX + rowBytes * dstY);
+    const SkImageInfo& dstInfo = decode.fDstInfo;
+    const size_t rowBytes = decode.fRowBytes;
+    const int scaledWidth = decode.fScaledWidth;
+    const bool blendWithPrevFrame = decode.fBlendWithPrevFrame;
+    void* dst = SkTAddOffset<void>(decode.fDst, rowBytes * firstRow);
     const size_t srcRowBytes = config.output.u.RGBA.stride;
 
     const auto dstCT = dstInfo.colorType();
     if (this->colorXform()) {
-        uint32_t* xformSrc = (uint32_t*) config.output.u.RGBA.rgba;
+        uint32_t* xformSrc = SkTAddOffset<uint32_t>(config.output.u.RGBA.rgba,
+                                                    srcRowBytes * firstRow);
         SkBitmap tmp;
         void* xformDst;
 
@@ -528,11 +657,11 @@ SkCodec::Result SkWebpCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst,
             xformDst = dst;
         }
 
-        for (int y = 0; y < rowsDecoded; y++) {
+        for (int y = firstRow; y < rowsDecoded; y++) {
             this->applyColorXform(xformDst, xformSrc, scaledWidth);
             if (blendWithPrevFrame) {
                 blend_line(dstCT, dst, dstCT, xformDst,
-                        dstInfo.alphaType(), frame.has_alpha, scaledWidth);
+                        dstInfo.alphaType(), decode.fFrameHasAlpha, scaledWidth);
                 dst = SkTAddOffset<void>(dst, rowBytes);
             } else {
                 xformDst = SkTAddOffset<void>(xformDst, rowBytes);
@@ -540,11 +669,11 @@ SkCodec::Result SkWebpCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst,
             xformSrc = SkTAddOffset<uint32_t>(xformSrc, srcRowBytes);
         }
     } else if (blendWithPrevFrame) {
-        const uint8_t* src = config.output.u.RGBA.rgba;
+        const uint8_t* src = config.output.u.RGBA.rgba + srcRowBytes * firstRow;
 
-        for (int y = 0; y < rowsDecoded; y++) {
-            blend_line(dstCT, dst, webpDst.colorType(), src,
-                    dstInfo.alphaType(), frame.has_alpha, scaledWidth);
+        for (int y = firstRow; y < rowsDecoded; y++) {
+            blend_line(dstCT, dst, decode.fWebpColorType, src,
+                    dstInfo.alphaType(), decode.fFrameHasAlpha, scaledWidth);
             src = SkTAddOffset<const uint8_t>(src, srcRowBytes);
             dst = SkTAddOffset<void>(dst, rowBytes);
         }
@@ -553,12 +682,49 @@ SkCodec::Result SkWebpCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst,
     return result;
 }
 
+void SkWebpCodec::readMoreData() {
+    if (!fPendingStream) {
+        return;
+    }
+
+    SkDynamicMemoryWStream received;
+    char buffer[4096];
+    while (size_t bytes = fPendingStream->read(buffer, sizeof(buffer))) {
+        received.write(buffer, bytes);
+    }
+    if (0 == received.bytesWritten()) {
+        return;
+    }
+
+    sk_sp<SkData> data = SkData::MakeUninitialized(fData->size() + received.bytesWritten());
+    memcpy(data->writable_data(), fData->data(), fData->size());
+    received.copyTo(SkTAddOffset<void>(data->writable_data(), fData->size()));
+
+    WebPData webpData = { data->bytes(), data->size() };
+    WebPDemuxState state;
+    SkAutoTCallVProc<WebPDemuxer, WebPDemuxDelete> demux(WebPDemuxPartial(&webpData, &state));
+    if (!demux || WEBP_DEMUX_PARSE_ERROR == state) {
+        // Stick with what we had; it decoded fine before.
+        fPendingStream.reset(nullptr);
+        return;
+    }
+    if (WEBP_DEMUX_DONE == state) {
+        fPendingStream.reset(nullptr);
+    }
+
+    // fDemux points into fData, so replace them together.
+    fDemux.reset(demux.release());
+    fData = std::move(data);
+}
+
 SkWebpCodec::SkWebpCodec(SkEncodedInfo&& info, std::unique_ptr<SkStream> stream,
-                         WebPDemuxer* demux, sk_sp<SkData> data, SkEncodedOrigin origin)
+                         WebPDemuxer* demux, sk_sp<SkData> data, SkEncodedOrigin origin,
+                         std::unique_ptr<SkStream> pendingStream)
     : INHERITED(std::move(info), skcms_PixelFormat_BGRA_8888, std::move(stream),
                 origin)
     , fDemux(demux)
     , fData(std::move(data))
+    , fPendingStream(std::move(pendingStream))
     , fFailed(false)
 {
     const auto& eInfo = this->getEncodedInfo();
@@ -14,7 +14,9 @@
 #include "include/core/SkTypes.h"
 #include "src/codec/SkFrameHolder.h"
 #include "src/codec/SkScalingCodec.h"
+#include "src/core/SkAutoMalloc.h"
 
+#include <memory>
 #include <vector>
 
 class SkStream;
@@ -28,8 +30,12 @@ public:
     // Assumes IsWebp was called and returned true.
     static std::unique_ptr<SkCodec> MakeFromStream(std::unique_ptr<SkStream>, Result*);
     static bool IsWebp(const void*, size_t);
+
+    ~SkWebpCodec() override;
 protected:
     Result onGetPixels(const SkImageInfo&, void*, size_t, const Options&, int*) override;
+    Result onStartIncrementalDecode(const SkImageInfo&, void*, size_t, const Options&) override;
+    Result onIncrementalDecode(int*) override;
     SkEncodedImageFormat onGetEncodedFormat() const override { return SkEncodedImageFormat::kWEBP; }
 
     bool onGetValidSubset(SkIRect* /* desiredSubset */) const override;
@@ -44,7 +50,18 @@ protected:
 
 private:
     SkWebpCodec(SkEncodedInfo&&, std::unique_ptr<SkStream>, WebPDemuxer*, sk_sp<SkData>,
-                SkEncodedOrigin);
+                SkEncodedOrigin, std::unique_ptr<SkStream> pendingStream);
+
+    // Sets up fDecode to decode a frame into dst.  Leaves fDecode null if there is nothing
+    // to decode (e.g. the frame does not intersect the subset).
+    Result startDecode(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, const Options&);
+
+    // Feeds all the data received so far to fDecode, and finishes (color transforms and
+    // blends) any newly decoded rows.  Reports the rows of the frame that are done.
+    Result decodeAvailableRows(int* rowsDecoded);
+
+    // Appends anything that has arrived on fPendingStream to fData and re-parses it.
+    void readMoreData();
 
     SkAutoTCallVProc<WebPDemuxer, WebPDemuxDelete> fDemux;
 
@@ -52,6 +69,17 @@ private:
     // This should not be freed until the decode is completed.
     sk_sp<SkData> fData;
 
+    // Set when the stream had to be copied into fData before it was complete.  Incremental
+    // decodes read the rest of the image from it as it arrives.
+    std::unique_ptr<SkStream> fPendingStream;
+
+    struct Decode;
+    std::unique_ptr<Decode> fDecode;
+
+    // Frames that are blended with a prior frame or color transformed into a non-8888 dst are
+    // decoded into a separate buffer first.  It is reused from frame to frame.
+    SkAutoMalloc fFrameStorage;
+
     class Frame : public SkFrame {
     public:
         Frame(int i, SkEncodedInfo::Alpha alpha)
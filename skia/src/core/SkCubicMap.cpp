@@ -74,6 +74,71 @@ float SkCubicMap::computeYFromX(float x) const {
     return y;
 }
 
+void SkCubicMap::ComputeYFromX(const SkCubicMap* const maps[], const float x[], float y[],
+                               int count) {
+    // General solver entries are gathered into SoA lanes and solved sixteen at a time with the
+    // SkOpts::cubic_solver() Halley iterations; lanes stop updating once converged, as in the
+    // scalar loop.  Everything else takes the scalar path.
+    //
+    // Each iteration is a long dependency chain (ending in a divide), so we run several
+    // independent vectors at once to keep the pipeline busy, rather than a single 4-wide one.
+    float ax[16], bx[16], cx[16], ay[16], by[16], cy[16], lx[16];
+    int   lanes[16];
+    int   laneCount = 0;
+
+    auto solve = [&]() {
+        for (int i = laneCount; i < 16; ++i) {
+            // Pad with copies of the first lane.
+            ax[i] = ax[0]; bx[i] = bx[0]; cx[i] = cx[0];
+            ay[i] = ay[0]; by[i] = by[0]; cy[i] = cy[0];
+            lx[i] = lx[0];
+        }
+
+        const Sk16f A = Sk16f::Load(ax), B = Sk16f::Load(bx), C = Sk16f::Load(cx),
+                    X = Sk16f::Load(lx);
+        Sk16f t = X;
+        for (int iters = 0; iters < 8; ++iters) {
+            const Sk16f f = ((A * t + B) * t + C) * t - X;
+            const auto converged = f.abs() <= 0.00005f;
+            if (converged.allTrue()) {
+                break;
+            }
+            const Sk16f fp  = (A * 3 * t + B * 2) * t + C,
+                        fpp = A * 6 * t + B * 2;
+            t = converged.thenElse(t, t - (fp * f * 2) / (fp * fp * 2 - f * fpp));
+        }
+
+        float ly[16];
+        (((Sk16f::Load(ay) * t + Sk16f::Load(by)) * t + Sk16f::Load(cy)) * t).store(ly);
+        for (int i = 0; i < laneCount; ++i) {
+            y[lanes[i]] = ly[i];
+        }
+        laneCount = 0;
+    };
+
+    for (int i = 0; i < count; ++i) {
+        const SkCubicMap* map = maps[i];
+        const float xi = SkScalarPin(x[i], 0, 1);
+        if (map->fType != kSolver_Type || nearly_zero(xi) || nearly_zero(1 - xi)) {
+            y[i] = map->computeYFromX(xi);
+            continue;
+        }
+
+        ax[laneCount] = map->fCoeff[0].fX; ay[laneCount] = map->fCoeff[0].fY;
+        bx[laneCount] = map->fCoeff[1].fX; by[laneCount] = map->fCoeff[1].fY;
+        cx[laneCount] = map->fCoeff[2].fX; cy[laneCount] = map->fCoeff[2].fY;
+        lx[laneCount] = xi;
+        lanes[laneCount++] = i;
+        if (laneCount == 16) {
+            solve();
+        }
+    }
+
+    if (laneCount > 0) {
+        solve();
+    }
+}
+
 static inline bool coeff_nearly_zero(float delta) {
     return sk_float_abs(delta) <= 0.0000001f;
 }
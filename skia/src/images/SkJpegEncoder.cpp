@@ -161,6 +161,10 @@ bool SkJpegEncoderMgr::setParams(const SkImageInfo& srcInfo, const SkJpegEncoder
     // for the image.  This improves compression at the cost of
     // slower encode performance.
     fCInfo.optimize_coding = TRUE;
+
+    if (options.fRestartRows > 0) {
+        fCInfo.restart_in_rows = options.fRestartRows;
+    }
     return true;
 }
 
@@ -2356,6 +2356,11 @@ STAGE(evenly_spaced_2_stop_gradient, const void* ctx) {
     a = mad(t, c->f[3], c->b[3]);
 }
 
+STAGE(gradient_lut, const SkRasterPipeline_GradientLUTCtx* c) {
+    auto t = clamp_01(r);
+    from_8888(gather(c->colors, trunc_(mad(t, c->scale, 0.5f))), &r,&g,&b,&a);
+}
+
 STAGE(xy_to_unit_angle, Ctx::None) {
     F X = r,
       Y = g;
@@ -3875,6 +3880,11 @@ STAGE_GP(evenly_spaced_2_stop_gradient, const SkRasterPipeline_EvenlySpaced2Stop
                    &r,&g,&b,&a);
 }
 
+STAGE_GP(gradient_lut, const SkRasterPipeline_GradientLUTCtx* c) {
+    auto t = clamp_01(x);
+    from_8888(gather<U32>(c->colors, trunc_(mad(t, c->scale, 0.5f))), &r,&g,&b,&a);
+}
+
 STAGE_GG(xy_to_unit_angle, Ctx::None) {
     F xabs = abs_(x),
       yabs = abs_(y);
@@ -8,6 +8,7 @@
 #include "src/pathops/SkOpCoincidence.h"
 #include "src/pathops/SkOpEdgeBuilder.h"
 #include "src/pathops/SkPathOpsCommon.h"
+#include "src/pathops/SkPathOpsPolygon.h"
 #include "src/pathops/SkPathWriter.h"
 
 #include <utility>
@@ -378,5 +379,9 @@ bool Op(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result) {
         return true;
     }
 #endif
+    // Line-only inputs (rects, polygons) skip the curve intersection machinery.
+    if (PolygonOp(one, two, op, result)) {
+        return true;
+    }
     return OpDebug(one, two, op, result  SkDEBUGPARAMS(true) SkDEBUGPARAMS(nullptr));
 }
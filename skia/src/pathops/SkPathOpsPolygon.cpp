@@ -0,0 +1,364 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "src/pathops/SkPathOpsPolygon.h"
+
+#include "include/core/SkPath.h"
+#include "src/pathops/SkPathOpsPoint.h"
+
+#include <algorithm>
+#include <vector>
+
+/*  The plane is cut into horizontal slabs at every vertex and every edge crossing, so that no
+    two edges cross inside a slab. Within a slab, the active edges are ordered left to right.
+    Walking them while tracking the winding of each operand finds the spans that are inside the
+    result. The outline is then:
+      - the slab edges where the result changes from outside to inside, or the reverse;
+      - the horizontal pieces where the spans above and below a slab boundary differ.
+    These segments are directed so that the result is always on the same side, and are chained
+    into closed contours. Every point is derived from one edge evaluated at one y, so segment
+    ends meet exactly and the chaining needs no tolerance.
+*/
+
+namespace {
+
+// Past this, the quadratic worst case of the slab walk loses to the general engine.
+constexpr size_t kMaxPolygonEdges = 1024;
+
+struct PolygonEdge {
+    SkDPoint fTop;      // fTop.fY < fBottom.fY
+    SkDPoint fBottom;
+    int fWinding;       // +1 if the path edge points down, -1 if it points up
+    int fOperand;       // 0 for the first path, 1 for the second
+
+    double xAt(double y) const {
+        if (y == fTop.fY) {
+            return fTop.fX;
+        }
+        if (y == fBottom.fY) {
+            return fBottom.fX;
+        }
+        return fTop.fX + (y - fTop.fY) * (fBottom.fX - fTop.fX) / (fBottom.fY - fTop.fY);
+    }
+};
+
+// A directed piece of the result outline, with the result on its right (y down).
+// fSource is the edge the segment lies on, or -1 if horizontal; runs of segments with the same
+// source are collinear and merged when writing the path.
+struct OutlineSegment {
+    SkDPoint fStart;
+    SkDPoint fEnd;
+    int fSource;
+};
+
+struct SpanEnd {
+    double fX;
+    int fDelta;
+};
+
+struct SlabEdge {
+    double fTopX;
+    double fBottomX;
+    int fIndex;
+};
+
+bool add_edges(const SkPath& path, int operand, std::vector<PolygonEdge>* edges) {
+    SkPath::Iter iter(path, true);
+    SkPoint pts[4];
+    SkPath::Verb verb;
+    while ((verb = iter.next(pts)) != SkPath::kDone_Verb) {
+        if (verb != SkPath::kLine_Verb || pts[0].fY == pts[1].fY) {
+            // Horizontal edges do not change any winding; their ends are shared with the
+            // adjacent edges, so the slabs still break there.
+            continue;
+        }
+        if (edges->size() >= kMaxPolygonEdges) {
+            return false;
+        }
+        PolygonEdge edge;
+        bool down = pts[0].fY < pts[1].fY;
+        edge.fTop.set(pts[down ? 0 : 1]);
+        edge.fBottom.set(pts[down ? 1 : 0]);
+        edge.fWinding = down ? 1 : -1;
+        edge.fOperand = operand;
+        edges->push_back(edge);
+    }
+    return true;
+}
+
+bool crossing_y(const PolygonEdge& a, const PolygonEdge& b, double* y) {
+    const SkDVector r = a.fBottom - a.fTop;
+    const SkDVector s = b.fBottom - b.fTop;
+    const double denom = r.cross(s);
+    if (denom == 0) {
+        // Parallel or collinear: any shared range starts and ends at vertices.
+        return false;
+    }
+    const SkDVector q = b.fTop - a.fTop;
+    const double t = q.cross(s) / denom;
+    const double u = q.cross(r) / denom;
+    if (!(t > 0 && t < 1 && u > 0 && u < 1)) {
+        return false;
+    }
+    *y = a.fTop.fY + t * r.fY;
+    return *y > a.fTop.fY && *y < a.fBottom.fY && *y > b.fTop.fY && *y < b.fBottom.fY;
+}
+
+bool inside_fill(int winding, bool evenOdd, bool inverse) {
+    return (evenOdd ? (winding & 1) != 0 : winding != 0) != inverse;
+}
+
+bool apply_op(SkPathOp op, bool one, bool two) {
+    switch (op) {
+        case kDifference_SkPathOp:        return one && !two;
+        case kIntersect_SkPathOp:         return one && two;
+        case kUnion_SkPathOp:             return one || two;
+        case kXOR_SkPathOp:               return one != two;
+        case kReverseDifference_SkPathOp: return two && !one;
+    }
+    SkASSERT(0);
+    return false;
+}
+
+// Emits the horizontal outline at y, where the spans ending above (|above|) and the spans
+// starting below (|below|) differ. Spans are flattened [left, right] pairs.
+//
+// This is the sum of the span tops (left to right) and bottoms (right to left), so it closes
+// the outline even where rounding makes spans touch or overlap by an ulp at an edge crossing.
+void add_horizontals(const std::vector<double>& above, const std::vector<double>& below,
+                     double y, std::vector<SpanEnd>* ends,
+                     std::vector<OutlineSegment>* segments) {
+    ends->clear();
+    for (size_t i = 0; i < above.size(); i += 2) {
+        ends->push_back({above[i], -1});
+        ends->push_back({above[i + 1], 1});
+    }
+    for (size_t i = 0; i < below.size(); i += 2) {
+        ends->push_back({below[i], 1});
+        ends->push_back({below[i + 1], -1});
+    }
+    std::sort(ends->begin(), ends->end(), [](const SpanEnd& a, const SpanEnd& b) {
+        return a.fX < b.fX;
+    });
+
+    int coverage = 0;       // spans below minus spans above
+    int lastCoverage = 0;
+    for (size_t i = 0; i < ends->size(); ) {
+        const double left = (*ends)[i].fX;
+        for (; i < ends->size() && (*ends)[i].fX == left; ++i) {
+            coverage += (*ends)[i].fDelta;
+        }
+        if (i == ends->size()) {
+            break;
+        }
+        const double right = (*ends)[i].fX;
+        if (coverage == 1 && lastCoverage == 1) {
+            // Contiguous pieces going the same way are extended rather than split.
+            segments->back().fEnd = SkDPoint{right, y};
+        } else if (coverage == -1 && lastCoverage == -1) {
+            segments->back().fStart = SkDPoint{right, y};
+        } else {
+            // The top of a region below runs left to right, the bottom of one above right to
+            // left.
+            for (int n = 0; n < coverage; ++n) {
+                segments->push_back({{left, y}, {right, y}, -1});
+            }
+            for (int n = 0; n > coverage; --n) {
+                segments->push_back({{right, y}, {left, y}, -1});
+            }
+        }
+        lastCoverage = coverage;
+    }
+}
+
+void add_contours(const std::vector<OutlineSegment>& segments, SkPath* path) {
+    auto startLess = [](const SkDPoint& a, const SkDPoint& b) {
+        return a.fY < b.fY || (a.fY == b.fY && a.fX < b.fX);
+    };
+    std::vector<int> byStart(segments.size());
+    for (size_t i = 0; i < segments.size(); ++i) {
+        byStart[i] = (int) i;
+    }
+    std::sort(byStart.begin(), byStart.end(), [&](int a, int b) {
+        return startLess(segments[a].fStart, segments[b].fStart);
+    });
+
+    std::vector<bool> used(segments.size(), false);
+    auto findNext = [&](const SkDPoint& pt) {
+        auto it = std::lower_bound(byStart.begin(), byStart.end(), pt,
+                                   [&](int i, const SkDPoint& p) {
+            return startLess(segments[i].fStart, p);
+        });
+        for (; it != byStart.end() && segments[*it].fStart == pt; ++it) {
+            if (!used[*it]) {
+                return *it;
+            }
+        }
+        return -1;
+    };
+
+    std::vector<int> contour;
+    for (int first : byStart) {
+        if (used[first]) {
+            continue;
+        }
+        // Vertices where several contours touch are left in whichever order comes first: all
+        // segments keep the result on the same side, so any pairing fills the same area.
+        contour.clear();
+        for (int index = first; index >= 0; index = findNext(segments[index].fEnd)) {
+            used[index] = true;
+            contour.push_back(index);
+        }
+        const size_t count = contour.size();
+        if (count < 3) {
+            continue;
+        }
+        // Start on a change of source, so that no collinear run wraps around.
+        auto source = [&](size_t i) { return segments[contour[i % count]].fSource; };
+        size_t start = 0;
+        while (start < count && source(start) == source(start + count - 1)) {
+            ++start;
+        }
+        if (start == count) {
+            continue;
+        }
+        const SkDPoint& origin = segments[contour[start]].fStart;
+        SkPoint last = origin.asSkPoint();
+        path->moveTo(last);
+        for (size_t i = 0; i + 1 < count; ++i) {
+            const auto& segment = segments[contour[(start + i) % count]];
+            const auto& next = segments[contour[(start + i + 1) % count]];
+            // Pieces which only exist at double precision (around crossings) collapse here.
+            const SkPoint pt = segment.fEnd.asSkPoint();
+            if (segment.fSource != next.fSource && pt != last) {
+                path->lineTo(pt);
+                last = pt;
+            }
+        }
+        path->close();
+    }
+}
+
+}  // namespace
+
+bool PolygonOp(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result) {
+    if ((one.getSegmentMasks() | two.getSegmentMasks()) & ~SkPath::kLine_SegmentMask) {
+        return false;
+    }
+    if (!one.isFinite() || !two.isFinite()) {
+        return false;
+    }
+    std::vector<PolygonEdge> edges;
+    if (!add_edges(one, 0, &edges) || !add_edges(two, 1, &edges)) {
+        return false;
+    }
+
+    const bool evenOdd[2] = {
+        (one.getFillType() & 1) != 0,
+        (two.getFillType() & 1) != 0,
+    };
+    const bool inverse[2] = {
+        one.isInverseFillType(),
+        two.isInverseFillType(),
+    };
+    // The area far outside of both paths decides whether the result is inverse filled; the
+    // outline traces where the result differs from it.
+    const bool outerInside = apply_op(op, inverse[0], inverse[1]);
+
+    std::sort(edges.begin(), edges.end(), [](const PolygonEdge& a, const PolygonEdge& b) {
+        return a.fTop.fY < b.fTop.fY;
+    });
+
+    // Slab boundaries: every vertex, plus every crossing, found by sweeping the edges in top
+    // order and only testing pairs which overlap vertically.
+    std::vector<double> ys;
+    ys.reserve(edges.size() * 2);
+    std::vector<int> active;
+    for (size_t i = 0; i < edges.size(); ++i) {
+        const PolygonEdge& edge = edges[i];
+        ys.push_back(edge.fTop.fY);
+        ys.push_back(edge.fBottom.fY);
+        active.erase(std::remove_if(active.begin(), active.end(), [&](int j) {
+            return edges[j].fBottom.fY <= edge.fTop.fY;
+        }), active.end());
+        for (int j : active) {
+            double y;
+            if (crossing_y(edges[j], edge, &y)) {
+                ys.push_back(y);
+            }
+        }
+        active.push_back((int) i);
+    }
+    std::sort(ys.begin(), ys.end());
+    ys.erase(std::unique(ys.begin(), ys.end()), ys.end());
+
+    std::vector<OutlineSegment> segments;
+    std::vector<SlabEdge> slab;
+    std::vector<double> aboveSpans, topSpans, bottomSpans;
+    std::vector<SpanEnd> spanEnds;
+    size_t nextEdge = 0;
+    active.clear();
+    for (size_t k = 0; k < ys.size(); ++k) {
+        const double y0 = ys[k];
+        topSpans.clear();
+        bottomSpans.clear();
+        if (k + 1 < ys.size()) {
+            const double y1 = ys[k + 1];
+            active.erase(std::remove_if(active.begin(), active.end(), [&](int j) {
+                return edges[j].fBottom.fY <= y0;
+            }), active.end());
+            while (nextEdge < edges.size() && edges[nextEdge].fTop.fY <= y0) {
+                active.push_back((int) nextEdge++);
+            }
+
+            slab.clear();
+            for (int j : active) {
+                slab.push_back({edges[j].xAt(y0), edges[j].xAt(y1), j});
+            }
+            std::sort(slab.begin(), slab.end(), [](const SlabEdge& a, const SlabEdge& b) {
+                const double midA = a.fTopX + a.fBottomX;
+                const double midB = b.fTopX + b.fBottomX;
+                return midA < midB || (midA == midB && a.fTopX < b.fTopX);
+            });
+
+            int winding[2] = { 0, 0 };
+            bool inside = false;
+            for (size_t i = 0; i < slab.size(); ) {
+                const SlabEdge& first = slab[i];
+                // Coincident edges are crossed together, so no empty span opens between them.
+                do {
+                    const PolygonEdge& edge = edges[slab[i].fIndex];
+                    winding[edge.fOperand] += edge.fWinding;
+                    ++i;
+                } while (i < slab.size() && slab[i].fTopX == first.fTopX
+                                         && slab[i].fBottomX == first.fBottomX);
+                const bool nowInside = outerInside != apply_op(op,
+                        inside_fill(winding[0], evenOdd[0], inverse[0]),
+                        inside_fill(winding[1], evenOdd[1], inverse[1]));
+                if (nowInside == inside) {
+                    continue;
+                }
+                if (nowInside) {
+                    segments.push_back({{first.fBottomX, y1}, {first.fTopX, y0}, first.fIndex});
+                } else {
+                    segments.push_back({{first.fTopX, y0}, {first.fBottomX, y1}, first.fIndex});
+                }
+                topSpans.push_back(first.fTopX);
+                bottomSpans.push_back(first.fBottomX);
+                inside = nowInside;
+            }
+            SkASSERT(!inside);
+        }
+        add_horizontals(aboveSpans, topSpans, y0, &spanEnds, &segments);
+        aboveSpans.swap(bottomSpans);
+    }
+
+    SkPath path;
+    path.setFillType(outerInside ? SkPath::kInverseEvenOdd_FillType : SkPath::kEvenOdd_FillType);
+    add_contours(segments, &path);
+    result->swap(path);
+    return true;
+}
@@ -0,0 +1,22 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#ifndef SkPathOpsPolygon_DEFINED
+#define SkPathOpsPolygon_DEFINED
+
+#include "include/pathops/SkPathOps.h"
+
+class SkPath;
+
+// Boolean operation restricted to paths made only of line segments (rects, polygons, flattened
+// curves), using a sweep over horizontal slabs instead of the general curve intersection engine.
+// The result covers the same area as OpDebug(), with the same (possibly inverse) even-odd fill.
+//
+// Returns false without touching the result if either input has curves, is not finite or is
+// too complex for the sweep; callers then fall back to the general engine.
+bool PolygonOp(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result);
+
+#endif
@@ -8,11 +8,17 @@
 #include "src/pdf/SkDeflate.h"
 
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/private/SkMalloc.h"
+#include "include/private/SkSemaphore.h"
 #include "include/private/SkTo.h"
 #include "src/core/SkMakeUnique.h"
 #include "src/core/SkTraceEvent.h"
 
+#include <atomic>
+#include <deque>
+#include <vector>
+
 #include "zlib.h"
 
 namespace {
@@ -55,20 +61,187 @@ static void do_deflate(int flush,
                  : returnValue == Z_OK);
 }
 
+// Parallel mode: the input is cut into chunks of kParallelChunkSize bytes, each compressed
+// independently as raw deflate data.  A chunk is primed with the kDictionarySize bytes of input
+// preceding it (deflateSetDictionary), so matches can still reach back across the cut, and ends
+// on a sync flush, which byte-aligns the output without marking a final block: concatenated in
+// order, the chunks form a single deflate stream.  The zlib or gzip framing is written here, with
+// the per-chunk checksums combined at the end.
+static constexpr size_t kParallelChunkSize = 128 * 1024;
+static constexpr size_t kDictionarySize    = 32 * 1024;
+// Bounds the memory held by chunks waiting to be written out, in order.
+static constexpr size_t kMaxPendingChunks  = 8;
+
+namespace {
+
+struct DeflateChunk {
+    std::vector<unsigned char> fInput;  // Dictionary followed by the chunk data.
+    size_t fDictionarySize;
+    size_t fDataSize;
+    int fCompressionLevel;
+    bool fGzip;
+    bool fLast;
+
+    SkDynamicMemoryWStream fOutput;
+    uLong fChecksum;
+
+    // A chunk runs exactly once, either on the executor or on the writing thread when it is
+    // needed before the executor got to it, so writers never block on a busy pool.
+    std::atomic<bool> fClaimed{false};
+    SkSemaphore fDone;
+
+    void tryRun() {
+        if (!fClaimed.exchange(true)) {
+            this->run();
+            fDone.signal();
+        }
+    }
+
+    void finish() {
+        if (!fClaimed.exchange(true)) {
+            this->run();
+        } else {
+            fDone.wait();
+        }
+    }
+
+    void run() {
+        TRACE_EVENT0("skia", TRACE_FUNC);
+        unsigned char* data = fInput.data() + fDictionarySize;
+        z_stream zStream;
+        zStream.next_in = nullptr;
+        zStream.zalloc = &skia_alloc_func;
+        zStream.zfree = &skia_free_func;
+        zStream.opaque = nullptr;
+        SkDEBUGCODE(int r =) deflateInit2(&zStream, fCompressionLevel, Z_DEFLATED, -15,
+                                          8, Z_DEFAULT_STRATEGY);
+        SkASSERT(Z_OK == r);
+        if (fDictionarySize > 0) {
+            deflateSetDictionary(&zStream, fInput.data(), SkToUInt(fDictionarySize));
+        }
+        do_deflate(fLast ? Z_FINISH : Z_SYNC_FLUSH, &zStream, &fOutput, data, fDataSize);
+        (void)deflateEnd(&zStream);
+        fChecksum = fGzip ? crc32(crc32(0, nullptr, 0), data, SkToUInt(fDataSize))
+                          : adler32(adler32(0, nullptr, 0), data, SkToUInt(fDataSize));
+        // The input is no longer needed; release it before the chunk waits to be written out.
+        std::vector<unsigned char>().swap(fInput);
+    }
+};
+
+void write_u32_be(SkWStream* out, uint32_t v) {
+    const unsigned char bytes[] = {
+        (unsigned char)(v >> 24), (unsigned char)(v >> 16), (unsigned char)(v >> 8),
+        (unsigned char)v };
+    out->write(bytes, sizeof(bytes));
+}
+
+void write_u32_le(SkWStream* out, uint32_t v) {
+    const unsigned char bytes[] = {
+        (unsigned char)v, (unsigned char)(v >> 8), (unsigned char)(v >> 16),
+        (unsigned char)(v >> 24) };
+    out->write(bytes, sizeof(bytes));
+}
+
+// Same header bytes as deflateInit2() writes for the given level.
+void write_header(SkWStream* out, int compressionLevel, bool gzip) {
+    const int level = compressionLevel < 0 ? 6 : compressionLevel;
+    if (gzip) {
+        const unsigned char header[] = {
+            0x1f, 0x8b, Z_DEFLATED, 0,           // ID1, ID2, CM, FLG
+            0, 0, 0, 0,                          // MTIME
+            (unsigned char)(level == 9 ? 2 : (level < 2 ? 4 : 0)),  // XFL
+            3,                                   // OS (unix)
+        };
+        out->write(header, sizeof(header));
+    } else {
+        const unsigned cmf = 0x78;  // deflate, 32K window
+        unsigned flg = (level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3) << 6;
+        flg += 31 - ((cmf << 8) + flg) % 31;
+        const unsigned char header[] = { (unsigned char)cmf, (unsigned char)flg };
+        out->write(header, sizeof(header));
+    }
+}
+
+}  // namespace
+
 // Hide all zlib impl details.
 struct SkDeflateWStream::Impl {
     SkWStream* fOut;
     unsigned char fInBuffer[SKDEFLATEWSTREAM_INPUT_BUFFER_SIZE];
     size_t fInBufferIndex;
     z_stream fZStream;
+
+    // Parallel mode only.
+    SkExecutor* fExecutor;
+    int fCompressionLevel;
+    bool fGzip;
+    std::vector<unsigned char> fChunk;  // Next chunk input, including its dictionary.
+    size_t fChunkDictionarySize;
+    std::deque<std::shared_ptr<DeflateChunk>> fPendingChunks;
+    bool fStarted;  // True once the header has been written.
+    uLong fChecksum;
+    size_t fTotalIn;
+
+    void dispatchChunk(bool last) {
+        if (!fStarted) {
+            write_header(fOut, fCompressionLevel, fGzip);
+            fChecksum = fGzip ? crc32(0, nullptr, 0) : adler32(0, nullptr, 0);
+            fStarted = true;
+        }
+        auto chunk = std::make_shared<DeflateChunk>();
+        chunk->fDictionarySize = fChunkDictionarySize;
+        chunk->fDataSize = fChunk.size() - fChunkDictionarySize;
+        chunk->fCompressionLevel = fCompressionLevel;
+        chunk->fGzip = fGzip;
+        chunk->fLast = last;
+        // The next chunk's dictionary is the tail of this chunk's input.
+        const size_t dictionarySize = SkTMin(kDictionarySize, fChunk.size());
+        std::vector<unsigned char> next;
+        if (!last) {
+            next.reserve(dictionarySize + kParallelChunkSize);
+            next.assign(fChunk.end() - dictionarySize, fChunk.end());
+        }
+        chunk->fInput = std::move(fChunk);
+        fChunk = std::move(next);
+        fChunkDictionarySize = dictionarySize;
+
+        fPendingChunks.push_back(chunk);
+        if (last) {
+            // Nothing left to overlap with: the final chunk runs here unless already picked up.
+            chunk->tryRun();
+        } else {
+            fExecutor->add([chunk]() { chunk->tryRun(); });
+        }
+        while (fPendingChunks.size() > (last ? 0 : kMaxPendingChunks)) {
+            this->writeFrontChunk();
+        }
+    }
+
+    void writeFrontChunk() {
+        std::shared_ptr<DeflateChunk> chunk = std::move(fPendingChunks.front());
+        fPendingChunks.pop_front();
+        chunk->finish();
+        chunk->fOutput.writeToAndReset(fOut);
+        const z_off_t size = (z_off_t)chunk->fDataSize;
+        fChecksum = fGzip ? crc32_combine(fChecksum, chunk->fChecksum, size)
+                          : adler32_combine(fChecksum, chunk->fChecksum, size);
+    }
 };
 
 SkDeflateWStream::SkDeflateWStream(SkWStream* out,
                                    int compressionLevel,
-                                   bool gzip)
+                                   bool gzip,
+                                   SkExecutor* executor)
     : fImpl(skstd::make_unique<SkDeflateWStream::Impl>()) {
     fImpl->fOut = out;
     fImpl->fInBufferIndex = 0;
+    fImpl->fExecutor = executor;
+    fImpl->fCompressionLevel = compressionLevel;
+    fImpl->fGzip = gzip;
+    fImpl->fChunkDictionarySize = 0;
+    fImpl->fStarted = false;
+    fImpl->fChecksum = 0;
+    fImpl->fTotalIn = 0;
     if (!fImpl->fOut) {
         return;
     }
@@ -81,6 +254,9 @@ SkDeflateWStream::SkDeflateWStream(SkWStream* out,
                                       Z_DEFLATED, gzip ? 0x1F : 0x0F,
                                       8, Z_DEFAULT_STRATEGY);
     SkASSERT(Z_OK == r);
+    if (fImpl->fExecutor) {
+        fImpl->fChunk.reserve(kParallelChunkSize);
+    }
 }
 
 SkDeflateWStream::~SkDeflateWStream() { this->finalize(); }
@@ -90,6 +266,24 @@ void SkDeflateWStream::finalize() {
     if (!fImpl->fOut) {
         return;
     }
+    if (fImpl->fExecutor) {
+        if (fImpl->fStarted) {
+            fImpl->dispatchChunk(true);
+            if (fImpl->fGzip) {
+                write_u32_le(fImpl->fOut, (uint32_t)fImpl->fChecksum);
+                write_u32_le(fImpl->fOut, (uint32_t)fImpl->fTotalIn);
+            } else {
+                write_u32_be(fImpl->fOut, (uint32_t)fImpl->fChecksum);
+            }
+            (void)deflateEnd(&fImpl->fZStream);
+            fImpl->fOut = nullptr;
+            return;
+        }
+        // Smaller than a chunk: compress serially, with the same output as without executor.
+        do_deflate(Z_NO_FLUSH, &fImpl->fZStream, fImpl->fOut, fImpl->fChunk.data(),
+                   fImpl->fChunk.size());
+        std::vector<unsigned char>().swap(fImpl->fChunk);
+    }
     do_deflate(Z_FINISH, &fImpl->fZStream, fImpl->fOut, fImpl->fInBuffer,
                fImpl->fInBufferIndex);
     (void)deflateEnd(&fImpl->fZStream);
@@ -102,6 +296,21 @@ bool SkDeflateWStream::write(const void* void_buffer, size_t len) {
         return false;
     }
     const char* buffer = (const char*)void_buffer;
+    if (fImpl->fExecutor) {
+        std::vector<unsigned char>& chunk = fImpl->fChunk;
+        while (len > 0) {
+            const size_t chunkEnd = fImpl->fChunkDictionarySize + kParallelChunkSize;
+            size_t tocopy = SkTMin(len, chunkEnd - chunk.size());
+            chunk.insert(chunk.end(), buffer, buffer + tocopy);
+            len -= tocopy;
+            buffer += tocopy;
+            fImpl->fTotalIn += tocopy;
+            if (chunk.size() == chunkEnd) {
+                fImpl->dispatchChunk(false);
+            }
+        }
+        return true;
+    }
     while (len > 0) {
         size_t tocopy =
                 SkTMin(len, sizeof(fImpl->fInBuffer) - fImpl->fInBufferIndex);
@@ -122,5 +331,8 @@ bool SkDeflateWStream::write(const void* void_buffer, size_t len) {
 }
 
 size_t SkDeflateWStream::bytesWritten() const {
+    if (fImpl->fExecutor) {
+        return fImpl->fTotalIn;
+    }
     return fImpl->fZStream.total_in + fImpl->fInBufferIndex;
 }
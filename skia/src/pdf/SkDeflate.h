@@ -11,6 +11,8 @@
 
 #include "include/core/SkStream.h"
 
+class SkExecutor;
+
 /**
   * Wrap a stream in this class to compress the information written to
   * this stream using the Deflate algorithm.
@@ -29,10 +31,18 @@ public:
         a wrapper, documented in RFC 1952, around a deflate stream."
         gzip adds a header with a magic number to the beginning of the
         stream, allowing a client to identify a gzip file.
+
+        @param executor if not null, large inputs are cut into chunks
+        which are compressed concurrently on the executor.  Each chunk
+        is primed with the 32K of input preceding it and ends on a sync
+        flush, so the output is still a single valid deflate stream,
+        only slightly larger than the serial one.  Does not take
+        ownership of the executor.
      */
     SkDeflateWStream(SkWStream*,
                      int compressionLevel = -1,
-                     bool gzip = false);
+                     bool gzip = false,
+                     SkExecutor* executor = nullptr);
 
     /** The destructor calls finalize(). */
     ~SkDeflateWStream() override;
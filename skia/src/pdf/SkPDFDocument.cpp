@@ -8,6 +8,8 @@
 #include "include/docs/SkPDFDocument.h"
 #include "src/pdf/SkPDFDocumentPriv.h"
 
+#include "include/core/SkExecutor.h"
+#include "include/core/SkPicture.h"
 #include "include/core/SkStream.h"
 #include "include/docs/SkPDFDocument.h"
 #include "include/private/SkTo.h"
@@ -225,6 +227,65 @@ static SkSize operator*(SkISize u, SkScalar s) { return SkSize{u.width() * s, u.
 static SkSize operator*(SkSize u, SkScalar s) { return SkSize{u.width() * s, u.height() * s}; }
 
 SkCanvas* SkPDFDocument::onBeginPage(SkScalar width, SkScalar height) {
+    if (fExecutor) {
+        SkASSERT(!fPageRecorder.getRecordingCanvas());
+        fRecordingPageSize = SkSize::Make(width, height);
+        return fPageRecorder.beginRecording(width, height);
+    }
+    return this->beginPageDevice(width, height);
+}
+
+void SkPDFDocument::onEndPage() {
+    if (!fExecutor) {
+        this->endPageDevice();
+        return;
+    }
+    PendingPage page = {fPageRecorder.finishRecordingAsPicture(), fRecordingPageSize};
+    fPendingPageSlots.wait();
+    bool startConverting;
+    {
+        SkAutoMutexExclusive lock(fPendingPagesMutex);
+        fPendingPages.push_back(std::move(page));
+        startConverting = !fConvertingPages;
+        fConvertingPages = true;
+    }
+    if (startConverting) {
+        fExecutor->add([this]() { this->convertPendingPages(); });
+    }
+}
+
+void SkPDFDocument::convertPendingPages() {
+    for (;;) {
+        PendingPage page;
+        {
+            SkAutoMutexExclusive lock(fPendingPagesMutex);
+            if (fPendingPages.empty()) {
+                fConvertingPages = false;
+                return;
+            }
+            page = std::move(fPendingPages.front());
+            fPendingPages.pop_front();
+        }
+        SkCanvas* canvas = this->beginPageDevice(page.fSize.width(), page.fSize.height());
+        page.fPicture->playback(canvas);
+        this->endPageDevice();
+        page.fPicture = nullptr;
+        fPendingPageSlots.signal();
+    }
+}
+
+void SkPDFDocument::waitForPages() {
+    if (!fExecutor) {
+        return;
+    }
+    // Every slot is free once the last page has been converted.
+    for (int i = 0; i < kMaxPendingPages; ++i) {
+        fPendingPageSlots.wait();
+    }
+    fPendingPageSlots.signal(kMaxPendingPages);
+}
+
+SkCanvas* SkPDFDocument::beginPageDevice(SkScalar width, SkScalar height) {
     SkASSERT(fCanvas.imageInfo().dimensions().isZero());
     if (fPages.empty()) {
         // if this is the first page if the document.
@@ -324,7 +385,7 @@ static SkPDFIndirectReference append_destinations(
     return doc->emit(destinations);
 }
 
-void SkPDFDocument::onEndPage() {
+void SkPDFDocument::endPageDevice() {
     SkASSERT(!fCanvas.imageInfo().dimensions().isZero());
     reset_object(&fCanvas);
     SkASSERT(fPageDevice);
@@ -355,6 +416,10 @@ void SkPDFDocument::onEndPage() {
 }
 
 void SkPDFDocument::onAbort() {
+    if (fPageRecorder.getRecordingCanvas()) {
+        fPageRecorder.finishRecordingAsPicture();
+    }
+    this->waitForPages();
     this->waitForJobs();
 }
 
@@ -518,6 +583,7 @@ static std::vector<const SkPDFFont*> get_fonts(const SkPDFDocument& canon) {
 }
 
 void SkPDFDocument::onClose(SkWStream* stream) {
+    this->waitForPages();
     SkASSERT(fCanvas.imageInfo().dimensions().isZero());
     if (fPages.empty()) {
         this->waitForJobs();
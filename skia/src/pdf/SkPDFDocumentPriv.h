@@ -8,6 +8,7 @@
 #define SkPDFDocumentPriv_DEFINED
 
 #include "include/core/SkCanvas.h"
+#include "include/core/SkPictureRecorder.h"
 #include "include/core/SkStream.h"
 #include "include/docs/SkPDFDocument.h"
 #include "include/private/SkMutex.h"
@@ -16,6 +17,7 @@
 #include "src/pdf/SkPDFTag.h"
 
 #include <atomic>
+#include <deque>
 #include <vector>
 #include <memory>
 
@@ -151,6 +153,26 @@ private:
     SkMutex fMutex;
     SkSemaphore fSemaphore;
 
+    // With an executor, pages are recorded on the calling thread and converted to PDF content
+    // on the executor, one at a time and in page order: all document state (canonicalized
+    // objects, object numbers) is then updated in the same sequence as without an executor.
+    struct PendingPage {
+        sk_sp<SkPicture> fPicture;
+        SkSize fSize;
+    };
+    // Recorded pages waiting for conversion; endPage() blocks past this, to bound memory.
+    static constexpr int kMaxPendingPages = 4;
+    SkPictureRecorder fPageRecorder;
+    SkSize fRecordingPageSize = SkSize::MakeEmpty();
+    SkMutex fPendingPagesMutex;
+    std::deque<PendingPage> fPendingPages;
+    bool fConvertingPages = false;
+    SkSemaphore fPendingPageSlots{kMaxPendingPages};
+
+    SkCanvas* beginPageDevice(SkScalar width, SkScalar height);
+    void endPageDevice();
+    void convertPendingPages();
+    void waitForPages();
     void waitForJobs();
     SkWStream* beginObject(SkPDFIndirectReference);
     void endObject();
@@ -9,6 +9,9 @@
 
 #include "src/ports/SkFontMgr_ohos.h"
 
+#include "include/private/SkTo.h"
+#include "src/core/SkOpts.h"
+
 SkFontMgr_OHOS::BuildFamilyMapCallback SkFontMgr_OHOS::buildFamilyMapCallback;
 
 SkFontMgr_OHOS::SkFontMgr_OHOS()
@@ -132,34 +135,16 @@ SkString SkFontMgr_OHOS::find_family_style_character_ohos(const SkString& family
     const SkTArray<NameToFamily, true>& fallbackNameToFamilyMap, const SkFontStyle& style, bool elegant,
     const SkString& langTag, SkUnichar character)
 {
-    SkString matchingName = findFromCache(familyName, style, elegant, langTag, character);
-    if (!matchingName.isEmpty()) {
-        return matchingName;
+    const FallbackMemo::Key key = { familyName, langTag, style, elegant,
+                                    character >> FallbackMemo::kBlockBits };
+    int16_t index = fallbackMemo.find(key, character);
+    if (index != FallbackMemo::kUnresolved) {
+        return index == FallbackMemo::kNoFamily ? SkString() : fallbackNameToFamilyMap[index].name;
     }
 
-    for (int i = 0; i < fallbackNameToFamilyMap.count(); ++i) {
-        SkFontStyleSet_OHOS* family = fallbackNameToFamilyMap[i].styleSet;
-        // TODO: process fallbackFor
-        SkTypeface* face = family->matchStyle(style);
-        if (!face) {
-            SkDEBUGF("face is null");
-            continue;
-        }
-
-        if (!family->matchLanguage(langTag)) {
-            continue;
-        }
-
-        if (family->haveVariant(kElegant_FontVariant) != elegant) {
-            continue;
-        }
-
-        if (face->unicharToGlyph(character) != 0) {
-            addToCache(&(fallbackNameToFamilyMap[i]));
-            return fallbackNameToFamilyMap[i].name;
-        }
-    }
-    return SkString();
+    std::lock_guard<std::mutex> lock(mutexCache);
+    index = resolveFallback(fallbackMemo, familyMapCache, false, fallbackNameToFamilyMap, key, character);
+    return index == FallbackMemo::kNoFamily ? SkString() : fallbackNameToFamilyMap[index].name;
 }
 
 SkString SkFontMgr_OHOS::find_family_style_character_hwfont(
@@ -167,115 +152,192 @@ SkString SkFontMgr_OHOS::find_family_style_character_hwfont(
     const SkTArray<NameToFamily, true> &fallbackNameToFamilyMap,
     const SkFontStyle &style, bool elegant, const SkString &langTag,
     SkUnichar character) {
-    SkString matchingName =
-        findFromHwFontCache(familyName, style, elegant, langTag, character);
-    if (!matchingName.isEmpty()) {
-        return matchingName;
+    const FallbackMemo::Key key = { familyName, langTag, style, elegant,
+                                    character >> FallbackMemo::kBlockBits };
+    int16_t index = hwFontFallbackMemo.find(key, character);
+    if (index != FallbackMemo::kUnresolved) {
+        return index == FallbackMemo::kNoFamily ? SkString() : fallbackNameToFamilyMap[index].name;
     }
 
-    // First find in HwThemeFont.
-    for (int i = 0; i < fallbackNameToFamilyMap.count(); ++i) {
-        SkFontStyleSet_OHOS *family = fallbackNameToFamilyMap[i].styleSet;
-        if (family->getHwFontFamilyType() > 0) {
-            SkTypeface *face = family->matchStyle(style);
-            if (!face) {
-                SkDEBUGF("face is null");
-                continue;
-            }
+    // Only HwThemeFont families are considered.
+    std::lock_guard<std::mutex> lock(mutexCache);
+    index = resolveFallback(hwFontFallbackMemo, hwFontFamilyMapCache, true, fallbackNameToFamilyMap, key,
+                            character);
+    return index == FallbackMemo::kNoFamily ? SkString() : fallbackNameToFamilyMap[index].name;
+}
 
-            if (!family->matchLanguage(langTag)) {
-               continue;
-            }
+// Resolves a character with the same precedence as the per-character search: the families which
+// were previously matched (familyCache, in matching order) first, then the fallback list, whose
+// match is added to familyCache.  Coverage is tested against per-block bitsets.
+// Must be called with mutexCache held.
+int16_t SkFontMgr_OHOS::resolveFallback(FallbackMemo& memo, SkTArray<const NameToFamily*, true>& familyCache,
+    bool hwFontOnly, const SkTArray<NameToFamily, true>& fallbackNameToFamilyMap,
+    const FallbackMemo::Key& key, SkUnichar character)
+{
+    // Another thread may have resolved this character while we were waiting for the lock.
+    int16_t index = memo.find(key, character);
+    if (index != FallbackMemo::kUnresolved) {
+        return index;
+    }
 
-            if (family->haveVariant(kElegant_FontVariant) != elegant) {
+    const int c = character & (FallbackMemo::kBlockSize - 1);
+    auto covers = [&](int i) {
+        SkFontStyleSet_OHOS* family = fallbackNameToFamilyMap[i].styleSet;
+        // TODO: process fallbackFor
+        sk_sp<SkTypeface> face(family->matchStyle(key.style));
+        if (!face) {
+            SkDEBUGF("face is null");
+            return false;
+        }
+        if (!family->matchLanguage(key.langTag) ||
+            family->haveVariant(kElegant_FontVariant) != key.elegant) {
+            return false;
+        }
+        return this->getCoverage(face.get(), key.block).test(c);
+    };
+
+    index = FallbackMemo::kNoFamily;
+    for (int i = 0; i < familyCache.count(); ++i) {
+        const int cached = familyCache[i] - fallbackNameToFamilyMap.begin();
+        if (covers(cached)) {
+            index = SkToS16(cached);
+            break;
+        }
+    }
+    if (index == FallbackMemo::kNoFamily) {
+        for (int i = 0; i < fallbackNameToFamilyMap.count(); ++i) {
+            if (hwFontOnly && fallbackNameToFamilyMap[i].styleSet->getHwFontFamilyType() <= 0) {
                 continue;
             }
-
-            if (face->unicharToGlyph(character) != 0) {
-                addToHwFontCache(&(fallbackNameToFamilyMap[i]));
-                return fallbackNameToFamilyMap[i].name;
+            if (covers(i)) {
+                index = SkToS16(i);
+                if (std::find(familyCache.begin(), familyCache.end(),
+                              &fallbackNameToFamilyMap[i]) == familyCache.end()) {
+                    familyCache.emplace_back(&fallbackNameToFamilyMap[i]);
+                }
+                break;
             }
         }
     }
-    return SkString();
+    memo.set(key, character, index);
+    return index;
 }
 
-SkString SkFontMgr_OHOS::findFromCache(const SkString& familyName, const SkFontStyle& style, bool elegant,
-                           const SkString& langTag, SkUnichar character)
+// Must be called with mutexCache held.
+const SkFontMgr_OHOS::Coverage& SkFontMgr_OHOS::getCoverage(SkTypeface* face, SkUnichar block)
 {
-    std::lock_guard<std::mutex> lock(mutexCache);
-    for (int i = 0; i < familyMapCache.count(); ++i) {
-        SkFontStyleSet_OHOS* family = familyMapCache[i]->styleSet;
-        // TODO: process fallbackFor
-        SkTypeface* face = family->matchStyle(style);
-        if (!face) {
-            SkDEBUGF("face is null");
-            continue;
-        }
+    const uint64_t key = (static_cast<uint64_t>(face->uniqueID()) << 32) | static_cast<uint32_t>(block);
+    auto iter = coverageCache.find(key);
+    if (iter != coverageCache.end()) {
+        return iter->second;
+    }
 
-        if (!family->matchLanguage(langTag)) {
-            continue;
-        }
+    SkUnichar chars[FallbackMemo::kBlockSize];
+    SkGlyphID glyphs[FallbackMemo::kBlockSize];
+    for (int c = 0; c < FallbackMemo::kBlockSize; ++c) {
+        chars[c] = (block << FallbackMemo::kBlockBits) + c;
+    }
+    face->unicharsToGlyphs(chars, FallbackMemo::kBlockSize, glyphs);
 
-        if (family->haveVariant(kElegant_FontVariant) != elegant) {
-            continue;
-        }
+    Coverage& coverage = coverageCache[key];
+    for (int c = 0; c < FallbackMemo::kBlockSize; ++c) {
+        coverage.set(c, glyphs[c] != 0);
+    }
+    return coverage;
+}
 
-        if (face->unicharToGlyph(character) != 0) {
-            return familyMapCache[i]->name;
-        }
+bool SkFontMgr_OHOS::FallbackMemo::Key::operator==(const Key& other) const
+{
+    return block == other.block && style == other.style && elegant == other.elegant &&
+           familyName == other.familyName && langTag == other.langTag;
+}
+
+uint32_t SkFontMgr_OHOS::FallbackMemo::Key::hash() const
+{
+    uint32_t hash = SkOpts::hash(familyName.c_str(), familyName.size(), block);
+    hash = SkOpts::hash(langTag.c_str(), langTag.size(), hash);
+    const int32_t styleBits[] = { style.weight(), style.width(), style.slant(), elegant };
+    return SkOpts::hash(styleBits, sizeof(styleBits), hash);
+}
+
+SkFontMgr_OHOS::FallbackMemo::FallbackMemo()
+    : fSlots(new std::atomic<Block*>[kCapacity])
+{
+    for (int i = 0; i < kCapacity; ++i) {
+        fSlots[i].store(nullptr, std::memory_order_relaxed);
     }
-    return SkString();
 }
 
-void SkFontMgr_OHOS::addToCache(const NameToFamily* item)
+SkFontMgr_OHOS::FallbackMemo::~FallbackMemo()
 {
-    std::lock_guard<std::mutex> lock(mutexCache);
-    for (int i = 0; i < familyMapCache.count(); ++i) {
-        if (item == familyMapCache[i]) {
-            return;
-        }
+    for (int i = 0; i < kCapacity; ++i) {
+        delete fSlots[i].load(std::memory_order_relaxed);
     }
-    familyMapCache.emplace_back(item);
 }
 
-SkString SkFontMgr_OHOS::findFromHwFontCache(const SkString& familyName, const SkFontStyle& style, bool elegant,
-                           const SkString& langTag, SkUnichar character)
+int16_t SkFontMgr_OHOS::FallbackMemo::find(const Key& key, SkUnichar character) const
 {
-    std::lock_guard<std::mutex> lock(mutexCache);
-    for (int i = 0; i < hwFontFamilyMapCache.count(); ++i) {
-        SkFontStyleSet_OHOS* family = hwFontFamilyMapCache[i]->styleSet;
-        // TODO: process fallbackFor
-        SkTypeface* face = family->matchStyle(style);
-        if (!face) {
-            SkDEBUGF("face is null");
-            continue;
+    if (character < 0 || character > SkUnichar(0x10FFFF)) {
+        return kNoFamily;
+    }
+    const uint32_t hash = key.hash();
+    // Open addressing with linear probing; slots are only ever filled, so an empty slot ends the probe.
+    for (int i = 0; i < kCapacity; ++i) {
+        const Block* block = fSlots[(hash + i) & (kCapacity - 1)].load(std::memory_order_acquire);
+        if (!block) {
+            break;
         }
-
-        if (!family->matchLanguage(langTag)) {
-            continue;
+        if (block->hash == hash && block->key == key) {
+            return block->resolved[character & (kBlockSize - 1)].load(std::memory_order_acquire);
         }
+    }
+    return kUnresolved;
+}
 
-        if (family->haveVariant(kElegant_FontVariant) != elegant) {
-            continue;
-        }
+SkFontMgr_OHOS::FallbackMemo::Block::Block(const Key& key, uint32_t hash)
+    : key(key), hash(hash)
+{
+    for (int c = 0; c < kBlockSize; ++c) {
+        resolved[c].store(kUnresolved, std::memory_order_relaxed);
+    }
+}
 
-        if (face->unicharToGlyph(character) != 0) {
-            return hwFontFamilyMapCache[i]->name;
+bool SkFontMgr_OHOS::FallbackMemo::set(const Key& key, SkUnichar character, int16_t index)
+{
+    if (character < 0 || character > SkUnichar(0x10FFFF)) {
+        return false;
+    }
+    const uint32_t hash = key.hash();
+    Block* block = nullptr;
+    for (int i = 0;; ++i) {
+        std::atomic<Block*>& slot = fSlots[(hash + i) & (kCapacity - 1)];
+        block = slot.load(std::memory_order_relaxed);
+        if (block && block->hash == hash && block->key == key) {
+            break;
+        }
+        if (!block) {
+            if (fCount >= kMaxCount) {
+                return false;
+            }
+            // The block is fully initialized before it is published.
+            block = new Block(key, hash);
+            slot.store(block, std::memory_order_release);
+            ++fCount;
+            break;
         }
     }
-    return SkString();
+    block->resolved[character & (kBlockSize - 1)].store(index, std::memory_order_release);
+    return true;
 }
 
-void SkFontMgr_OHOS::addToHwFontCache(const NameToFamily* item)
+void SkFontMgr_OHOS::FallbackMemo::clear()
 {
-    std::lock_guard<std::mutex> lock(mutexCache);
-    for (int i = 0; i < hwFontFamilyMapCache.count(); ++i) {
-        if (item == hwFontFamilyMapCache[i]) {
-            return;
+    for (int i = 0; i < kCapacity; ++i) {
+        if (Block* block = fSlots[i].exchange(nullptr, std::memory_order_acq_rel)) {
+            fRetired.emplace_back(block);
         }
     }
-    hwFontFamilyMapCache.emplace_back(item);
+    fCount = 0;
 }
 
 SkTypeface* SkFontMgr_OHOS::onMatchFamilyStyleCharacter(
@@ -401,6 +463,13 @@ void SkFontMgr_OHOS::buildNameToFamilyMap()
     if (buildFamilyMapCallback) {
         buildFamilyMapCallback(fNameToFamilyMap, fFallbackNameToFamilyMap, fStyleSets, fAliasMap);
     }
+    // The fallback resolutions refer to the previous fallback families by index.
+    std::lock_guard<std::mutex> lock(mutexCache);
+    familyMapCache.reset();
+    hwFontFamilyMapCache.reset();
+    fallbackMemo.clear();
+    hwFontFallbackMemo.clear();
+    coverageCache.clear();
 }
 
 void SkFontMgr_OHOS::findDefaultStyleSet()
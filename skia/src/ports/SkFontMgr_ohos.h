@@ -9,9 +9,13 @@
 #define SkFontMgr_ohos_DEFINED
 
 #include <algorithm>
+#include <atomic>
+#include <bitset>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "include/core/SkFontMgr.h"
@@ -344,13 +348,68 @@ private:
         const SkTArray<NameToFamily, true>& fallbackNameToFamilyMap,
         const SkFontStyle& style, bool elegant,
         const SkString& langTag, SkUnichar character);
-    void addToCache(const NameToFamily* item);
-    SkString findFromCache(const SkString& familyName, const SkFontStyle& style, bool elegant,
-                           const SkString& langTag, SkUnichar character);
 
-    void addToHwFontCache(const NameToFamily* item);
-    SkString findFromHwFontCache(const SkString& familyName, const SkFontStyle& style, bool elegant,
-                           const SkString& langTag, SkUnichar character);
+    // Memoized fallback resolutions, keyed by (family, style, elegant, language, codepoint block).
+    // Characters are resolved one at a time on their first miss (under mutexCache), since the
+    // result depends on the families matched before, and published for lock-free lookups.
+    // A resolved character keeps its result: the family cache is only ever appended to.
+    class FallbackMemo {
+    public:
+        static constexpr int kBlockBits = 7;
+        static constexpr int kBlockSize = 1 << kBlockBits;
+        static constexpr int16_t kNoFamily   = -1; // No fallback family covers the character.
+        static constexpr int16_t kUnresolved = -2; // Not memoized (yet).
+
+        struct Key {
+            SkString familyName;
+            SkString langTag;
+            SkFontStyle style;
+            bool elegant;
+            SkUnichar block; // character >> kBlockBits
+
+            bool operator==(const Key& other) const;
+            uint32_t hash() const;
+        };
+
+        FallbackMemo();
+        ~FallbackMemo();
+
+        // Returns the index of the fallback family resolved for |character|, kNoFamily or
+        // kUnresolved.  Lock-free.
+        int16_t find(const Key& key, SkUnichar character) const;
+
+        // Publishes the resolution of |character|.  Callers are serialized by mutexCache.
+        // Returns false (and drops the resolution) when the memo is full.
+        bool set(const Key& key, SkUnichar character, int16_t index);
+
+        // Forgets all the resolutions.  Callers are serialized by mutexCache.  The blocks are
+        // retired rather than deleted, as lock-free readers may still be using them.
+        void clear();
+
+    private:
+        struct Block {
+            Block(const Key& key, uint32_t hash);
+
+            Key key;
+            uint32_t hash;
+            std::atomic<int16_t> resolved[kBlockSize];
+        };
+
+        static constexpr int kCapacity = 1024; // Power of two.
+        static constexpr int kMaxCount = kCapacity * 3 / 4;
+
+        std::unique_ptr<std::atomic<Block*>[]> fSlots;
+        std::vector<std::unique_ptr<Block>> fRetired;
+        int fCount = 0;
+    };
+
+    using Coverage = std::bitset<FallbackMemo::kBlockSize>;
+
+    int16_t resolveFallback(FallbackMemo& memo, SkTArray<const NameToFamily*, true>& familyCache,
+                             bool hwFontOnly,
+                             const SkTArray<NameToFamily, true>& fallbackNameToFamilyMap,
+                             const FallbackMemo::Key& key, SkUnichar character);
+    const Coverage& getCoverage(SkTypeface* face, SkUnichar block);
 
     SkTArray<sk_sp<SkFontStyleSet_OHOS>> fStyleSets;
     sk_sp<SkFontStyleSet> fDefaultStyleSet;
@@ -358,6 +417,10 @@ private:
     std::mutex mutexCache;
     SkTArray<const NameToFamily*, true> familyMapCache;
     SkTArray<const NameToFamily*, true> hwFontFamilyMapCache;
+    FallbackMemo fallbackMemo;
+    FallbackMemo hwFontFallbackMemo;
+    // Per-typeface character coverage, keyed by (typeface unique id, codepoint block).
+    std::unordered_map<uint64_t, Coverage> coverageCache;
     SkTArray<NameToFamily, true> fNameToFamilyMap;
     SkTArray<NameToFamily, true> fFallbackNameToFamilyMap;
     std::map<std::string, FamilyAliasObj> fAliasMap;
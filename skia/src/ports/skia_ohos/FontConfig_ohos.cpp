@@ -10,6 +10,10 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 #include "securec.h"
 
 #include "SkFontStyle.h"
@@ -18,19 +22,29 @@
 using namespace ErrorCode;
 
 static const char* OHOS_DEFAULT_CONFIG = "/system/etc/fontconfig.json";
+// the system configuration directory is read-only: the scan cache is kept in the app cache
+static const char* OHOS_DEFAULT_SCAN_CACHE_DIR = "/data/storage/el2/base/cache";
+static const char* SCAN_CACHE_SUFFIX = ".scancache";
+static const uint32_t SCAN_CACHE_MAGIC = SkSetFourByteTag('O', 'F', 'S', 'C');
+static const uint32_t SCAN_CACHE_VERSION = 1;
+// the minimum count of font files to be scanned by a thread
+static const size_t MIN_FONTS_PER_THREAD = 4;
 
 /*! Constructor
  * \param fontScanner the scanner to get the font information from a font file
  * \param fname the full name of system font configuration document.
  *     \n The default value is '/system/etc/fontconfig.json', if fname is given null
+ * \param cacheDir the writable directory to keep the font scan cache in
+ *     \n The default value is '/data/storage/el2/base/cache', if cacheDir is given null
  */
 FontConfig_OHOS::FontConfig_OHOS(const SkTypeface_FreeType::Scanner& fontScanner,
-    const char* fname)
+    const char* fname, const char* cacheDir)
 {
     int err = parseConfig(fname);
     if (err != NO_ERROR) {
         return;
     }
+    setScanCacheName(fname, cacheDir);
     scanFonts(fontScanner);
     resetGenericValue();
     resetFallbackValue();
@@ -948,35 +962,209 @@ TypefaceSet* FontConfig_OHOS::getTypefaceSet(const SkString& familyName,
     return nullptr;
 }
 
-/*! To load font information from a font file
+/*! To scan a font file
  * \param scanner a scanner used to parse the font file
- * \param fname the full name of a font file
+ * \param[in,out] info the scan information, whose 'fname' is the full name of the font file
+ * \n     'err' is set to ERROR_FONT_NOT_EXIST, if the font file is not exist
+ * \n     'err' is set to ERROR_FONT_INVALID_STREAM, if the stream is not recognized
+ * \note This function is thread safe, as long as each thread uses its own scanner
+ */
+void FontConfig_OHOS::scanFont(const SkTypeface_FreeType::Scanner& scanner, ScanInfo& info)
+{
+    std::unique_ptr<SkStreamAsset> stream = SkStream::MakeFromFile(info.fname.c_str());
+    info.count = 1;
+    info.axisDefs.reset();
+    if (stream == nullptr) {
+        info.err = ERROR_FONT_NOT_EXIST;
+    } else if (scanner.recognizedFont(stream.get(), &info.count) == false ||
+        scanner.scanFont(stream.get(), 0, &info.familyName, &info.style,
+            &info.isFixedWidth, &info.axisDefs) == false) {
+        info.err = ERROR_FONT_INVALID_STREAM;
+    } else {
+        info.err = NO_ERROR;
+    }
+}
+
+/*! To scan font files concurrently
+ * \param fontScanner the scanner used by the calling thread
+ * \param infoSet the scan information of the font files to be scanned
+ * \note The other threads use their own scanners, as a scanner serializes its usage
+ */
+void FontConfig_OHOS::scanFontsParallel(const SkTypeface_FreeType::Scanner& fontScanner,
+    const std::vector<ScanInfo*>& infoSet)
+{
+    std::atomic<size_t> next(0);
+    auto scanTask = [&infoSet, &next](const SkTypeface_FreeType::Scanner& scanner) {
+        for (size_t i = next++; i < infoSet.size(); i = next++) {
+            scanFont(scanner, *infoSet[i]);
+        }
+    };
+
+    size_t threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    threadCount = std::min(threadCount, infoSet.size() / MIN_FONTS_PER_THREAD);
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < threadCount; i++) {
+        threads.emplace_back([&scanTask]() {
+            SkTypeface_FreeType::Scanner scanner;
+            scanTask(scanner);
+        });
+    }
+    scanTask(fontScanner);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+/*! To set the full name of the scan cache, which is named after the configuration document
+ * \param fname the full name of the font configuration document, or null for the default one
+ * \param cacheDir the directory of the scan cache, or null for the default one
+ */
+void FontConfig_OHOS::setScanCacheName(const char* fname, const char* cacheDir)
+{
+    if (fname == nullptr) {
+        fname = OHOS_DEFAULT_CONFIG;
+    }
+    if (cacheDir == nullptr) {
+        cacheDir = OHOS_DEFAULT_SCAN_CACHE_DIR;
+    }
+    const char* baseName = strrchr(fname, '/');
+    baseName = (baseName == nullptr) ? fname : baseName + 1;
+    scanCacheName.printf("%s/%s%s", cacheDir, baseName, SCAN_CACHE_SUFFIX);
+}
+
+/*! To read the scan information from the scan cache
+ * \param fname the full name of the scan cache
+ * \param[out] cache the scan information keyed by the full name of font files
+ * \return true, if the scan cache exists and is valid
+ */
+bool FontConfig_OHOS::readScanCache(const char* fname, ScanCache& cache)
+{
+    std::unique_ptr<SkStreamAsset> stream = SkStream::MakeFromFile(fname);
+    if (stream == nullptr) {
+        return false;
+    }
+    auto readString = [&stream](SkString* str) {
+        uint32_t len = 0;
+        if (!stream->readU32(&len) || len > stream->getLength()) {
+            return false;
+        }
+        str->resize(len);
+        return stream->read(str->writable_str(), len) == len;
+    };
+    auto readS64 = [&stream](int64_t* value) {
+        return stream->read(value, sizeof(*value)) == sizeof(*value);
+    };
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint32_t count = 0;
+    if (!stream->readU32(&magic) || magic != SCAN_CACHE_MAGIC ||
+        !stream->readU32(&version) || version != SCAN_CACHE_VERSION ||
+        !stream->readU32(&count)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        ScanInfo info;
+        int32_t weight = 0;
+        int32_t width = 0;
+        int32_t slant = 0;
+        bool isFixedWidth = false;
+        uint32_t axisCount = 0;
+        if (!readString(&info.fname) || !readS64(&info.size) || !readS64(&info.mtime) ||
+            !stream->readS32(&info.err) || !stream->readS32(&info.count) ||
+            !readString(&info.familyName) || !stream->readS32(&weight) ||
+            !stream->readS32(&width) || !stream->readS32(&slant) ||
+            !stream->readBool(&isFixedWidth) || !stream->readU32(&axisCount) ||
+            slant < SkFontStyle::kUpright_Slant || slant > SkFontStyle::kOblique_Slant ||
+            axisCount > stream->getLength()) {
+            return false;
+        }
+        info.style = SkFontStyle(weight, width, (SkFontStyle::Slant) slant);
+        info.isFixedWidth = isFixedWidth;
+        for (uint32_t j = 0; j < axisCount; j++) {
+            SkTypeface_FreeType::Scanner::AxisDefinition& axis = info.axisDefs.push_back();
+            if (!stream->readU32(&axis.fTag) || !stream->readS32(&axis.fMinimum) ||
+                !stream->readS32(&axis.fDefault) || !stream->readS32(&axis.fMaximum)) {
+                return false;
+            }
+        }
+        SkString key(info.fname);
+        cache.set(std::move(key), std::move(info));
+    }
+    return true;
+}
+
+/*! To write the scan information to the scan cache
+ * \param fname the full name of the scan cache
+ * \param infoSet the scan information of font files
+ * \return true, if the scan cache is written successfully
+ * \note The cache is written to a temporary file first, and then renamed,
+ * \n    so that concurrent readers never see a partial cache
+ */
+bool FontConfig_OHOS::writeScanCache(const char* fname, const std::vector<ScanInfo>& infoSet)
+{
+    SkString tmpName;
+    tmpName.printf("%s.%d", fname, getpid());
+    bool ret = true;
+    {
+        SkFILEWStream stream(tmpName.c_str());
+        if (!stream.isValid()) {
+            return false;
+        }
+        auto writeString = [&stream](const SkString& str) {
+            return stream.write32(str.size()) && stream.write(str.c_str(), str.size());
+        };
+        // missing font files are recorded too, so that the cache matches the directory listing
+        ret = stream.write32(SCAN_CACHE_MAGIC) && stream.write32(SCAN_CACHE_VERSION) &&
+            stream.write32(infoSet.size());
+        for (const ScanInfo& info : infoSet) {
+            if (!ret) {
+                break;
+            }
+            ret = writeString(info.fname) &&
+                stream.write(&info.size, sizeof(info.size)) &&
+                stream.write(&info.mtime, sizeof(info.mtime)) &&
+                stream.write32(info.err) && stream.write32(info.count) &&
+                writeString(info.familyName) &&
+                stream.write32(info.style.weight()) && stream.write32(info.style.width()) &&
+                stream.write32(info.style.slant()) && stream.writeBool(info.isFixedWidth) &&
+                stream.write32(info.axisDefs.count());
+            for (int j = 0; ret && j < info.axisDefs.count(); j++) {
+                const SkTypeface_FreeType::Scanner::AxisDefinition& axis = info.axisDefs[j];
+                ret = stream.write32(axis.fTag) && stream.write32(axis.fMinimum) &&
+                    stream.write32(axis.fDefault) && stream.write32(axis.fMaximum);
+            }
+        }
+    }
+    if (!ret || rename(tmpName.c_str(), fname) != 0) {
+        unlink(tmpName.c_str());
+        return false;
+    }
+    return true;
+}
+
+/*! To load font information from the scan information of a font file
+ * \param info the scan information of a font file
  * \return NO_ERROR successful
  * \return ERROR_FONT_NOT_EXIST font file is not exist
  * \return ERROR_FONT_INVALID_STREAM the stream is not recognized
  */
-int FontConfig_OHOS::loadFont(const SkTypeface_FreeType::Scanner& scanner, const char* fname)
+int FontConfig_OHOS::loadFont(const ScanInfo& info)
 {
-    std::unique_ptr<SkStreamAsset> stream = SkStream::MakeFromFile(fname);
-    int count = 1;
-    SkTypeface_FreeType::Scanner::AxisDefinitions axisDefs;
-    FontInfo font(fname, 0);
-    if (stream == nullptr ||
-        scanner.recognizedFont(stream.get(), &count) == false ||
-        scanner.scanFont(stream.get(), 0, &font.familyName, &font.style,
-            &font.isFixedWidth, &axisDefs) == false) {
-        int err = NO_ERROR;
-        if (stream == nullptr) {
-            err = ERROR_FONT_NOT_EXIST;
-        } else {
-            err = ERROR_FONT_INVALID_STREAM;
-        }
-        LOGE("%s : %s\n", errToString(err), fname);
+    const char* fname = info.fname.c_str();
+    if (info.err != NO_ERROR) {
+        LOGE("%s : %s\n", errToString(info.err), fname);
         char* fnameCopy = strdup(fname);
-        errSet.emplace_back(err, basename(fnameCopy));
+        errSet.emplace_back(info.err, basename(fnameCopy));
         free(fnameCopy);
-        return err;
+        return info.err;
     }
+    int count = info.count;
+    const AxisDefinitions& axisDefs = info.axisDefs;
+    FontInfo font(fname, 0);
+    font.familyName = info.familyName;
+    font.style = info.style;
+    font.isFixedWidth = info.isFixedWidth;
     // for adjustMap - update weight
     if (adjustMap.find(font.familyName) != nullptr) {
         const std::vector<AdjustInfo> adjustSet = *(adjustMap.find(font.familyName));
@@ -1005,6 +1193,10 @@ int FontConfig_OHOS::loadFont(const SkTypeface_FreeType::Scanner& scanner, const
 }
 
 /*! To scan the system font directories
+ * \n 1. To collect the font files, with their sizes and modification times
+ * \n 2. To reuse the scan information from the scan cache for unchanged font files
+ * \n 3. To scan the new or changed font files concurrently, and update the scan cache
+ * \n 4. To load the font information in the directory order
  * \param fontScanner the scanner used to parse a font file
  * \return NO_ERROR success
  * \return ERROR_DIR_NOT_FOUND a font directory is not exist
@@ -1015,6 +1207,7 @@ int FontConfig_OHOS::scanFonts(const SkTypeface_FreeType::Scanner& fontScanner)
     if (fontDirSet.size() == 0) {
         fontDirSet.emplace_back(SkString("/system/fonts/"));
     }
+    std::vector<ScanInfo> infoSet;
     for (unsigned int i = 0; i < fontDirSet.size(); i++) {
         DIR* dir = opendir(fontDirSet[i].c_str());
         if (dir == nullptr) {
@@ -1035,19 +1228,43 @@ int FontConfig_OHOS::scanFonts(const SkTypeface_FreeType::Scanner& fontScanner)
                 strncmp(fname + len - suffixLen, ".otc", suffixLen))) {
                 continue;
             }
-            len += (fontDirSet[i].size() + 2); // 2 more characters for '/' and '\0'
-            char fullname[len];
-            memset_s(fullname, len,  0, len);
-            strcpy_s(fullname, len, fontDirSet[i].c_str());
+            ScanInfo info;
+            info.fname = fontDirSet[i];
             if (fontDirSet[i][fontDirSet[i].size() - 1] != '/') {
-                strcat_s(fullname, len, "/");
+                info.fname.append("/");
             }
-            strcat_s(fullname, len, fname);
-            loadFont(fontScanner, fullname);
+            info.fname.append(fname);
+            struct stat st;
+            if (stat(info.fname.c_str(), &st) == 0) {
+                info.size = st.st_size;
+                info.mtime = st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+            }
+            infoSet.emplace_back(std::move(info));
         }
         closedir(dir);
     }
     fontDirSet.clear();
+
+    ScanCache cache;
+    bool cacheValid = readScanCache(scanCacheName.c_str(), cache);
+    std::vector<ScanInfo*> pendingSet;
+    for (ScanInfo& info : infoSet) {
+        const ScanInfo* cached = cache.find(info.fname);
+        if (cached && cached->size == info.size && cached->mtime == info.mtime) {
+            info = *cached;
+        } else {
+            pendingSet.push_back(&info);
+        }
+    }
+    scanFontsParallel(fontScanner, pendingSet);
+    // Rewrite the cache only if some font files are added, changed or removed.
+    if (!cacheValid || pendingSet.size() > 0 || cache.count() != (int)infoSet.size()) {
+        writeScanCache(scanCacheName.c_str(), infoSet);
+    }
+
+    for (const ScanInfo& info : infoSet) {
+        loadFont(info);
+    }
     return err;
 }
 
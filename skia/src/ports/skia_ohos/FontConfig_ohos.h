@@ -6,6 +6,7 @@
 #define FONTCONFIG_OHOS_H
 
 #include <json/json.h>
+#include <cstdint>
 #include <vector>
 
 #include "SkFontDescriptor.h"
@@ -99,7 +100,7 @@ struct FallbackInfo : GenericFamily {
 class FontConfig_OHOS {
 public:
     explicit FontConfig_OHOS(const SkTypeface_FreeType::Scanner& fontScanner,
-        const char* fname = nullptr);
+        const char* fname = nullptr, const char* cacheDir = nullptr);
     virtual ~FontConfig_OHOS() = default;
     const FallbackForMap& getFallbackForMap() const;
     const FallbackSet& getFallbackSet() const;
@@ -129,10 +130,12 @@ private:
     struct AdjustInfo;
     struct VariationInfo;
     struct TtcIndexInfo;
+    struct ScanInfo;
     using AliasMap = SkTHashMap<SkString, std::vector<AliasInfo>>;
     using AjdustMap = SkTHashMap<SkString, std::vector<AdjustInfo>>;
     using VariationMap = SkTHashMap<SkString, std::vector<VariationInfo>>;
     using TtcIndexMap = SkTHashMap<SkString, TtcIndexInfo>;
+    using ScanCache = SkTHashMap<SkString, ScanInfo>;
 
     /*!
      * \brief To manage the adjust information
@@ -169,6 +172,22 @@ private:
         int ttcIndex; // the index of a typeface in a ttc font
     };
 
+    /*!
+     * \brief To manage the scan result of a font file, which is persisted in the scan cache
+     * \n     and reused as long as the size and the modification time of the file are unchanged
+     */
+    struct ScanInfo {
+        SkString fname; // the full name of the font file
+        int64_t size = 0; // the size of the font file
+        int64_t mtime = 0; // the modification time of the font file, in nanoseconds
+        int err = ErrorCode::NO_ERROR; // the error happened when scanning the font file
+        int count = 1; // the count of typefaces in the font file
+        SkString familyName; // the family name of the first typeface in the font file
+        SkFontStyle style; // the font style of the first typeface in the font file
+        bool isFixedWidth = false; // the flag to indicate if the font has fixed width or not
+        AxisDefinitions axisDefs; // the axis ranges of a variable font
+    };
+
     /*!
      * \brief To manage the information of errors happened
      */
@@ -193,6 +212,7 @@ private:
     AjdustMap adjustMap; // to save adjust information temporarily
     VariationMap variationMap; // to save variation information temporarily
     TtcIndexMap ttcIndexMap; // to save 'index' information temporarily
+    SkString scanCacheName; // the full name of the font scan cache, in a writable directory
 
     int parseConfig(const char* fname);
     int checkConfigFile(const char* fname, Json::Value& root);
@@ -210,8 +230,14 @@ private:
     bool insertVariableFont(const AxisDefinitions& axisDefinitions, FontInfo& font);
     TypefaceSet* getTypefaceSet(const SkString& familyName, SkString& specifiedName) const;
 
-    int loadFont(const SkTypeface_FreeType::Scanner& scanner, const char* fname);
+    int loadFont(const ScanInfo& info);
     int scanFonts(const SkTypeface_FreeType::Scanner& fontScanner);
+    static void scanFont(const SkTypeface_FreeType::Scanner& scanner, ScanInfo& info);
+    static void scanFontsParallel(const SkTypeface_FreeType::Scanner& fontScanner,
+        const std::vector<ScanInfo*>& infoSet);
+    void setScanCacheName(const char* fname, const char* cacheDir);
+    static bool readScanCache(const char* fname, ScanCache& cache);
+    static bool writeScanCache(const char* fname, const std::vector<ScanInfo>& infoSet);
     void resetGenericValue();
     void buildSubTypefaceSet(const std::shared_ptr<TypefaceSet>& typefaceSet,
         std::shared_ptr<TypefaceSet>& subSet, const SkString& familyName, int weight);
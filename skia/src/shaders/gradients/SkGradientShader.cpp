@@ -12,6 +12,7 @@
 #include "src/core/SkColorSpacePriv.h"
 #include "src/core/SkConvertPixels.h"
 #include "src/core/SkReadBuffer.h"
+#include "src/core/SkResourceCache.h"
 #include "src/core/SkWriteBuffer.h"
 #include "src/shaders/gradients/Sk4fLinearGradient.h"
 #include "src/shaders/gradients/SkGradientShaderPriv.h"
@@ -270,6 +271,171 @@ static void init_stop_pos(
     add_stop_color(ctx, stop, Fs, Bs);
 }
 
+// Gradients with arbitrarily placed stops search for the interval of every pixel, which gets
+// costly with many stops. When the destination has no more than 8 bits per channel, we can
+// instead look up a table of premultiplied colors sampled evenly from the gradient, as long as
+// the table is fine enough that taking the nearest entry stays within half an 8-bit step of the
+// exact color. Tables are shared through SkResourceCache, so that gradients recreated with the
+// same stops (as a UI toolkit does every frame) also share one.
+
+static bool lut_covers_color_type(SkColorType ct) {
+    switch (ct) {
+        case kAlpha_8_SkColorType:
+        case kRGB_565_SkColorType:
+        case kARGB_4444_SkColorType:
+        case kRGBA_8888_SkColorType:
+        case kRGB_888x_SkColorType:
+        case kBGRA_8888_SkColorType:
+        case kGray_8_SkColorType:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Returns the number of table entries needed for colors interpolated between these stops, or 0
+// if the gradient is too steep for a table, e.g. because it has hard stops.
+static int lut_entry_count(const SkPMColor4f colors[], const SkScalar pos[], int count,
+                           bool premulGrad) {
+    float maxSlope = 0;
+    for (int i = 0; i < count - 1; i++) {
+        Sk4f delta = (Sk4f::Load(colors[i + 1].vec()) - Sk4f::Load(colors[i].vec())).abs();
+        float change = delta.max();
+        if (!premulGrad) {
+            // Premultiplying afterwards moves each color channel by up to the change in alpha too.
+            change = std::max(delta[0], std::max(delta[1], delta[2])) + delta[3];
+        }
+        if (change == 0) {
+            continue;
+        }
+        float dt = pos[i + 1] - pos[i];
+        if (dt <= 0) {
+            return 0;
+        }
+        maxSlope = std::max(maxSlope, change / dt);
+    }
+
+    // Neighboring entries are maxSlope / (entries - 1) apart, and the nearest one at most half
+    // of that away from the exact color.
+    for (int entries : {256, 1024}) {
+        if (maxSlope * 255 <= entries - 1) {
+            return entries;
+        }
+    }
+    return 0;
+}
+
+namespace {
+static unsigned gGradientLUTKeyNamespaceLabel;
+
+// Followed by the colors and then the positions of the stops.
+struct GradientLUTKey : public SkResourceCache::Key {
+public:
+    static std::unique_ptr<GradientLUTKey> Make(const SkPMColor4f colors[], const SkScalar pos[],
+                                                int count, bool premulGrad, int entries) {
+        size_t contentSize = count * (sizeof(SkPMColor4f) + sizeof(SkScalar));
+        void* storage = ::operator new(std::max(sizeof(GradientLUTKey),
+                                                kContentOffset + contentSize));
+        return std::unique_ptr<GradientLUTKey>(
+                new (storage) GradientLUTKey(colors, pos, count, premulGrad, entries));
+    }
+
+    void operator delete(void* storage) { ::operator delete(storage); }
+
+private:
+    GradientLUTKey(const SkPMColor4f colors[], const SkScalar pos[], int count, bool premulGrad,
+                   int entries)
+        : fEntries(entries)
+        , fPremul(premulGrad)
+        , fCount(count) {
+        // This better be packed.
+        SkASSERT(reinterpret_cast<char*>(&fCount + 1) ==
+                 SkTAddOffset<char>(this, kContentOffset));
+
+        char* content = SkTAddOffset<char>(this, kContentOffset);
+        memcpy(content, colors, count * sizeof(SkPMColor4f));
+        memcpy(content + count * sizeof(SkPMColor4f), pos, count * sizeof(SkScalar));
+        this->init(&gGradientLUTKeyNamespaceLabel, 0,
+                   kKeySize + count * (sizeof(SkPMColor4f) + sizeof(SkScalar)));
+    }
+
+    int32_t  fEntries;
+    uint32_t fPremul;
+    int32_t  fCount;
+
+    static constexpr size_t kKeySize = 3 * sizeof(uint32_t);
+    static constexpr size_t kContentOffset = sizeof(SkResourceCache::Key) + kKeySize;
+};
+
+struct GradientLUTRec : public SkResourceCache::Rec {
+    GradientLUTRec(std::unique_ptr<GradientLUTKey> key, sk_sp<SkData> lut)
+        : fKey(std::move(key))
+        , fLUT(std::move(lut)) {}
+
+    std::unique_ptr<GradientLUTKey> fKey;
+    sk_sp<SkData>                   fLUT;
+
+    const Key& getKey() const override { return *fKey; }
+    size_t bytesUsed() const override { return fKey->size() + fLUT->size(); }
+    const char* getCategory() const override { return "gradient-lut"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override { return nullptr; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextLUT) {
+        const GradientLUTRec& rec = static_cast<const GradientLUTRec&>(baseRec);
+        *reinterpret_cast<sk_sp<SkData>*>(contextLUT) = rec.fLUT;
+        return true;
+    }
+};
+
+} // namespace
+
+static sk_sp<SkData> make_lut(const SkPMColor4f colors[], const SkScalar pos[], int count,
+                              bool premulGrad, int entries) {
+    sk_sp<SkData> data = SkData::MakeUninitialized(entries * sizeof(uint32_t));
+    uint32_t* lut = static_cast<uint32_t*>(data->writable_data());
+
+    int stop = 0;
+    for (int i = 0; i < entries; i++) {
+        const float t = i / (entries - 1.0f);
+        while (stop < count - 2 && t > pos[stop + 1]) {
+            stop++;
+        }
+
+        const float dt = pos[stop + 1] - pos[stop];
+        const float w = dt > 0 ? SkTPin((t - pos[stop]) / dt, 0.0f, 1.0f) : 1.0f;
+        Sk4f c = Sk4f::Load(colors[stop    ].vec()) * (1 - w)
+               + Sk4f::Load(colors[stop + 1].vec()) * w;
+        c = Sk4f::Max(0, Sk4f::Min(c, 1));
+        if (premulGrad) {
+            c = Sk4f::Min(c, Sk4f(c[3], c[3], c[3], 1));
+        } else {
+            c = c * Sk4f(c[3], c[3], c[3], 1);
+        }
+        lut[i] = Sk4f_toL32(c);
+    }
+    return data;
+}
+
+static const uint32_t* find_or_make_lut(const SkPMColor4f colors[], const SkScalar pos[],
+                                        int count, bool premulGrad, SkArenaAlloc* alloc,
+                                        float* scale) {
+    const int entries = lut_entry_count(colors, pos, count, premulGrad);
+    if (!entries) {
+        return nullptr;
+    }
+
+    auto key = GradientLUTKey::Make(colors, pos, count, premulGrad, entries);
+    sk_sp<SkData> lut;
+    if (!SkResourceCache::Find(*key, GradientLUTRec::Visitor, &lut)) {
+        lut = make_lut(colors, pos, count, premulGrad, entries);
+        SkResourceCache::Add(new GradientLUTRec(std::move(key), lut));
+    }
+
+    *scale = entries - 1;
+    // The cache may purge its copy while we draw.
+    return static_cast<const uint32_t*>(alloc->make<sk_sp<SkData>>(std::move(lut))->get()->data());
+}
+
 bool SkGradientShaderBase::onAppendStages(const SkStageRec& rec) const {
     SkRasterPipeline* p = rec.fPipeline;
     SkArenaAlloc* alloc = rec.fAlloc;
@@ -318,8 +484,29 @@ bool SkGradientShaderBase::onAppendStages(const SkStageRec& rec) const {
                           : SkPMColor4f{ c.fR, c.fG, c.fB, c.fA };
     };
 
-    // The two-stop case with stops at 0 and 1.
-    if (fColorCount == 2 && fOrigPos == nullptr) {
+    bool colorsArePremul = premulGrad;
+
+    const SkRasterPipeline_GradientLUTCtx* lutCtx = nullptr;
+    if (fOrigPos && fColorCount > 2 && lut_covers_color_type(rec.fDstColorType) &&
+        !rec.fPaint.isDither()) {
+        SkAutoSTArray<16, SkPMColor4f> colors(fColorCount);
+        for (int i = 0; i < fColorCount; i++) {
+            colors[i] = prepareColor(i);
+        }
+
+        float scale;
+        if (auto lut = find_or_make_lut(colors.get(), fOrigPos, fColorCount, premulGrad, alloc,
+                                        &scale)) {
+            lutCtx = alloc->make<SkRasterPipeline_GradientLUTCtx>(
+                    SkRasterPipeline_GradientLUTCtx{lut, scale});
+        }
+    }
+
+    if (lutCtx) {
+        p->append(SkRasterPipeline::gradient_lut, lutCtx);
+        colorsArePremul = true;
+    } else if (fColorCount == 2 && fOrigPos == nullptr) {
+        // The two-stop case with stops at 0 and 1.
         const SkPMColor4f c_l = prepareColor(0),
                           c_r = prepareColor(1);
 
@@ -405,7 +592,7 @@ bool SkGradientShaderBase::onAppendStages(const SkStageRec& rec) const {
         p->append(SkRasterPipeline::check_decal_mask, decal_ctx);
     }
 
-    if (!premulGrad && !this->colorsAreOpaque()) {
+    if (!colorsArePremul && !this->colorsAreOpaque()) {
         p->append(SkRasterPipeline::premul);
     }
 
@@ -13,7 +13,9 @@
 #include "include/utils/SkParse.h"
 #include "src/utils/SkUTF.h"
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
 #include <tuple>
 #include <vector>
 
@@ -891,6 +893,212 @@ void Write(const Value& v, SkWStream* stream) {
     }
 }
 
+// Binary DOM format (little-endian, unaligned):
+//
+//   header: [magic "skjb"] [u32 version] [u32 arena size hint]
+//   value:  [u8 type] [payload]
+//
+//     kNull, kTrue, kFalse : no payload
+//     kInt                 : i32
+//     kFloat               : f32
+//     kString              : [u32 len] [len bytes]
+//     kArray               : [u32 count] [count values]
+//     kObject              : [u32 count] [count x (string value, value)]
+//
+static constexpr uint32_t kBinaryMagic   = SkSetFourByteTag('s', 'k', 'j', 'b');
+static constexpr uint32_t kBinaryVersion = 1;
+static constexpr size_t   kBinaryHeaderSize = 3 * sizeof(uint32_t);
+
+// Bound the recursion depth for untrusted input.
+static constexpr int kMaxBinaryDepth = 512;
+
+enum class BinaryType : uint8_t {
+    kNull,
+    kTrue,
+    kFalse,
+    kInt,
+    kFloat,
+    kString,
+    kArray,
+    kObject,
+};
+
+// Arena footprint of a vector rec, assuming 64-bit size_t (upper bound for 32-bit).
+static size_t vector_alloc_size(size_t payload_size) {
+    return SkAlign8(sizeof(uint64_t) + payload_size);
+}
+
+static size_t WriteBinary(const Value& v, SkWStream* stream) {
+    const auto write_type = [stream](BinaryType t) { stream->write8(SkTo<uint8_t>(t)); };
+
+    switch (v.getType()) {
+    case Value::Type::kNull:
+        write_type(BinaryType::kNull);
+        return 0;
+    case Value::Type::kBool:
+        write_type(*v.as<BoolValue>() ? BinaryType::kTrue : BinaryType::kFalse);
+        return 0;
+    case Value::Type::kNumber: {
+        const auto d = *v.as<NumberValue>();
+        if (d >= std::numeric_limits<int32_t>::min() &&
+            d <= std::numeric_limits<int32_t>::max() &&
+            d == std::floor(d)) {
+            const auto i = static_cast<int32_t>(d);
+            write_type(BinaryType::kInt);
+            stream->write(&i, sizeof(i));
+        } else {
+            const auto f = static_cast<float>(d);
+            write_type(BinaryType::kFloat);
+            stream->write(&f, sizeof(f));
+        }
+        return 0;
+    }
+    case Value::Type::kString: {
+        const auto& str = v.as<StringValue>();
+        const auto len = SkToU32(str.size());
+        write_type(BinaryType::kString);
+        stream->write32(len);
+        stream->write(str.begin(), len);
+        // Short strings are stored inline (see FastString).
+        return len < sizeof(Value) ? 0 : vector_alloc_size(len + 1);
+    }
+    case Value::Type::kArray: {
+        const auto& array = v.as<ArrayValue>();
+        write_type(BinaryType::kArray);
+        stream->write32(SkToU32(array.size()));
+
+        size_t alloc_size = vector_alloc_size(array.size() * sizeof(Value));
+        for (const auto& item : array) {
+            alloc_size += WriteBinary(item, stream);
+        }
+        return alloc_size;
+    }
+    case Value::Type::kObject:
+        const auto& object = v.as<ObjectValue>();
+        write_type(BinaryType::kObject);
+        stream->write32(SkToU32(object.size()));
+
+        size_t alloc_size = vector_alloc_size(object.size() * sizeof(Member));
+        for (const auto& member : object) {
+            alloc_size += WriteBinary(member.fKey  , stream);
+            alloc_size += WriteBinary(member.fValue, stream);
+        }
+        return alloc_size;
+    }
+
+    SkASSERT(false); // unreachable
+    return 0;
+}
+
+class BinaryDOMReader {
+public:
+    BinaryDOMReader(const void* data, size_t size, SkArenaAlloc& alloc)
+        : fCurrent(static_cast<const uint8_t*>(data))
+        , fStop(fCurrent + size)
+        , fAlloc(alloc) {}
+
+    bool read(Value* v) { return this->readValue(v, 0) && fCurrent == fStop; }
+
+private:
+    template <typename T>
+    bool readPOD(T* t) {
+        if (SkToSizeT(fStop - fCurrent) < sizeof(T)) {
+            return false;
+        }
+        memcpy(t, fCurrent, sizeof(T));
+        fCurrent += sizeof(T);
+        return true;
+    }
+
+    // Counts are validated against the remaining input (each entry takes at least one byte),
+    // to avoid large bogus allocations.
+    bool readCount(uint32_t* count, size_t min_entry_size) {
+        return this->readPOD(count) &&
+               *count <= SkToSizeT(fStop - fCurrent) / min_entry_size;
+    }
+
+    bool readValue(Value* v, int depth) {
+        uint8_t type;
+        if (!this->readPOD(&type) || depth > kMaxBinaryDepth) {
+            return false;
+        }
+
+        switch (static_cast<BinaryType>(type)) {
+        case BinaryType::kNull:
+            *v = NullValue();
+            return true;
+        case BinaryType::kTrue:
+        case BinaryType::kFalse:
+            *v = BoolValue(static_cast<BinaryType>(type) == BinaryType::kTrue);
+            return true;
+        case BinaryType::kInt: {
+            int32_t i;
+            if (!this->readPOD(&i)) return false;
+            *v = NumberValue(i);
+            return true;
+        }
+        case BinaryType::kFloat: {
+            float f;
+            if (!this->readPOD(&f)) return false;
+            *v = NumberValue(f);
+            return true;
+        }
+        case BinaryType::kString: {
+            uint32_t len;
+            if (!this->readCount(&len, 1)) return false;
+            *v = StringValue(reinterpret_cast<const char*>(fCurrent), len, fAlloc);
+            fCurrent += len;
+            return true;
+        }
+        case BinaryType::kArray: {
+            uint32_t count;
+            if (!this->readCount(&count, 1)) return false;
+
+            const auto base = fValueStack.size();
+            if (!this->readScope(count, depth)) return false;
+
+            *v = ArrayValue(fValueStack.data() + base, count, fAlloc);
+            fValueStack.resize(base);
+            return true;
+        }
+        case BinaryType::kObject: {
+            uint32_t count;
+            if (!this->readCount(&count, 2)) return false;
+
+            // Members are stored as (key, value) pairs on the value stack, like DOMParser does.
+            static_assert(sizeof(Member) == 2 * sizeof(Value), "");
+            const auto base = fValueStack.size();
+            if (!this->readScope(2 * count, depth)) return false;
+
+            for (size_t i = 0; i < count; ++i) {
+                if (!fValueStack[base + 2 * i].is<StringValue>()) return false;
+            }
+
+            *v = ObjectValue(reinterpret_cast<const Member*>(fValueStack.data() + base),
+                             count, fAlloc);
+            fValueStack.resize(base);
+            return true;
+        }
+        }
+
+        return false;
+    }
+
+    bool readScope(size_t count, int depth) {
+        for (size_t i = 0; i < count; ++i) {
+            Value item;
+            if (!this->readValue(&item, depth + 1)) return false;
+            fValueStack.push_back(item);
+        }
+        return true;
+    }
+
+    const uint8_t*      fCurrent;
+    const uint8_t*      fStop;
+    SkArenaAlloc&       fAlloc;
+    std::vector<Value>  fValueStack;
+};
+
 } // namespace
 
 SkString Value::toString() const {
@@ -914,4 +1122,54 @@ void DOM::write(SkWStream* stream) const {
     Write(fRoot, stream);
 }
 
+DOM::DOM(size_t alloc_reserve)
+    : fAlloc(std::max(alloc_reserve, kMinChunkSize))
+    , fRoot(NullValue()) {}
+
+void DOM::writeBinary(SkWStream* stream) const {
+    // The arena size hint is only known after serializing the tree.
+    SkDynamicMemoryWStream payload;
+    const auto alloc_size = WriteBinary(fRoot, &payload);
+
+    stream->write32(kBinaryMagic);
+    stream->write32(kBinaryVersion);
+    stream->write32(SkToU32(std::min<size_t>(alloc_size, std::numeric_limits<uint32_t>::max())));
+    payload.writeToStream(stream);
+}
+
+bool DOM::IsBinary(const void* data, size_t size) {
+    uint32_t magic;
+    if (size < kBinaryHeaderSize) {
+        return false;
+    }
+    memcpy(&magic, data, sizeof(magic));
+
+    return magic == kBinaryMagic;
+}
+
+std::unique_ptr<DOM> DOM::MakeFromBinary(const void* data, size_t size) {
+    if (!IsBinary(data, size)) {
+        return nullptr;
+    }
+
+    uint32_t header[3];
+    memcpy(header, data, sizeof(header));
+    if (header[1] != kBinaryVersion) {
+        return nullptr;
+    }
+
+    // Allocate a single arena block upfront, sized for the whole tree.  The hint is untrusted:
+    // a value tree cannot legitimately need more than ~8 arena bytes per input byte.
+    const auto alloc_reserve = std::min<size_t>(header[2], size * 8);
+    std::unique_ptr<DOM> dom(new DOM(alloc_reserve));
+
+    BinaryDOMReader reader(static_cast<const uint8_t*>(data) + kBinaryHeaderSize,
+                           size - kBinaryHeaderSize, dom->fAlloc);
+    if (!reader.read(&dom->fRoot)) {
+        return nullptr;
+    }
+
+    return dom;
+}
+
 } // namespace skjson
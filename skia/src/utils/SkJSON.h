@@ -14,6 +14,7 @@
 #include "src/core/SkArenaAlloc.h"
 
 #include <cstring>
+#include <memory>
 
 class SkString;
 class SkWStream;
@@ -334,7 +335,25 @@ public:
 
     void write(SkWStream*) const;
 
+    /**
+     * Binary DOM serialization.
+     *
+     * The binary form is a compact, pre-order encoding of the value tree (with a pre-computed
+     * arena size), which can be loaded without any text tokenization or number parsing.
+     * It is position independent, so it can be loaded straight out of a mmap-ed file.
+     */
+    void writeBinary(SkWStream*) const;
+
+    static bool IsBinary(const void* data, size_t size);
+
+    /**
+     * @return    A DOM loaded from writeBinary() output, or nullptr for malformed input.
+     */
+    static std::unique_ptr<DOM> MakeFromBinary(const void* data, size_t size);
+
 private:
+    explicit DOM(size_t alloc_reserve);
+
     SkArenaAlloc fAlloc;
     Value        fRoot;
 };
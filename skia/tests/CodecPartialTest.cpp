@@ -136,9 +136,6 @@ static void test_partial(skiatest::Reporter* r, const char* name, size_t minByte
 }
 
 DEF_TEST(Codec_partial, r) {
-#if 0
-    // FIXME (scroggo): SkPngCodec needs to use SkStreamBuffer in order to
-    // support incremental decoding.
     test_partial(r, "images/plane.png");
     test_partial(r, "images/plane_interlaced.png");
     test_partial(r, "images/yellow_rose.png");
@@ -149,10 +146,14 @@ DEF_TEST(Codec_partial, r) {
     test_partial(r, "images/arrow.png");
     test_partial(r, "images/randPixels.png");
     test_partial(r, "images/baby_tux.png");
-#endif
     test_partial(r, "images/box.gif");
     test_partial(r, "images/randPixels.gif", 215);
     test_partial(r, "images/color_wheel.gif");
+    test_partial(r, "images/baby_tux.webp");
+    test_partial(r, "images/yellow_rose.webp");
+    test_partial(r, "images/mandrill_512_q075.jpg");
+    test_partial(r, "images/CMYK.jpg");
+    test_partial(r, "images/grayscale.jpg");
 }
 
 DEF_TEST(Codec_partialWuffs, r) {
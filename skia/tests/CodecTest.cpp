@@ -13,6 +13,7 @@
 #include "include/core/SkColorSpace.h"
 #include "include/core/SkData.h"
 #include "include/core/SkEncodedImageFormat.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageEncoder.h"
 #include "include/core/SkImageGenerator.h"
@@ -35,6 +36,7 @@
 #include "include/utils/SkFrontBufferedStream.h"
 #include "include/utils/SkRandom.h"
 #include "src/codec/SkCodecImageGenerator.h"
+#include "src/codec/SkCodecPriv.h"
 #include "src/core/SkAutoMalloc.h"
 #include "src/core/SkColorSpacePriv.h"
 #include "src/core/SkMD5.h"
@@ -475,9 +477,9 @@ DEF_TEST(Codec_wbmp, r) {
 }
 
 DEF_TEST(Codec_webp, r) {
-    check(r, "images/baby_tux.webp", SkISize::Make(386, 395), false, true, true);
-    check(r, "images/color_wheel.webp", SkISize::Make(128, 128), false, true, true);
-    check(r, "images/yellow_rose.webp", SkISize::Make(400, 301), false, true, true);
+    check(r, "images/baby_tux.webp", SkISize::Make(386, 395), false, true, true, true);
+    check(r, "images/color_wheel.webp", SkISize::Make(128, 128), false, true, true, true);
+    check(r, "images/yellow_rose.webp", SkISize::Make(400, 301), false, true, true, true);
 }
 
 DEF_TEST(Codec_bmp, r) {
@@ -681,11 +683,6 @@ DEF_TEST(Codec_Empty, r) {
     test_invalid(r, "invalid_images/ossfuzz6347");
 }
 
-#ifdef PNG_READ_UNKNOWN_CHUNKS_SUPPORTED
-
-#ifndef SK_PNG_DISABLE_TESTS   // reading chunks does not work properly with older versions.
-                               // It does not appear that anyone in Google3 is reading chunks.
-
 static void codex_test_write_fn(png_structp png_ptr, png_bytep data, png_size_t len) {
     SkWStream* sk_stream = (SkWStream*)png_get_io_ptr(png_ptr);
     if (!sk_stream->write(data, len)) {
@@ -693,6 +690,11 @@ static void codex_test_write_fn(png_structp png_ptr, png_bytep data, png_size_t
     }
 }
 
+#ifdef PNG_READ_UNKNOWN_CHUNKS_SUPPORTED
+
+#ifndef SK_PNG_DISABLE_TESTS   // reading chunks does not work properly with older versions.
+                               // It does not appear that anyone in Google3 is reading chunks.
+
 DEF_TEST(Codec_pngChunkReader, r) {
     // Create a dummy bitmap. Use unpremul RGBA for libpng.
     SkBitmap bm;
@@ -908,6 +910,34 @@ DEF_TEST(Codec_webp_peek, r) {
     test_info(r, codec.get(), codec->getInfo(), SkCodec::kSuccess, nullptr);
 }
 
+// Decoder threads let libwebp decode lossy images with a worker thread.  That should not
+// change the result.
+DEF_TEST(Codec_webp_threads, r) {
+    constexpr char path[] = "images/yellow_rose.webp";
+    auto data = GetResourceAsData(path);
+    if (!data) {
+        SkDebugf("Missing resource '%s'\n", path);
+        return;
+    }
+
+    auto codec = SkCodec::MakeFromData(data);
+    if (!codec) {
+        ERRORF(r, "Failed to create codec for %s", path);
+        return;
+    }
+    const SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType);
+    SkBitmap serial, threaded;
+    serial.allocPixels(info);
+    threaded.allocPixels(info);
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(serial.pixmap()));
+
+    SkCodec::Options options;
+    options.fUseDecoderThreads = true;
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(info, threaded.getPixels(),
+                                                             threaded.rowBytes(), &options));
+    REPORTER_ASSERT(r, ToolUtils::equal_pixels(serial, threaded));
+}
+
 // SkCodec's wbmp decoder was initially unnecessarily restrictive.
 // It required the second byte to be zero. The wbmp specification allows
 // a couple of bits to be 1 (so long as they do not overlap with 0x9F).
@@ -1180,8 +1210,8 @@ static void test_conversion_possible(skiatest::Reporter* r, const char* path,
 }
 
 DEF_TEST(Codec_F16ConversionPossible, r) {
-    test_conversion_possible(r, "images/color_wheel.webp", false, false);
-    test_conversion_possible(r, "images/mandrill_512_q075.jpg", true, false);
+    test_conversion_possible(r, "images/color_wheel.webp", false, true);
+    test_conversion_possible(r, "images/mandrill_512_q075.jpg", true, true);
     test_conversion_possible(r, "images/yellow_rose.png", false, true);
 }
 
@@ -1282,7 +1312,6 @@ DEF_TEST(Codec_fallBack, r) {
 
     // Formats that currently do not support incremental decoding
     auto files = {
-            "images/CMYK.jpg",
             "images/color_wheel.ico",
             "images/mandrill.wbmp",
             "images/randPixels.bmp",
@@ -1775,3 +1804,189 @@ DEF_TEST(Codec_crbug807324, r) {
         }
     }
 }
+
+// Parallel decodes of jpegs with restart markers must match the serial decode exactly.
+DEF_TEST(Codec_jpeg_restart_markers, r) {
+    SkBitmap src;
+    src.allocN32Pixels(600, 720, true);
+    SkRandom rand;
+    for (int y = 0; y < src.height(); ++y)
+    for (int x = 0; x < src.width(); ++x) {
+        *src.getAddr32(x, y) = SkPreMultiplyARGB(0xFF, (x + y) & 0xFF, (x * y >> 6) & 0xFF,
+                                                 rand.nextU() & 0x3F);
+    }
+
+    auto executor = SkExecutor::MakeFIFOThreadPool(4);
+    auto sRGB = SkColorSpace::MakeSRGB(),
+         p3   = SkColorSpace::MakeRGB(SkNamedTransferFn::kSRGB, SkNamedGamut::kDCIP3);
+
+    for (int restartRows : { 0, 1, 3 }) {
+        SkJpegEncoder::Options encodeOptions;
+        encodeOptions.fRestartRows = restartRows;
+        SkDynamicMemoryWStream stream;
+        REPORTER_ASSERT(r, SkJpegEncoder::Encode(&stream, src.pixmap(), encodeOptions));
+        sk_sp<SkData> data = stream.detachAsData();
+
+        for (SkColorType ct : { kN32_SkColorType, kRGB_565_SkColorType, kRGBA_F16_SkColorType }) {
+            for (const auto& cs : { sRGB, p3 }) {
+                auto codec = SkCodec::MakeFromData(data);
+                const auto info = codec->getInfo().makeColorType(ct).makeColorSpace(cs);
+
+                SkBitmap serial, parallel;
+                serial.allocPixels(info);
+                parallel.allocPixels(info);
+                REPORTER_ASSERT(r, codec->getPixels(serial.pixmap()) == SkCodec::kSuccess);
+
+                SkCodec::Options options;
+                options.fExecutor = executor.get();
+                REPORTER_ASSERT(r, codec->getPixels(info, parallel.getPixels(),
+                                                    parallel.rowBytes(), &options)
+                                   == SkCodec::kSuccess);
+                REPORTER_ASSERT(r, ToolUtils::equal_pixels(serial, parallel),
+                                "restart rows %d, color type %d", restartRows, ct);
+            }
+        }
+
+        // Truncated data falls back to the serial decode and its partial results.
+        auto codec = SkCodec::MakeFromData(SkData::MakeSubset(data.get(), 0, data->size() / 2));
+        SkBitmap bm;
+        bm.allocPixels(codec->getInfo());
+        SkCodec::Options options;
+        options.fExecutor = executor.get();
+        REPORTER_ASSERT(r, codec->getPixels(bm.info(), bm.getPixels(), bm.rowBytes(), &options)
+                           == SkCodec::kIncompleteInput);
+    }
+}
+
+// 8 bit RGB pngs are color transformed straight from the decoded rows.
+DEF_TEST(Codec_png_rgb_xform, r) {
+    auto p3 = SkColorSpace::MakeRGB(SkNamedTransferFn::kSRGB, SkNamedGamut::kDCIP3);
+    SkBitmap src;
+    src.allocPixels(SkImageInfo::MakeN32(67, 45, kOpaque_SkAlphaType, p3));
+    SkRandom rand;
+    for (int y = 0; y < src.height(); ++y)
+    for (int x = 0; x < src.width(); ++x) {
+        *src.getAddr32(x, y) = rand.nextU() | 0xFF000000;
+    }
+    SkDynamicMemoryWStream stream;
+    REPORTER_ASSERT(r, SkPngEncoder::Encode(&stream, src.pixmap(), SkPngEncoder::Options()));
+    sk_sp<SkData> data = stream.detachAsData();
+
+    // What the decoder used to do: expand to RGBA, then transform.
+    auto codec = SkCodec::MakeFromData(data);
+    SkBitmap raw;
+    raw.allocPixels(codec->getInfo().makeColorType(kRGBA_8888_SkColorType));
+    REPORTER_ASSERT(r, codec->getPixels(raw.pixmap()) == SkCodec::kSuccess);
+    skcms_ICCProfile srcProfile, dstProfile;
+    codec->getInfo().colorSpace()->toProfile(&srcProfile);
+    sk_srgb_singleton()->toProfile(&dstProfile);
+    SkBitmap expected;
+    expected.allocPixels(SkImageInfo::Make(src.width(), src.height(), kRGBA_8888_SkColorType,
+                                           kPremul_SkAlphaType));
+    REPORTER_ASSERT(r, skcms_Transform(raw.getPixels(), skcms_PixelFormat_RGBA_8888,
+                                       skcms_AlphaFormat_Unpremul, &srcProfile,
+                                       expected.getPixels(), skcms_PixelFormat_RGBA_8888,
+                                       skcms_AlphaFormat_Unpremul, &dstProfile,
+                                       src.width() * src.height()));
+
+    auto close = [](uint32_t a, uint32_t b) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            if (SkTAbs((int) ((a >> shift) & 0xFF) - (int) ((b >> shift) & 0xFF)) > 1) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    const auto info = codec->getInfo().makeColorType(kRGBA_8888_SkColorType)
+                                      .makeColorSpace(SkColorSpace::MakeSRGB());
+    SkBitmap full;
+    full.allocPixels(info);
+    REPORTER_ASSERT(r, codec->getPixels(full.pixmap()) == SkCodec::kSuccess);
+    for (int y = 0; y < src.height(); ++y)
+    for (int x = 0; x < src.width(); ++x) {
+        if (!close(*full.getAddr32(x, y), *expected.getAddr32(x, y))) {
+            ERRORF(r, "mismatch at (%d, %d): %08x vs %08x", x, y, *full.getAddr32(x, y),
+                   *expected.getAddr32(x, y));
+            return;
+        }
+    }
+
+    // Sampling goes through the swizzler before the transform.
+    auto androidCodec = SkAndroidCodec::MakeFromData(data);
+    SkAndroidCodec::AndroidOptions options;
+    options.fSampleSize = 2;
+    SkBitmap sampled;
+    sampled.allocPixels(info.makeWH(androidCodec->getSampledDimensions(2).width(),
+                                    androidCodec->getSampledDimensions(2).height()));
+    REPORTER_ASSERT(r, androidCodec->getAndroidPixels(sampled.info(), sampled.getPixels(),
+                                                      sampled.rowBytes(), &options)
+                       == SkCodec::kSuccess);
+    for (int y = 0; y < sampled.height(); ++y)
+    for (int x = 0; x < sampled.width(); ++x) {
+        REPORTER_ASSERT(r, *sampled.getAddr32(x, y) == *full.getAddr32(2 * x + 1, 2 * y + 1));
+    }
+}
+
+// Interlaced pngs only keep the rows that survive subsetting and sampling.
+DEF_TEST(Codec_png_interlaced_sampled, r) {
+    SkBitmap src;
+    src.allocPixels(SkImageInfo::Make(61, 53, kRGBA_8888_SkColorType, kUnpremul_SkAlphaType));
+    SkRandom rand;
+    for (int y = 0; y < src.height(); ++y)
+    for (int x = 0; x < src.width(); ++x) {
+        *src.getAddr32(x, y) = rand.nextU();
+    }
+
+    png_structp png = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+    png_infop info = png_create_info_struct(png);
+    if (setjmp(png_jmpbuf(png))) {
+        ERRORF(r, "failed writing png");
+        png_destroy_write_struct(&png, &info);
+        return;
+    }
+    SkDynamicMemoryWStream stream;
+    png_set_write_fn(png, (void*) &stream, codex_test_write_fn, nullptr);
+    png_set_IHDR(png, info, src.width(), src.height(), 8, PNG_COLOR_TYPE_RGB_ALPHA,
+                 PNG_INTERLACE_ADAM7, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+    png_write_info(png, info);
+    std::vector<png_bytep> rows(src.height());
+    for (int y = 0; y < src.height(); ++y) {
+        rows[y] = (png_bytep) src.getAddr(0, y);
+    }
+    png_write_image(png, rows.data());
+    png_write_end(png, info);
+    png_destroy_write_struct(&png, &info);
+    sk_sp<SkData> data = stream.detachAsData();
+
+    const SkIRect subsets[] = { src.bounds(), SkIRect::MakeXYWH(6, 10, 40, 31) };
+    for (const SkIRect& subset : subsets) {
+        for (int sampleSize = 1; sampleSize <= 5; ++sampleSize) {
+            auto codec = SkAndroidCodec::MakeFromData(data);
+            SkIRect sampledSubset = subset;
+            const bool isFull = subset == src.bounds();
+            const SkISize dims = isFull ? codec->getSampledDimensions(sampleSize)
+                                        : codec->getSampledSubsetDimensions(sampleSize, subset);
+            SkBitmap bm;
+            bm.allocPixels(src.info().makeWH(dims.width(), dims.height()));
+
+            SkAndroidCodec::AndroidOptions options;
+            options.fSampleSize = sampleSize;
+            options.fSubset = isFull ? nullptr : &sampledSubset;
+            REPORTER_ASSERT(r, codec->getAndroidPixels(bm.info(), bm.getPixels(), bm.rowBytes(),
+                                                       &options) == SkCodec::kSuccess);
+
+            const int start = get_start_coord(sampleSize);
+            for (int y = 0; y < bm.height(); ++y)
+            for (int x = 0; x < bm.width(); ++x) {
+                const int srcX = subset.left() + start + x * sampleSize,
+                          srcY = subset.top()  + start + y * sampleSize;
+                if (*bm.getAddr32(x, y) != *src.getAddr32(srcX, srcY)) {
+                    ERRORF(r, "sample %d, subset %d: mismatch at (%d, %d)", sampleSize,
+                           !isFull, x, y);
+                    return;
+                }
+            }
+        }
+    }
+}
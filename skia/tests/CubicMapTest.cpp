@@ -10,10 +10,13 @@
 #include "include/core/SkScalar.h"
 #include "include/core/SkTypes.h"
 #include "include/private/SkNx.h"
+#include "include/utils/SkRandom.h"
 #include "src/core/SkGeometry.h"
 #include "src/pathops/SkPathOpsCubic.h"
 #include "tests/Test.h"
 
+#include <vector>
+
 static float accurate_t(float A, float B, float C, float D) {
     double roots[3];
     SkDEBUGCODE(int count =) SkDCubic::RootsValidT(A, B, C, D, roots);
@@ -74,3 +77,32 @@ DEF_TEST(CubicMap, r) {
         }
     }
 }
+
+DEF_TEST(CubicMap_Batch, r) {
+    // Mixed curve types (general, cube root, linear) and x values, including out-of-range and
+    // end points, in a count which is not a multiple of the SIMD width.
+    SkRandom rand;
+    std::vector<SkCubicMap> cmaps;
+    for (int i = 0; i < 1001; ++i) {
+        switch (i % 5) {
+            case 0:  cmaps.emplace_back(SkPoint{0.3f, 0.3f}, SkPoint{0.7f, 0.7f}); break;
+            case 1:  cmaps.emplace_back(SkPoint{0, 0.5f}, SkPoint{0, 1});         break;
+            default: cmaps.emplace_back(SkPoint{rand.nextF(), rand.nextRangeF(-0.5f, 1.5f)},
+                                        SkPoint{rand.nextF(), rand.nextRangeF(-0.5f, 1.5f)});
+        }
+    }
+
+    std::vector<const SkCubicMap*> maps;
+    std::vector<float> xs, ys(cmaps.size());
+    for (size_t i = 0; i < cmaps.size(); ++i) {
+        maps.push_back(&cmaps[i]);
+        xs.push_back(i % 97 == 0 ? 0 : i % 89 == 0 ? 1.5f : rand.nextF());
+    }
+
+    SkCubicMap::ComputeYFromX(maps.data(), xs.data(), ys.data(), SkToInt(maps.size()));
+    for (size_t i = 0; i < cmaps.size(); ++i) {
+        const auto expected = cmaps[i].computeYFromX(xs[i]);
+        REPORTER_ASSERT(r, SkScalarNearlyEqual(ys[i], expected, 0.0001f),
+                        "%zu: %g != %g", i, ys[i], expected);
+    }
+}
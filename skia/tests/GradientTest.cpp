@@ -537,6 +537,56 @@ static void test_sweep_fuzzer(skiatest::Reporter*) {
     }
 }
 
+// Multi-stop gradients drawn into 8-bit destinations look their colors up in a table. Compare
+// them against the same gradients drawn into a float destination, which evaluates the stops.
+static void test_color_lut(skiatest::Reporter* reporter) {
+    const SkColor4f colors[] = {
+        { 0.8f, 0.3f, 0.1f, 1.0f },
+        { 0.6f, 0.5f, 0.3f, 0.8f },
+        { 0.5f, 0.7f, 0.5f, 0.9f },
+        { 0.3f, 0.6f, 0.8f, 0.6f },
+    };
+    const SkScalar pos[] = { 0.05f, 0.35f, 0.65f, 0.95f };
+    const SkScalar hardPos[] = { 0.05f, 0.35f, 0.35f, 0.95f };
+    const SkPoint pts[] = { { 0, 0 }, { 700, 0 } };
+
+    const int kW = 1000, kH = 1;
+    auto n32 = SkSurface::MakeRaster(SkImageInfo::Make(kW, kH, kRGBA_8888_SkColorType,
+                                                       kPremul_SkAlphaType));
+    auto f32 = SkSurface::MakeRaster(SkImageInfo::Make(kW, kH, kRGBA_F32_SkColorType,
+                                                       kPremul_SkAlphaType));
+    SkAutoTMalloc<uint32_t> actual(kW);
+    SkAutoTMalloc<SkPMColor4f> expected(kW);
+
+    for (const SkScalar* p : { pos, hardPos }) {
+        for (uint32_t flags : { 0u, (uint32_t)SkGradientShader::kInterpolateColorsInPremul_Flag }) {
+            for (SkTileMode mode : { SkTileMode::kClamp, SkTileMode::kRepeat,
+                                     SkTileMode::kMirror, SkTileMode::kDecal }) {
+                SkPaint paint;
+                paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, p,
+                                                             SK_ARRAY_COUNT(colors), mode, flags,
+                                                             nullptr));
+                paint.setBlendMode(SkBlendMode::kSrc);
+                n32->getCanvas()->drawPaint(paint);
+                f32->getCanvas()->drawPaint(paint);
+
+                n32->readPixels(n32->imageInfo(), actual.get(), kW * sizeof(uint32_t), 0, 0);
+                f32->readPixels(f32->imageInfo(), expected.get(), kW * sizeof(SkPMColor4f), 0, 0);
+
+                int maxError = 0;
+                for (int x = 0; x < kW; x++) {
+                    uint32_t e = expected[x].toBytes_RGBA();
+                    for (int shift = 0; shift < 32; shift += 8) {
+                        maxError = std::max(maxError, std::abs((int)((actual[x] >> shift) & 0xff) -
+                                                               (int)((e         >> shift) & 0xff)));
+                    }
+                }
+                REPORTER_ASSERT(reporter, maxError <= 1, "max error %d", maxError);
+            }
+        }
+    }
+}
+
 DEF_TEST(Gradient, reporter) {
     TestGradientShaders(reporter);
     TestGradientOptimization(reporter);
@@ -550,4 +600,5 @@ DEF_TEST(Gradient, reporter) {
     test_degenerate_linear(reporter);
     test_linear_fuzzer(reporter);
     test_sweep_fuzzer(reporter);
+    test_color_lut(reporter);
 }
@@ -454,3 +454,34 @@ DEF_TEST(JSON_ParseNumber, reporter) {
         REPORTER_ASSERT(reporter, SkScalarNearlyEqual(**jnumber, test.value, test.tolerance));
     }
 }
+
+DEF_TEST(JSON_DOM_binary, reporter) {
+    static constexpr const char* g_tests[] = {
+        "[]",
+        "{}",
+        "[null,true,false,0,-1,42,1.5,-0.25,1e+10,\"\",\"short\",\"a much longer string\"]",
+        "{\"k1\":null,\"k2\":[{\"kk1\":\"foo\",\"kk2\":[[],{}]},\"boo\"],\"k1\":1}",
+    };
+
+    for (const auto* tst : g_tests) {
+        const DOM dom(tst, strlen(tst));
+        REPORTER_ASSERT(reporter, !dom.root().is<NullValue>());
+
+        SkDynamicMemoryWStream stream;
+        dom.writeBinary(&stream);
+        const auto data = stream.detachAsData();
+        REPORTER_ASSERT(reporter,  DOM::IsBinary(data->data(), data->size()));
+        REPORTER_ASSERT(reporter, !DOM::IsBinary(tst, strlen(tst)));
+
+        const auto bdom = DOM::MakeFromBinary(data->data(), data->size());
+        REPORTER_ASSERT(reporter, bdom);
+        if (!bdom) continue;
+
+        REPORTER_ASSERT(reporter, dom.root().toString().equals(bdom->root().toString()));
+
+        // Truncated input must be rejected.
+        for (size_t size = 0; size < data->size(); ++size) {
+            REPORTER_ASSERT(reporter, !DOM::MakeFromBinary(data->data(), size));
+        }
+    }
+}
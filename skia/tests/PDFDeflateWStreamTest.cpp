@@ -9,6 +9,7 @@
 
 #ifdef SK_SUPPORT_PDF
 
+#include "include/core/SkExecutor.h"
 #include "include/private/SkTo.h"
 #include "include/utils/SkRandom.h"
 #include "src/pdf/SkDeflate.h"
@@ -167,4 +168,51 @@ DEF_TEST(SkPDF_DeflateWStream, r) {
     REPORTER_ASSERT(r, !emptyDeflateWStream.writeText("FOO"));
 }
 
+DEF_TEST(SkPDF_DeflateWStream_executor, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkRandom random(654321);
+    // Sizes around and well above the parallel chunk size (128K).
+    const uint32_t sizes[] = { 1000, 131072, 131073, 400000, 3000000 };
+    for (uint32_t size : sizes) {
+        // Page-content-like text interleaved with noise, so matches cross chunk boundaries.
+        static const char kText[] = "0 0 1 rg 10 20 m 30 40 l S BT (Hello) Tj ET\n";
+        SkAutoTMalloc<uint8_t> buffer(size);
+        for (uint32_t j = 0; j < size; ++j) {
+            buffer[j] = (j % 5000) < 4000 ? kText[j % (sizeof(kText) - 1)]
+                                          : random.nextU() & 0xff;
+        }
+
+        SkDynamicMemoryWStream serialWStream, parallelWStream;
+        {
+            SkDeflateWStream deflateWStream(&serialWStream);
+            deflateWStream.write(buffer.get(), size);
+        }
+        {
+            SkDeflateWStream deflateWStream(&parallelWStream, -1, false, executor.get());
+            uint32_t j = 0;
+            while (j < size) {
+                uint32_t writeSize = SkTMin(size - j, random.nextRangeU(1, 70000));
+                REPORTER_ASSERT(r, deflateWStream.write(&buffer[j], writeSize));
+                j += writeSize;
+            }
+            REPORTER_ASSERT(r, deflateWStream.bytesWritten() == size);
+        }
+        if (size < 131072) {
+            // Inputs smaller than a chunk are compressed exactly as without an executor.
+            REPORTER_ASSERT(r, serialWStream.bytesWritten() == parallelWStream.bytesWritten());
+        }
+
+        std::unique_ptr<SkStreamAsset> compressed(parallelWStream.detachAsStream());
+        std::unique_ptr<SkStreamAsset> decompressed(stream_inflate(r, compressed.get()));
+        if (!decompressed) {
+            ERRORF(r, "Decompression failed [%u].", (unsigned)size);
+            continue;
+        }
+        sk_sp<SkData> data = SkData::MakeFromStream(decompressed.get(),
+                                                    decompressed->getLength());
+        REPORTER_ASSERT(r, data->size() == size && 0 == memcmp(data->data(), buffer.get(), size),
+                        "size %u", (unsigned)size);
+    }
+}
+
 #endif
@@ -257,3 +257,46 @@ DEF_TEST(SkPDF_abort_jobs, rep) {
     doc->abort();
 }
 
+
+// Pages converted on an executor should produce the same objects as serial conversion.
+DEF_TEST(SkPDF_multiple_pages_executor, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_multiple_pages_executor, r);
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(64, 64);
+    bitmap.eraseColor(0xFF4F9643);
+
+    auto makePDF = [&](SkExecutor* executor) {
+        SkPDF::Metadata metadata;
+        metadata.fExecutor = executor;
+        SkDynamicMemoryWStream wStream;
+        {
+            auto doc = SkPDF::MakeDocument(&wStream, metadata);
+            for (int i = 0; i < 20; ++i) {
+                SkCanvas* canvas = doc->beginPage(612, 792);
+                canvas->drawColor(SkColorSetARGB(0xFF, 0x00, (uint8_t)(12 * i), 0x00));
+                canvas->drawBitmap(bitmap, i, i);
+                doc->endPage();
+            }
+        }
+        return wStream.detachAsData();
+    };
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool();
+    sk_sp<SkData> serial = makePDF(nullptr);
+    sk_sp<SkData> threaded = makePDF(executor.get());
+    REPORTER_ASSERT(r, contains(threaded->bytes(), threaded->size(), "/Count 20"));
+
+    // Object numbering does not depend on thread timing: same object count and root objects.
+    auto trailer = [](const SkData& data) {
+        const char* bytes = static_cast<const char*>(data.data());
+        for (size_t i = data.size() - 7; i-- > 0;) {
+            if (0 == strncmp(bytes + i, "trailer", 7)) {
+                return SkString(bytes + i, data.size() - i);
+            }
+        }
+        return SkString();
+    };
+    SkString serialTrailer = trailer(*serial);
+    REPORTER_ASSERT(r, !serialTrailer.isEmpty());
+    REPORTER_ASSERT(r, serialTrailer.equals(trailer(*threaded)));
+}
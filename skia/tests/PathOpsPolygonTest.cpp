@@ -0,0 +1,125 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "include/core/SkRRect.h"
+#include "include/utils/SkRandom.h"
+#include "src/pathops/SkPathOpsCommon.h"
+#include "src/pathops/SkPathOpsPolygon.h"
+#include "tests/PathOpsExtendedTest.h"
+
+// Checks the polygon path against the general engine (OpDebug never takes the polygon path).
+static void testPolygonParity(skiatest::Reporter* reporter, const SkPath& one, const SkPath& two,
+                              SkPathOp op, const char* testName) {
+    SkPath expected, result;
+    if (!OpDebug(one, two, op, &expected  SkDEBUGPARAMS(true) SkDEBUGPARAMS(testName))) {
+        return;
+    }
+    REPORTER_ASSERT(reporter, PolygonOp(one, two, op, &result), "%s", testName);
+    REPORTER_ASSERT(reporter, result.getFillType() == expected.getFillType(), "%s", testName);
+    int pixelDiff = comparePaths(reporter, testName, expected, result);
+    REPORTER_ASSERT(reporter, pixelDiff == 0, "%s", testName);
+}
+
+// Rounded rects, flattened the way clip/mask code sees them.
+static SkPath flattened_rrect(const SkRect& rect, SkScalar radius) {
+    SkPath rrect;
+    rrect.addRRect(SkRRect::MakeRectXY(rect, radius, radius));
+    SkPath path;
+    SkPath::Iter iter(rrect, true);
+    SkPoint pts[4];
+    SkPath::Verb verb;
+    while ((verb = iter.next(pts)) != SkPath::kDone_Verb) {
+        switch (verb) {
+            case SkPath::kMove_Verb:
+                path.moveTo(pts[0]);
+                break;
+            case SkPath::kLine_Verb:
+                path.lineTo(pts[1]);
+                break;
+            case SkPath::kClose_Verb:
+                path.close();
+                break;
+            default: {
+                SkPoint quad[3] = { pts[0], pts[1], pts[2] };
+                for (int i = 1; i <= 8; ++i) {
+                    const SkScalar t = i / 8.f, mt = 1 - t;
+                    path.lineTo(quad[0] * (mt * mt) + quad[1] * (2 * t * mt) + quad[2] * (t * t));
+                }
+            } break;
+        }
+    }
+    return path;
+}
+
+static SkPath random_polygon(SkRandom* rand, bool onGrid) {
+    SkPath path;
+    path.setFillType((SkPath::FillType) rand->nextULessThan(4));
+    const int contours = 1 + rand->nextULessThan(2);
+    for (int c = 0; c < contours; ++c) {
+        const int count = 3 + rand->nextULessThan(5);
+        for (int i = 0; i < count; ++i) {
+            // A coarse grid produces many shared vertices and coincident edges.
+            SkPoint pt = onGrid ? SkPoint::Make(rand->nextULessThan(6), rand->nextULessThan(6))
+                                : SkPoint::Make(rand->nextRangeF(0, 6), rand->nextRangeF(0, 6));
+            if (i == 0) {
+                path.moveTo(pt);
+            } else {
+                path.lineTo(pt);
+            }
+        }
+        path.close();
+    }
+    return path;
+}
+
+DEF_TEST(PathOpsPolygon, reporter) {
+    SkPath rect1, rect2;
+    rect1.addRect(0, 0, 6, 6);
+    rect2.addRect(3, 3, 9, 9, SkPath::kCCW_Direction);
+    const SkPath rrect1 = flattened_rrect({0, 0, 8, 6}, 2);
+    const SkPath rrect2 = flattened_rrect({4, 3, 12, 9}, 3);
+    SkPath triangle;
+    triangle.moveTo(1, 1);
+    triangle.lineTo(11, 2);
+    triangle.lineTo(5, 8);
+    triangle.close();
+
+    const SkPath* paths[] = { &rect1, &rect2, &rrect1, &rrect2, &triangle };
+    int testCount = 0;
+    for (const SkPath* one : paths) {
+        for (const SkPath* two : paths) {
+            for (int op = kDifference_SkPathOp; op <= kReverseDifference_SkPathOp; ++op) {
+                for (int fill = SkPath::kWinding_FillType;
+                        fill <= SkPath::kInverseEvenOdd_FillType; ++fill) {
+                    SkPath inverse(*two);
+                    inverse.setFillType((SkPath::FillType) fill);
+                    SkString testName;
+                    testName.printf("polygonTest%d", ++testCount);
+                    testPolygonParity(reporter, *one, inverse, (SkPathOp) op, testName.c_str());
+                }
+            }
+        }
+    }
+
+    // Curves always take the general path.
+    SkPath oval, result;
+    oval.addOval({0, 0, 6, 6});
+    REPORTER_ASSERT(reporter, !PolygonOp(rect1, oval, kIntersect_SkPathOp, &result));
+    REPORTER_ASSERT(reporter, Op(rect1, oval, kIntersect_SkPathOp, &result));
+}
+
+DEF_TEST(PathOpsPolygonFuzz, reporter) {
+    SkRandom rand;
+    const int testCount = reporter->allowExtendedTest() ? 20000 : 500;
+    for (int i = 0; i < testCount; ++i) {
+        const bool onGrid = rand.nextBool();
+        SkPath one = random_polygon(&rand, onGrid);
+        SkPath two = random_polygon(&rand, onGrid);
+        SkString testName;
+        testName.printf("polygonFuzz%d", i);
+        testPolygonParity(reporter, one, two, (SkPathOp) rand.nextULessThan(5), testName.c_str());
+    }
+}
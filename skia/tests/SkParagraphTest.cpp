@@ -3829,3 +3829,150 @@ DEF_TEST(SkParagraph_CacheStyles, reporter) {
     text_style.setWordSpacing(10);
     test(2, false);
 }
+
+DEF_TEST(SkParagraph_CacheRuns, reporter) {
+    sk_sp<TestFontCollection> fontCollection = sk_make_sp<TestFontCollection>();
+    if (!fontCollection->fontsFound()) return;
+    auto runCache = fontCollection->getParagraphCache()->getRunCache();
+
+    ParagraphStyle paragraph_style;
+    paragraph_style.turnHintingOff();
+
+    TextStyle text_style;
+    text_style.setFontFamilies({SkString("Roboto")});
+    text_style.setFontSize(20);
+    text_style.setColor(SK_ColorBLACK);
+
+    auto layout = [&](size_t maxLines) {
+        paragraph_style.setMaxLines(maxLines);
+        ParagraphBuilderImpl builder(paragraph_style, fontCollection);
+        builder.pushStyle(text_style);
+        builder.addText("Shaped run cache");
+        builder.pop();
+        auto paragraph = builder.Build();
+        paragraph->layout(TestCanvasWidth);
+        return paragraph;
+    };
+
+    // Words and the spaces between them are cached separately
+    REPORTER_ASSERT(reporter, runCache->count() == 0);
+    auto paragraph1 = layout(1);
+    REPORTER_ASSERT(reporter, runCache->count() == 5);
+
+    // A different paragraph style misses the paragraph cache, but reuses the shaped words
+    auto paragraph2 = layout(2);
+    REPORTER_ASSERT(reporter, runCache->count() == 5);
+
+    auto impl1 = static_cast<ParagraphImpl*>(paragraph1.get());
+    auto impl2 = static_cast<ParagraphImpl*>(paragraph2.get());
+    REPORTER_ASSERT(reporter, impl1->runs().size() == 1);
+    REPORTER_ASSERT(reporter, impl2->runs().size() == 1);
+
+    auto& run1 = impl1->runs()[0];
+    auto& run2 = impl2->runs()[0];
+    REPORTER_ASSERT(reporter, run1.size() == run2.size());
+    for (size_t i = 0; i < run1.size(); ++i) {
+        REPORTER_ASSERT(reporter, run1.glyphs()[i] == run2.glyphs()[i]);
+        REPORTER_ASSERT(reporter, run1.positions()[i] == run2.positions()[i]);
+        REPORTER_ASSERT(reporter, run1.clusterIndexes()[i] == run2.clusterIndexes()[i]);
+    }
+    REPORTER_ASSERT(reporter, impl1->getMaxIntrinsicWidth() == impl2->getMaxIntrinsicWidth());
+}
+
+DEF_TEST(SkParagraph_CacheRunsContext, reporter) {
+    sk_sp<TestFontCollection> fontCollection = sk_make_sp<TestFontCollection>();
+    if (!fontCollection->fontsFound()) return;
+    auto runCache = fontCollection->getParagraphCache()->getRunCache();
+
+    ParagraphStyle paragraph_style;
+    paragraph_style.turnHintingOff();
+
+    TextStyle text_style;
+    text_style.setFontFamilies({SkString("Roboto")});
+    text_style.setFontSize(20);
+    text_style.setColor(SK_ColorBLACK);
+    TextStyle large_style = text_style;
+    large_style.setFontSize(30);
+
+    auto layout = [&](const char* prefix) {
+        ParagraphBuilderImpl builder(paragraph_style, fontCollection);
+        builder.pushStyle(text_style);
+        builder.addText(prefix);
+        builder.pushStyle(large_style);
+        builder.addText("run");
+        builder.pop();
+        builder.pop();
+        auto paragraph = builder.Build();
+        paragraph->layout(TestCanvasWidth);
+        return paragraph;
+    };
+
+    // The same word after different text is shaped (and cached) separately: "Shaped", " " and
+    // "run", then "Other", " " and "run"
+    auto paragraph1 = layout("Shaped ");
+    REPORTER_ASSERT(reporter, runCache->count() == 3);
+    auto paragraph2 = layout("Other ");
+    REPORTER_ASSERT(reporter, runCache->count() == 6);
+
+    // ...and reused when the context is the same: "run" follows "ther " in both
+    auto paragraph3 = layout("Another ");
+    REPORTER_ASSERT(reporter, runCache->count() == 8);
+    paragraph_style.setMaxLines(2);  // Misses the paragraph cache
+    auto paragraph4 = layout("Other ");
+    REPORTER_ASSERT(reporter, runCache->count() == 8);
+
+    auto impl2 = static_cast<ParagraphImpl*>(paragraph2.get());
+    auto impl4 = static_cast<ParagraphImpl*>(paragraph4.get());
+    REPORTER_ASSERT(reporter, impl2->runs().size() == 2);
+    REPORTER_ASSERT(reporter, impl4->runs().size() == 2);
+    REPORTER_ASSERT(reporter, impl2->runs()[1].textRange() == impl4->runs()[1].textRange());
+}
+
+DEF_TEST(SkParagraph_CacheRunsWhileEditing, reporter) {
+    sk_sp<TestFontCollection> fontCollection = sk_make_sp<TestFontCollection>();
+    if (!fontCollection->fontsFound()) return;
+    auto runCache = fontCollection->getParagraphCache()->getRunCache();
+
+    ParagraphStyle paragraph_style;
+    paragraph_style.turnHintingOff();
+
+    TextStyle text_style;
+    text_style.setFontFamilies({SkString("Roboto")});
+    text_style.setFontSize(20);
+    text_style.setColor(SK_ColorBLACK);
+
+    auto layout = [&](const char* text) {
+        ParagraphBuilderImpl builder(paragraph_style, fontCollection);
+        builder.pushStyle(text_style);
+        builder.addText(text);
+        builder.pop();
+        auto paragraph = builder.Build();
+        paragraph->layout(TestCanvasWidth);
+        return paragraph;
+    };
+
+    // 7 words and 6 spaces
+    auto paragraph1 = layout("Editing one word reshapes only that word");
+    REPORTER_ASSERT(reporter, runCache->count() == 13);
+
+    // Only the edited word and what has it as context is shaped again:
+    // "Editing", " ", "two", " " and "word"
+    auto paragraph2 = layout("Editing two word reshapes only that word");
+    REPORTER_ASSERT(reporter, runCache->count() == 18);
+
+    auto impl1 = static_cast<ParagraphImpl*>(paragraph1.get());
+    auto impl2 = static_cast<ParagraphImpl*>(paragraph2.get());
+    REPORTER_ASSERT(reporter, impl1->runs().size() == 1);
+    REPORTER_ASSERT(reporter, impl2->runs().size() == 1);
+
+    // The words are put back together into one run
+    auto& run1 = impl1->runs()[0];
+    auto& run2 = impl2->runs()[0];
+    REPORTER_ASSERT(reporter, run1.size() == run2.size());
+    for (size_t i = 0; i < run1.size(); ++i) {
+        REPORTER_ASSERT(reporter, run1.clusterIndexes()[i] == run2.clusterIndexes()[i]);
+        if (run1.clusterIndexes()[i] < 8 || run1.clusterIndexes()[i] >= 11) {
+            REPORTER_ASSERT(reporter, run1.glyphs()[i] == run2.glyphs()[i]);
+        }
+    }
+}
@@ -0,0 +1,198 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/* PNG unfiltering with SSE2 (plus SSSE3 and SSE4.1 when the build targets them), installed
+ * into libpng through PNG_FILTER_OPTIMIZATIONS.
+ *
+ * This follows ../externals/libpng/intel/filter_sse2_intrinsics.c, which only covers 3 and 4
+ * byte pixels, and extends it to every multibyte pixel size libpng produces: 2 (gray + alpha),
+ * 3 (RGB), 4 (RGBA, 16-bit gray + alpha), 6 (16-bit RGB) and 8 (16-bit RGBA) bytes.
+ *
+ * Sub, Avg and Paeth predict each pixel from the already reconstructed pixel to its left, so
+ * they are inherently serial across a row and we work on one pixel per step.  Wider vectors
+ * (AVX2) would not help.  Up has no such dependency and libpng's generic loop autovectorizes,
+ * so we leave it alone, as do 1 byte pixels, which gain nothing from SIMD.
+ */
+
+#include "pngpriv.h"
+
+#ifdef PNG_READ_SUPPORTED
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+
+#include <immintrin.h>
+#include <string.h>
+
+/* All pixels fit in the low 8 bytes of a register.  When at least 8 bytes are left in the
+ * row we load them all; the bytes past the pixel only feed lanes that are never stored.
+ * These compile to plain moves once inlined with a constant bpp.
+ */
+static inline __m128i load_pixel(const void* p, size_t bpp, size_t rb) {
+   png_byte tmp[8] = {0};
+   if (rb >= 8) {
+      return _mm_loadl_epi64((const __m128i*)p);
+   }
+   memcpy(tmp, p, bpp);
+   return _mm_loadl_epi64((const __m128i*)tmp);
+}
+
+static inline void store_pixel(void* p, __m128i v, size_t bpp) {
+   png_byte tmp[8];
+   if (bpp == 8) {
+      _mm_storel_epi64((__m128i*)p, v);
+      return;
+   }
+   if (bpp == 4) {
+      int tmp4 = _mm_cvtsi128_si32(v);
+      memcpy(p, &tmp4, 4);
+      return;
+   }
+   _mm_storel_epi64((__m128i*)tmp, v);
+   memcpy(p, tmp, bpp);
+}
+
+static inline __m128i abs_i16(__m128i x) {
+#if defined(__SSSE3__)
+   return _mm_abs_epi16(x);
+#else
+   /* x < 0 ? -x : x, as two's complement negation of the negative lanes. */
+   __m128i is_negative = _mm_cmplt_epi16(x, _mm_setzero_si128());
+   x = _mm_xor_si128(x, is_negative);
+   return _mm_sub_epi16(x, is_negative);
+#endif
+}
+
+static inline __m128i if_then_else(__m128i c, __m128i t, __m128i e) {
+#if defined(__SSE4_1__)
+   return _mm_blendv_epi8(e, t, c);
+#else
+   return _mm_or_si128(_mm_and_si128(c, t), _mm_andnot_si128(c, e));
+#endif
+}
+
+/* Row sizes are always a multiple of the pixel size for multibyte pixels. */
+
+static inline void filter_row_sub(png_row_infop row_info, png_bytep row, size_t bpp) {
+   /* There is no pixel left of the first one; treating it as zero works with the loop. */
+   __m128i a = _mm_setzero_si128();
+   size_t rb = row_info->rowbytes;
+   while (rb >= bpp) {
+      __m128i d = _mm_add_epi8(a, load_pixel(row, bpp, rb));
+      store_pixel(row, d, bpp);
+      a = d;
+      row += bpp;
+      rb  -= bpp;
+   }
+}
+
+static inline void filter_row_avg(png_row_infop row_info, png_bytep row,
+                                  png_const_bytep prev, size_t bpp) {
+   /* d += floor((a + b) / 2).  _mm_avg_epu8 rounds up, so take away the rounding bit. */
+   const __m128i one = _mm_set1_epi8(1);
+   __m128i a = _mm_setzero_si128();
+   size_t rb = row_info->rowbytes;
+   while (rb >= bpp) {
+      __m128i b   = load_pixel(prev, bpp, rb),
+              d   = load_pixel(row,  bpp, rb),
+              avg = _mm_avg_epu8(a, b);
+      avg = _mm_sub_epi8(avg, _mm_and_si128(_mm_xor_si128(a, b), one));
+      d = _mm_add_epi8(d, avg);
+      store_pixel(row, d, bpp);
+      a = d;
+      prev += bpp;
+      row  += bpp;
+      rb   -= bpp;
+   }
+}
+
+static inline void filter_row_paeth(png_row_infop row_info, png_bytep row,
+                                    png_const_bytep prev, size_t bpp) {
+   /* Paeth predicts d as whichever of a (left), b (above) or c (above left) is nearest to
+    * p = a + b - c, breaking ties in favor of a, then b.  The first pixel has no left
+    * context, and the loop handles that by starting with zero a and c.
+    * Everything is done with 16-bit intermediates, which 8 bytes of pixel fill exactly.
+    */
+   const __m128i zero = _mm_setzero_si128();
+   __m128i c, b = zero,
+           a, d = zero;
+   size_t rb = row_info->rowbytes;
+   while (rb >= bpp) {
+      __m128i pa, pb, pc, smallest, nearest;
+      c = b; b = _mm_unpacklo_epi8(load_pixel(prev, bpp, rb), zero);
+      a = d; d = _mm_unpacklo_epi8(load_pixel(row,  bpp, rb), zero);
+
+      pa = _mm_sub_epi16(b, c);   /* p - a == b - c          */
+      pb = _mm_sub_epi16(a, c);   /* p - b == a - c          */
+      pc = _mm_add_epi16(pa, pb); /* p - c == (b-c) + (a-c)  */
+
+      pa = abs_i16(pa);
+      pb = abs_i16(pb);
+      pc = abs_i16(pc);
+
+      smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+      nearest  = if_then_else(_mm_cmpeq_epi16(smallest, pa), a,
+                 if_then_else(_mm_cmpeq_epi16(smallest, pb), b,
+                                                             c));
+
+      /* Byte addition wraps modulo 256 and leaves the (zero) high bytes alone. */
+      d = _mm_add_epi8(d, nearest);
+      store_pixel(row, _mm_packus_epi16(d, d), bpp);
+
+      prev += bpp;
+      row  += bpp;
+      rb   -= bpp;
+   }
+}
+
+#define PNG_SSE_FILTERS(bpp)                                                              \
+   static void filter_row_sub##bpp(png_row_infop row_info, png_bytep row,                \
+                                   png_const_bytep prev) {                                \
+      (void)prev;                                                                         \
+      filter_row_sub(row_info, row, bpp);                                                 \
+   }                                                                                      \
+   static void filter_row_avg##bpp(png_row_infop row_info, png_bytep row,                \
+                                   png_const_bytep prev) {                                \
+      filter_row_avg(row_info, row, prev, bpp);                                           \
+   }                                                                                      \
+   static void filter_row_paeth##bpp(png_row_infop row_info, png_bytep row,              \
+                                     png_const_bytep prev) {                              \
+      filter_row_paeth(row_info, row, prev, bpp);                                         \
+   }
+
+PNG_SSE_FILTERS(2)
+PNG_SSE_FILTERS(3)
+PNG_SSE_FILTERS(4)
+PNG_SSE_FILTERS(6)
+PNG_SSE_FILTERS(8)
+
+#define PNG_SSE_INSTALL_FILTERS(pp, bpp)                                                  \
+   pp->read_filter[PNG_FILTER_VALUE_SUB   - 1] = filter_row_sub##bpp;                     \
+   pp->read_filter[PNG_FILTER_VALUE_AVG   - 1] = filter_row_avg##bpp;                     \
+   pp->read_filter[PNG_FILTER_VALUE_PAETH - 1] = filter_row_paeth##bpp
+
+void png_init_filter_functions_sse(png_structp pp, unsigned int bpp) {
+   switch (bpp) {
+      case 2: PNG_SSE_INSTALL_FILTERS(pp, 2); break;
+      case 3: PNG_SSE_INSTALL_FILTERS(pp, 3); break;
+      case 4: PNG_SSE_INSTALL_FILTERS(pp, 4); break;
+      case 6: PNG_SSE_INSTALL_FILTERS(pp, 6); break;
+      case 8: PNG_SSE_INSTALL_FILTERS(pp, 8); break;
+      default: break;
+   }
+}
+
+#else
+
+/* Without SSE2, keep libpng's generic filters. */
+void png_init_filter_functions_sse(png_structp pp, unsigned int bpp) {
+   (void)pp;
+   (void)bpp;
+}
+
+#endif
+#endif /* PNG_READ_SUPPORTED */